@@ -346,9 +346,7 @@ AdaptiveURISelector::getServerStats(const std::string& uri) const
 {
   uri_split_result us;
   if (uri_split(&us, uri.c_str()) == 0) {
-    std::string host = uri::getFieldString(us, USR_HOST, uri.c_str());
-    std::string protocol = uri::getFieldString(us, USR_SCHEME, uri.c_str());
-    return serverStatMan_->find(host, protocol);
+    return serverStatMan_->find(uri.c_str(), us);
   }
   else {
     return nullptr;
@@ -79,9 +79,9 @@ void BtBitfieldMessage::doReceivedAction()
   if (isMetadataGetMode()) {
     return;
   }
-  getPieceStorage()->updatePieceStats(bitfield_.data(), bitfield_.size(),
-                                      getPeer()->getBitfield());
+  getPieceStorage()->subtractPieceStats(getPeer()->getPeerBitfield());
   getPeer()->setBitfield(bitfield_.data(), bitfield_.size());
+  getPieceStorage()->addPieceStats(getPeer()->getPeerBitfield());
   if (getPeer()->isSeeder() && getPieceStorage()->downloadFinished()) {
     throw DL_ABORT_EX(MSG_GOOD_BYE_SEEDER);
   }
@@ -36,6 +36,7 @@
 #define D_BT_CANCEL_MESSAGE_H
 
 #include "RangeBtMessage.h"
+#include "FreeList.h"
 
 namespace aria2 {
 
@@ -47,6 +48,16 @@ public:
 
   static const char NAME[];
 
+  static void* operator new(size_t size)
+  {
+    return FreeList<BtCancelMessage>::allocate(size);
+  }
+
+  static void operator delete(void* p, size_t size)
+  {
+    FreeList<BtCancelMessage>::deallocate(p, size);
+  }
+
   static std::unique_ptr<BtCancelMessage> create(const unsigned char* data,
                                                  size_t dataLength);
 
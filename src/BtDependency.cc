@@ -62,24 +62,29 @@ BtDependency::BtDependency(RequestGroup* dependant,
 BtDependency::~BtDependency() = default;
 
 namespace {
-void copyValues(const std::shared_ptr<FileEntry>& d,
-                const std::shared_ptr<FileEntry>& s)
+void copyValues(const std::shared_ptr<FileEntry>& d, const FileEntry& s)
 {
   d->setRequested(true);
-  d->setPath(s->getPath());
-  d->addUris(std::begin(s->getRemainingUris()),
-             std::end(s->getRemainingUris()));
-  d->setMaxConnectionPerServer(s->getMaxConnectionPerServer());
-  d->setUniqueProtocol(s->isUniqueProtocol());
+  d->setPath(s.getPath());
+  d->addUris(std::begin(s.getRemainingUris()), std::end(s.getRemainingUris()));
+  d->setMaxConnectionPerServer(s.getMaxConnectionPerServer());
+  d->setUniqueProtocol(s.isUniqueProtocol());
 }
 } // namespace
 
 namespace {
+// FileEntry::getOriginalName() returns a new string, so the names are
+// taken once and stored alongside the entries.
+typedef std::pair<std::string, std::shared_ptr<FileEntry>> NamedEntry;
+
 struct EntryCmp {
-  bool operator()(const std::shared_ptr<FileEntry>& lhs,
-                  const std::shared_ptr<FileEntry>& rhs) const
+  bool operator()(const NamedEntry& lhs, const std::string& rhs) const
+  {
+    return lhs.first < rhs;
+  }
+  bool operator()(const NamedEntry& lhs, const NamedEntry& rhs) const
   {
-    return lhs->getOriginalName() < rhs->getOriginalName();
+    return lhs.first < rhs.first;
   }
 };
 } // namespace
@@ -117,6 +122,9 @@ bool BtDependency::resolve()
       const std::vector<std::shared_ptr<FileEntry>>& fileEntries =
           context->getFileEntries();
       for (auto& fe : fileEntries) {
+        if (fe->emptyRequestUri()) {
+          continue;
+        }
         auto& uri = fe->getRemainingUris();
         std::shuffle(std::begin(uri), std::end(uri),
                      *SimpleRandomizer::getInstance());
@@ -129,29 +137,28 @@ bool BtDependency::resolve()
       if (fileEntries.size() == 1 && dependantFileEntries.size() == 1 &&
           dependantFileEntries[0]->getOriginalName().empty()) {
         // TODO this may be dead code
-        copyValues(fileEntries[0], dependantFileEntries[0]);
+        copyValues(fileEntries[0], *dependantFileEntries[0]);
       }
       else {
-        std::vector<std::shared_ptr<FileEntry>> destFiles;
+        std::vector<NamedEntry> destFiles;
         destFiles.reserve(fileEntries.size());
         for (auto& e : fileEntries) {
           e->setRequested(false);
-          destFiles.push_back(e);
+          destFiles.emplace_back(e->getOriginalName(), e);
         }
         std::sort(std::begin(destFiles), std::end(destFiles), EntryCmp());
         // Copy file path in dependant_'s FileEntries to newly created
         // context's FileEntries to endorse the path structure of
         // dependant_.  URIs and singleHostMultiConnection are also copied.
         for (const auto& e : dependantFileEntries) {
-          const auto d = std::lower_bound(std::begin(destFiles),
-                                          std::end(destFiles), e, EntryCmp());
-          if (d == std::end(destFiles) ||
-              (*d)->getOriginalName() != e->getOriginalName()) {
-            throw DL_ABORT_EX(fmt("No entry %s in torrent file",
-                                  e->getOriginalName().c_str()));
+          const auto name = e->getOriginalName();
+          const auto d = std::lower_bound(
+              std::begin(destFiles), std::end(destFiles), name, EntryCmp());
+          if (d == std::end(destFiles) || (*d).first != name) {
+            throw DL_ABORT_EX(fmt("No entry %s in torrent file", name.c_str()));
           }
           else {
-            copyValues(*d, e);
+            copyValues((*d).second, *e);
           }
         }
       }
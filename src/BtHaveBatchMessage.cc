@@ -0,0 +1,76 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "BtHaveBatchMessage.h"
+#include "bittorrent_helper.h"
+#include "fmt.h"
+
+namespace aria2 {
+
+const char BtHaveBatchMessage::NAME[] = "have";
+
+namespace {
+const size_t HAVE_MESSAGE_LENGTH = 9;
+} // namespace
+
+BtHaveBatchMessage::BtHaveBatchMessage(std::vector<size_t> indexes)
+    : SimpleBtMessage(ID, NAME), indexes_(std::move(indexes))
+{
+}
+
+std::vector<unsigned char> BtHaveBatchMessage::createMessage()
+{
+  /**
+   * Each have message is:
+   * len --- 5, 4bytes
+   * id --- 4, 1byte
+   * piece index --- index, 4bytes
+   * total: 9bytes
+   */
+  auto msg = std::vector<unsigned char>(HAVE_MESSAGE_LENGTH * indexes_.size());
+  auto p = msg.data();
+  for (auto index : indexes_) {
+    bittorrent::createPeerMessageString(p, HAVE_MESSAGE_LENGTH, 5, ID);
+    bittorrent::setIntParam(p + 5, index);
+    p += HAVE_MESSAGE_LENGTH;
+  }
+  return msg;
+}
+
+std::string BtHaveBatchMessage::toString() const
+{
+  return fmt("%s count=%lu", NAME, static_cast<unsigned long>(indexes_.size()));
+}
+
+} // namespace aria2
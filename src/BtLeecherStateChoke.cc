@@ -42,17 +42,20 @@
 #include "SimpleRandomizer.h"
 #include "wallclock.h"
 #include "fmt.h"
+#include "UploadSlotTuner.h"
 
 namespace aria2 {
 
 BtLeecherStateChoke::BtLeecherStateChoke()
-    : round_(0), lastRound_(Timer::zero())
+    : round_(0),
+      lastRound_(Timer::zero()),
+      numSlots_(UploadSlotTuner::DEFAULT_NUM_SLOTS)
 {
 }
 
 BtLeecherStateChoke::~BtLeecherStateChoke() = default;
 
-BtLeecherStateChoke::PeerEntry::PeerEntry(const std::shared_ptr<Peer>& peer)
+BtLeecherStateChoke::PeerEntry::PeerEntry(Peer* peer)
     : peer_(peer),
       downloadSpeed_(peer->calculateDownloadSpeed()),
       // peer must be interested to us and sent block in the last 30 seconds
@@ -62,74 +65,11 @@ BtLeecherStateChoke::PeerEntry::PeerEntry(const std::shared_ptr<Peer>& peer)
 {
 }
 
-BtLeecherStateChoke::PeerEntry::PeerEntry(const PeerEntry& c) = default;
-
-void BtLeecherStateChoke::PeerEntry::swap(PeerEntry& c)
-{
-  using std::swap;
-  swap(peer_, c.peer_);
-  swap(downloadSpeed_, c.downloadSpeed_);
-  swap(regularUnchoker_, c.regularUnchoker_);
-}
-
-BtLeecherStateChoke::PeerEntry& BtLeecherStateChoke::PeerEntry::
-operator=(const PeerEntry& c)
-{
-  if (this != &c) {
-    peer_ = c.peer_;
-    downloadSpeed_ = c.downloadSpeed_;
-    regularUnchoker_ = c.regularUnchoker_;
-  }
-  return *this;
-}
-
-BtLeecherStateChoke::PeerEntry::~PeerEntry() = default;
-
-const std::shared_ptr<Peer>& BtLeecherStateChoke::PeerEntry::getPeer() const
-{
-  return peer_;
-}
-
-int BtLeecherStateChoke::PeerEntry::getDownloadSpeed() const
-{
-  return downloadSpeed_;
-}
-
-bool BtLeecherStateChoke::PeerEntry::isRegularUnchoker() const
-{
-  return regularUnchoker_;
-}
-
-void BtLeecherStateChoke::PeerEntry::enableChokingRequired()
-{
-  peer_->chokingRequired(true);
-}
-
-void BtLeecherStateChoke::PeerEntry::disableChokingRequired()
-{
-  peer_->chokingRequired(false);
-}
-
-void BtLeecherStateChoke::PeerEntry::enableOptUnchoking()
-{
-  peer_->optUnchoking(true);
-}
-
-void BtLeecherStateChoke::PeerEntry::disableOptUnchoking()
-{
-  peer_->optUnchoking(false);
-}
-
 bool BtLeecherStateChoke::PeerEntry::operator<(const PeerEntry& peerEntry) const
 {
   return downloadSpeed_ > peerEntry.downloadSpeed_;
 }
 
-void swap(BtLeecherStateChoke::PeerEntry& a, BtLeecherStateChoke::PeerEntry& b)
-{
-  a.swap(b);
-}
-
 bool BtLeecherStateChoke::PeerFilter::
 operator()(const PeerEntry& peerEntry) const
 {
@@ -140,18 +80,18 @@ operator()(const PeerEntry& peerEntry) const
 void BtLeecherStateChoke::plannedOptimisticUnchoke(
     std::vector<PeerEntry>& peerEntries)
 {
-  std::for_each(std::begin(peerEntries), std::end(peerEntries),
-                std::mem_fn(&PeerEntry::disableOptUnchoking));
+  for (auto& ent : peerEntries) {
+    ent.getPeer()->optUnchoking(false);
+  }
 
   auto i = std::partition(std::begin(peerEntries), std::end(peerEntries),
                           PeerFilter(true, true));
   if (i != std::begin(peerEntries)) {
     std::shuffle(std::begin(peerEntries), i, *SimpleRandomizer::getInstance());
 
-    auto& ent = *std::begin(peerEntries);
-    auto& peer = ent.getPeer();
+    auto peer = (*std::begin(peerEntries)).getPeer();
 
-    ent.enableOptUnchoking();
+    peer->optUnchoking(true);
 
     A2_LOG_INFO(
         fmt("POU: %s:%u", peer->getIPAddress().c_str(), peer->getPort()));
@@ -163,29 +103,32 @@ void BtLeecherStateChoke::regularUnchoke(std::vector<PeerEntry>& peerEntries)
   auto rest = std::partition(std::begin(peerEntries), std::end(peerEntries),
                              std::mem_fn(&PeerEntry::isRegularUnchoker));
 
-  std::sort(std::begin(peerEntries), rest);
-  std::shuffle(rest, std::end(peerEntries), *SimpleRandomizer::getInstance());
-
   // the number of regular unchokers
-  int count = 3;
+  int count = numSlots_;
+
+  // Only the fastest count peers are needed in order.
+  auto mid = std::begin(peerEntries) +
+             std::min<ptrdiff_t>(count, rest - std::begin(peerEntries));
+  std::partial_sort(std::begin(peerEntries), mid, rest);
+  std::shuffle(rest, std::end(peerEntries), *SimpleRandomizer::getInstance());
 
   bool fastOptUnchoker = false;
   auto peerIter = std::begin(peerEntries);
   for (; peerIter != std::end(peerEntries) && count; ++peerIter, --count) {
-    auto& peer = peerIter->getPeer();
+    auto peer = peerIter->getPeer();
 
     if (!peer->peerInterested()) {
       continue;
     }
 
-    peerIter->disableChokingRequired();
+    peer->chokingRequired(false);
 
     A2_LOG_INFO(fmt("RU: %s:%u, dlspd=%d", peer->getIPAddress().c_str(),
                     peer->getPort(), (*peerIter).getDownloadSpeed()));
 
     if (peer->optUnchoking()) {
       fastOptUnchoker = true;
-      peerIter->disableOptUnchoking();
+      peer->optUnchoking(false);
     }
   }
   if (fastOptUnchoker) {
@@ -194,9 +137,9 @@ void BtLeecherStateChoke::regularUnchoke(std::vector<PeerEntry>& peerEntries)
         continue;
       }
 
-      p.enableOptUnchoking();
+      auto peer = p.getPeer();
 
-      auto& peer = p.getPeer();
+      peer->optUnchoking(true);
 
       A2_LOG_INFO(
           fmt("OU: %s:%u", peer->getIPAddress().c_str(), peer->getPort()));
@@ -211,7 +154,7 @@ void BtLeecherStateChoke::executeChoke(const PeerSet& peerSet)
   A2_LOG_INFO(fmt("Leecher state, %d choke round started", round_));
   lastRound_ = global::wallclock();
 
-  std::vector<PeerEntry> peerEntries;
+  peerEntries_.clear();
   for (const auto& p : peerSet) {
     if (!p->isActive()) {
       continue;
@@ -224,14 +167,17 @@ void BtLeecherStateChoke::executeChoke(const PeerSet& peerSet)
       continue;
     }
 
-    peerEntries.push_back(PeerEntry(p));
+    peerEntries_.push_back(PeerEntry(p.get()));
   }
 
   // planned optimistic unchoke
   if (round_ == 0) {
-    plannedOptimisticUnchoke(peerEntries);
+    plannedOptimisticUnchoke(peerEntries_);
   }
-  regularUnchoke(peerEntries);
+  regularUnchoke(peerEntries_);
+  // Don't keep pointers to peers which may be deleted before the next
+  // round.
+  peerEntries_.clear();
 
   if (++round_ == 3) {
     round_ = 0;
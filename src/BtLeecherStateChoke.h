@@ -53,38 +53,30 @@ private:
 
   Timer lastRound_;
 
+  // The number of regular unchoke slots.
+  int numSlots_;
+
   class PeerEntry {
   private:
-    std::shared_ptr<Peer> peer_;
+    Peer* peer_;
     int downloadSpeed_;
     bool regularUnchoker_;
 
   public:
-    PeerEntry(const std::shared_ptr<Peer>& peer);
-    PeerEntry(const PeerEntry& c);
-    ~PeerEntry();
-
-    PeerEntry& operator=(const PeerEntry& c);
+    PeerEntry(Peer* peer);
 
     bool operator<(const PeerEntry& rhs) const;
 
-    void swap(PeerEntry& c);
-
-    const std::shared_ptr<Peer>& getPeer() const;
-
-    int getDownloadSpeed() const;
-
-    bool isRegularUnchoker() const;
+    Peer* getPeer() const { return peer_; }
 
-    void enableChokingRequired();
+    int getDownloadSpeed() const { return downloadSpeed_; }
 
-    void disableChokingRequired();
-
-    void enableOptUnchoking();
-
-    void disableOptUnchoking();
+    bool isRegularUnchoker() const { return regularUnchoker_; }
   };
 
+  // Reused across rounds to avoid reallocation.
+  std::vector<PeerEntry> peerEntries_;
+
   void plannedOptimisticUnchoke(std::vector<PeerEntry>& peerEntries);
 
   void regularUnchoke(std::vector<PeerEntry>& peerEntries);
@@ -112,11 +104,9 @@ public:
 
   const Timer& getLastRound() const;
 
-  friend void swap(PeerEntry& a, PeerEntry& b);
+  void setNumSlots(int numSlots) { numSlots_ = numSlots; }
 };
 
-void swap(BtLeecherStateChoke::PeerEntry& a, BtLeecherStateChoke::PeerEntry& b);
-
 } // namespace aria2
 
 #endif // D_BT_LEECHER_STATE_CHOKE_H
@@ -38,6 +38,7 @@
 #include "common.h"
 
 #include <memory>
+#include <vector>
 
 namespace aria2 {
 
@@ -48,6 +49,7 @@ class BtBitfieldMessage;
 class BtCancelMessage;
 class BtChokeMessage;
 class BtHaveAllMessage;
+class BtHaveBatchMessage;
 class BtHaveMessage;
 class BtHaveNoneMessage;
 class BtInterestedMessage;
@@ -88,6 +90,10 @@ public:
 
   virtual std::unique_ptr<BtHaveMessage> createHaveMessage(size_t index) = 0;
 
+  // Creates have messages for indexes, which are sent in one buffer.
+  virtual std::unique_ptr<BtHaveBatchMessage>
+  createHaveBatchMessage(std::vector<size_t> indexes) = 0;
+
   virtual std::unique_ptr<BtChokeMessage> createChokeMessage() = 0;
 
   virtual std::unique_ptr<BtUnchokeMessage> createUnchokeMessage() = 0;
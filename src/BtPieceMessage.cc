@@ -244,16 +244,17 @@ bool BtPieceMessage::checkPieceHash(const std::shared_ptr<Piece>& piece)
   if (!getPieceStorage()->isEndGame() && piece->isHashCalculated()) {
     A2_LOG_DEBUG(fmt("Hash is available!! index=%lu",
                      static_cast<unsigned long>(piece->getIndex())));
-    return piece->getDigest() ==
-           downloadContext_->getPieceHash(piece->getIndex());
+    return downloadContext_->pieceHashEquals(piece->getIndex(),
+                                             piece->getDigest());
   }
   else {
     A2_LOG_DEBUG(fmt("Calculating hash index=%lu",
                      static_cast<unsigned long>(piece->getIndex())));
     try {
-      return piece->getDigestWithWrCache(downloadContext_->getPieceLength(),
-                                         getPieceStorage()->getDiskAdaptor()) ==
-             downloadContext_->getPieceHash(piece->getIndex());
+      return downloadContext_->pieceHashEquals(
+          piece->getIndex(),
+          piece->getDigestWithWrCache(downloadContext_->getPieceLength(),
+                                      getPieceStorage()->getDiskAdaptor()));
     }
     catch (RecoverableException& e) {
       piece->clearAllBlock(getPieceStorage()->getWrDiskCache());
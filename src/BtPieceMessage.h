@@ -36,6 +36,7 @@
 #define D_BT_PIECE_MESSAGE_H
 
 #include "AbstractBtMessage.h"
+#include "FreeList.h"
 
 namespace aria2 {
 
@@ -69,6 +70,16 @@ public:
 
   static const char NAME[];
 
+  static void* operator new(size_t size)
+  {
+    return FreeList<BtPieceMessage>::allocate(size);
+  }
+
+  static void operator delete(void* p, size_t size)
+  {
+    FreeList<BtPieceMessage>::deallocate(p, size);
+  }
+
   size_t getIndex() const { return index_; }
 
   void setIndex(size_t index) { index_ = index; }
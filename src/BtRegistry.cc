@@ -93,6 +93,20 @@ bool BtRegistry::remove(a2_gid_t gid) { return pool_.erase(gid); }
 
 void BtRegistry::removeAll() { pool_.clear(); }
 
+bool BtRegistry::isBadPeer(const std::string& ipaddr) const
+{
+  if (pool_.empty()) {
+    return false;
+  }
+  for (auto& kv : pool_) {
+    auto& peerStorage = kv.second->peerStorage;
+    if (!peerStorage || !peerStorage->isBadPeer(ipaddr)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void BtRegistry::setLpdMessageReceiver(
     const std::shared_ptr<LpdMessageReceiver>& receiver)
 {
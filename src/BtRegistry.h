@@ -107,6 +107,12 @@ public:
 
   bool remove(a2_gid_t gid);
 
+  // Returns true if ipaddr is marked bad in every registered
+  // download.  Incoming connections from such peer cannot be used by
+  // any of them, so they can be dropped before BitTorrent handshake.
+  // Returns false if there is no registered download.
+  bool isBadPeer(const std::string& ipaddr) const;
+
   void setTcpPort(uint16_t port) { tcpPort_ = port; }
   uint16_t getTcpPort() const { return tcpPort_; }
 
@@ -36,6 +36,7 @@
 #define D_BT_REQUEST_MESSAGE_H
 
 #include "RangeBtMessage.h"
+#include "FreeList.h"
 
 namespace aria2 {
 
@@ -51,6 +52,16 @@ public:
 
   static const char NAME[];
 
+  static void* operator new(size_t size)
+  {
+    return FreeList<BtRequestMessage>::allocate(size);
+  }
+
+  static void operator delete(void* p, size_t size)
+  {
+    FreeList<BtRequestMessage>::deallocate(p, size);
+  }
+
   size_t getBlockIndex() const { return blockIndex_; }
   void setBlockIndex(size_t blockIndex) { blockIndex_ = blockIndex; }
 
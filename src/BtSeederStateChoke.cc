@@ -35,8 +35,11 @@
 #include "BtSeederStateChoke.h"
 
 #include <algorithm>
+#include <cstdlib>
 
 #include "Peer.h"
+#include "PeerBitfield.h"
+#include "UploadSlotTuner.h"
 #include "Logger.h"
 #include "LogFactory.h"
 #include "SimpleRandomizer.h"
@@ -45,7 +48,11 @@
 
 namespace aria2 {
 
-BtSeederStateChoke::BtSeederStateChoke() : round_(0), lastRound_(Timer::zero())
+BtSeederStateChoke::BtSeederStateChoke()
+    : round_(0),
+      lastRound_(Timer::zero()),
+      algorithm_(ROUND_ROBIN),
+      numSlots_(UploadSlotTuner::DEFAULT_NUM_SLOTS)
 {
 }
 
@@ -55,44 +62,32 @@ namespace {
 constexpr auto TIME_FRAME = 20_s;
 } // namespace
 
-BtSeederStateChoke::PeerEntry::PeerEntry(const std::shared_ptr<Peer>& peer)
+namespace {
+// Returns the distance of the progress of peer from the half way, in
+// the range [0, 500].
+int calculateAntiLeechScore(const Peer* peer)
+{
+  const auto& bitfield = peer->getPeerBitfield();
+  if (bitfield.countBlock() == 0) {
+    return 0;
+  }
+  int progress = bitfield.countSetBit() * 1000 / bitfield.countBlock();
+  return std::abs(progress - 500);
+}
+} // namespace
+
+BtSeederStateChoke::PeerEntry::PeerEntry(Peer* peer)
     : peer_(peer),
       outstandingUpload_(peer->countOutstandingUpload()),
       lastAmUnchoking_(peer->getLastAmUnchoking()),
       recentUnchoking_(lastAmUnchoking_.difference(global::wallclock()) <
                        TIME_FRAME),
-      uploadSpeed_(peer->calculateUploadSpeed())
+      uploadSpeed_(peer->calculateUploadSpeed()),
+      antiLeechScore_(calculateAntiLeechScore(peer))
 {
 }
 
-BtSeederStateChoke::PeerEntry::PeerEntry(const PeerEntry& c) = default;
-
-BtSeederStateChoke::PeerEntry::~PeerEntry() = default;
-
-void BtSeederStateChoke::PeerEntry::swap(PeerEntry& c)
-{
-  using std::swap;
-  swap(peer_, c.peer_);
-  swap(outstandingUpload_, c.outstandingUpload_);
-  swap(lastAmUnchoking_, c.lastAmUnchoking_);
-  swap(recentUnchoking_, c.recentUnchoking_);
-  swap(uploadSpeed_, c.uploadSpeed_);
-}
-
-BtSeederStateChoke::PeerEntry& BtSeederStateChoke::PeerEntry::
-operator=(const PeerEntry& c)
-{
-  if (this != &c) {
-    peer_ = c.peer_;
-    outstandingUpload_ = c.outstandingUpload_;
-    lastAmUnchoking_ = c.lastAmUnchoking_;
-    recentUnchoking_ = c.recentUnchoking_;
-    uploadSpeed_ = c.uploadSpeed_;
-  }
-  return *this;
-}
-
-bool BtSeederStateChoke::PeerEntry::operator<(const PeerEntry& rhs) const
+bool BtSeederStateChoke::PeerEntry::lessRoundRobin(const PeerEntry& rhs) const
 {
   if (this->outstandingUpload_ && !rhs.outstandingUpload_) {
     return true;
@@ -112,21 +107,44 @@ bool BtSeederStateChoke::PeerEntry::operator<(const PeerEntry& rhs) const
   }
 }
 
-void BtSeederStateChoke::PeerEntry::disableOptUnchoking()
+bool BtSeederStateChoke::PeerEntry::lessFastestUpload(
+    const PeerEntry& rhs) const
+{
+  return this->uploadSpeed_ > rhs.uploadSpeed_;
+}
+
+bool BtSeederStateChoke::PeerEntry::lessAntiLeech(const PeerEntry& rhs) const
 {
-  peer_->optUnchoking(false);
+  if (this->antiLeechScore_ != rhs.antiLeechScore_) {
+    return this->antiLeechScore_ > rhs.antiLeechScore_;
+  }
+  return this->uploadSpeed_ > rhs.uploadSpeed_;
 }
 
 void BtSeederStateChoke::unchoke(
     std::vector<BtSeederStateChoke::PeerEntry>& peers)
 {
-  int count = (round_ == 2) ? 4 : 3;
-
-  std::sort(std::begin(peers), std::end(peers));
+  size_t count = (round_ == 2) ? numSlots_ + 1 : numSlots_;
+
+  // We only need the first count peers in order.
+  auto mid = std::begin(peers) + std::min(count, peers.size());
+  switch (algorithm_) {
+  case ROUND_ROBIN:
+    std::partial_sort(std::begin(peers), mid, std::end(peers),
+                      std::mem_fn(&PeerEntry::lessRoundRobin));
+    break;
+  case FASTEST_UPLOAD:
+    std::partial_sort(std::begin(peers), mid, std::end(peers),
+                      std::mem_fn(&PeerEntry::lessFastestUpload));
+    break;
+  case ANTI_LEECH:
+    std::partial_sort(std::begin(peers), mid, std::end(peers),
+                      std::mem_fn(&PeerEntry::lessAntiLeech));
+    break;
+  }
 
-  auto r = std::begin(peers);
-  for (; r != std::end(peers) && count; ++r, --count) {
-    auto& peer = (*r).getPeer();
+  for (auto r = std::begin(peers); r != mid; ++r) {
+    auto peer = (*r).getPeer();
 
     peer->chokingRequired(false);
 
@@ -135,12 +153,13 @@ void BtSeederStateChoke::unchoke(
   }
 
   if (round_ < 2) {
-    std::for_each(std::begin(peers), std::end(peers),
-                  std::mem_fn(&PeerEntry::disableOptUnchoking));
-    if (r != std::end(peers)) {
-      std::shuffle(r, std::end(peers), *SimpleRandomizer::getInstance());
+    for (auto& ent : peers) {
+      ent.getPeer()->optUnchoking(false);
+    }
+    if (mid != std::end(peers)) {
+      std::shuffle(mid, std::end(peers), *SimpleRandomizer::getInstance());
 
-      auto& peer = (*r).getPeer();
+      auto peer = (*mid).getPeer();
 
       peer->optUnchoking(true);
 
@@ -155,7 +174,7 @@ void BtSeederStateChoke::executeChoke(const PeerSet& peerSet)
   A2_LOG_INFO(fmt("Seeder state, %d choke round started", round_));
   lastRound_ = global::wallclock();
 
-  std::vector<PeerEntry> peerEntries;
+  peerEntries_.clear();
   for (const auto& p : peerSet) {
     if (!p->isActive()) {
       continue;
@@ -163,23 +182,21 @@ void BtSeederStateChoke::executeChoke(const PeerSet& peerSet)
 
     p->chokingRequired(true);
     if (p->peerInterested()) {
-      peerEntries.push_back(PeerEntry(p));
+      peerEntries_.push_back(PeerEntry(p.get()));
       continue;
     }
 
     p->optUnchoking(false);
   }
 
-  unchoke(peerEntries);
+  unchoke(peerEntries_);
+  // Don't keep pointers to peers which may be deleted before the next
+  // round.
+  peerEntries_.clear();
 
   if (++round_ == 3) {
     round_ = 0;
   }
 }
 
-void swap(BtSeederStateChoke::PeerEntry& a, BtSeederStateChoke::PeerEntry& b)
-{
-  a.swap(b);
-}
-
 } // namespace aria2
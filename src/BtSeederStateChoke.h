@@ -48,37 +48,57 @@ namespace aria2 {
 class Peer;
 
 class BtSeederStateChoke {
+public:
+  // Algorithm to choose peers to unchoke in seeding.
+  enum Algorithm {
+    // Prefers peers which we are uploading to, and then peers
+    // unchoked recently, so that upload slots rotate among peers.
+    ROUND_ROBIN,
+    // Prefers peers which we upload to fastest.
+    FASTEST_UPLOAD,
+    // Prefers peers which have just started or almost finished
+    // downloading, so that the peers in the middle of download get
+    // pieces from each other.
+    ANTI_LEECH
+  };
+
 private:
   int round_;
 
   Timer lastRound_;
 
+  Algorithm algorithm_;
+
+  // The number of regular unchoke slots.
+  int numSlots_;
+
   class PeerEntry {
   private:
-    std::shared_ptr<Peer> peer_;
+    Peer* peer_;
     size_t outstandingUpload_;
     Timer lastAmUnchoking_;
     bool recentUnchoking_;
     int uploadSpeed_;
+    // Larger is better.  Only used in ANTI_LEECH.
+    int antiLeechScore_;
 
   public:
-    PeerEntry(const std::shared_ptr<Peer>& peer);
-    PeerEntry(const PeerEntry& c);
-    ~PeerEntry();
-
-    void swap(PeerEntry& c);
+    PeerEntry(Peer* peer);
 
-    PeerEntry& operator=(const PeerEntry& c);
+    Peer* getPeer() const { return peer_; }
 
-    bool operator<(const PeerEntry& rhs) const;
+    int getUploadSpeed() const { return uploadSpeed_; }
 
-    const std::shared_ptr<Peer>& getPeer() const { return peer_; }
+    bool lessRoundRobin(const PeerEntry& rhs) const;
 
-    int getUploadSpeed() const { return uploadSpeed_; }
+    bool lessFastestUpload(const PeerEntry& rhs) const;
 
-    void disableOptUnchoking();
+    bool lessAntiLeech(const PeerEntry& rhs) const;
   };
 
+  // Reused across rounds to avoid reallocation.
+  std::vector<PeerEntry> peerEntries_;
+
   void unchoke(std::vector<PeerEntry>& peers);
 
 public:
@@ -90,10 +110,12 @@ public:
 
   const Timer& getLastRound() const { return lastRound_; }
 
-  friend void swap(PeerEntry& a, PeerEntry& b);
-};
+  void setAlgorithm(Algorithm algorithm) { algorithm_ = algorithm; }
+
+  Algorithm getAlgorithm() const { return algorithm_; }
 
-void swap(BtSeederStateChoke::PeerEntry& a, BtSeederStateChoke::PeerEntry& b);
+  void setNumSlots(int numSlots) { numSlots_ = numSlots; }
+};
 
 } // namespace aria2
 
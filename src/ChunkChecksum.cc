@@ -33,17 +33,16 @@
  */
 /* copyright --> */
 #include "ChunkChecksum.h"
-#include "A2STR.h"
 
 namespace aria2 {
 
 ChunkChecksum::ChunkChecksum() : pieceLength_(0) {}
 
 ChunkChecksum::ChunkChecksum(std::string hashType,
-                             std::vector<std::string> pieceHashes,
+                             const std::vector<std::string>& pieceHashes,
                              int32_t pieceLength)
     : hashType_(std::move(hashType)),
-      pieceHashes_(std::move(pieceHashes)),
+      pieceHashes_(pieceHashes.begin(), pieceHashes.end()),
       pieceLength_(pieceLength)
 {
 }
@@ -51,25 +50,19 @@ ChunkChecksum::ChunkChecksum(std::string hashType,
 bool ChunkChecksum::validateChunk(const std::string& actualDigest,
                                   size_t index) const
 {
-  const std::string& digest = getPieceHash(index);
-  return !digest.empty() && actualDigest == digest;
+  return pieceHashes_.equals(index, actualDigest);
 }
 
 int64_t ChunkChecksum::getEstimatedDataLength() const
 {
-  return static_cast<int64_t>(pieceLength_) * pieceHashes_.size();
+  return static_cast<int64_t>(pieceLength_) * countPieceHash();
 }
 
 size_t ChunkChecksum::countPieceHash() const { return pieceHashes_.size(); }
 
-const std::string& ChunkChecksum::getPieceHash(size_t index) const
+std::string ChunkChecksum::getPieceHash(size_t index) const
 {
-  if (index < pieceHashes_.size()) {
-    return pieceHashes_[index];
-  }
-  else {
-    return A2STR::NIL;
-  }
+  return pieceHashes_.get(index);
 }
 
 void ChunkChecksum::setHashType(std::string hashType)
@@ -77,9 +70,9 @@ void ChunkChecksum::setHashType(std::string hashType)
   hashType_ = std::move(hashType);
 }
 
-void ChunkChecksum::setPieceHashes(std::vector<std::string> pieceHashes)
+void ChunkChecksum::setPieceHashes(const std::vector<std::string>& pieceHashes)
 {
-  pieceHashes_ = std::move(pieceHashes);
+  pieceHashes_ = PieceHashes(pieceHashes.begin(), pieceHashes.end());
 }
 
 } // namespace aria2
@@ -40,18 +40,21 @@
 #include <string>
 #include <vector>
 
+#include "PieceHashes.h"
+
 namespace aria2 {
 
 class ChunkChecksum {
 private:
   std::string hashType_;
-  std::vector<std::string> pieceHashes_;
+  PieceHashes pieceHashes_;
   int32_t pieceLength_;
 
 public:
   ChunkChecksum();
 
-  ChunkChecksum(std::string hashType, std::vector<std::string> pieceHashes,
+  ChunkChecksum(std::string hashType,
+                const std::vector<std::string>& pieceHashes,
                 int32_t pieceLength);
 
   bool validateChunk(const std::string& actualDigest, size_t index) const;
@@ -60,13 +63,13 @@ public:
 
   size_t countPieceHash() const;
 
-  const std::string& getPieceHash(size_t index) const;
+  std::string getPieceHash(size_t index) const;
+
+  // All hashes in pieceHashes must have the same length.  Otherwise,
+  // piece hashes are cleared.
+  void setPieceHashes(const std::vector<std::string>& pieceHashes);
 
-  void setPieceHashes(std::vector<std::string> pieceHashes);
-  const std::vector<std::string>& getPieceHashes() const
-  {
-    return pieceHashes_;
-  }
+  const PieceHashes& getPieceHashes() const { return pieceHashes_; }
 
   void setHashType(std::string hashType);
   const std::string& getHashType() const { return hashType_; }
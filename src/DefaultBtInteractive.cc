@@ -36,6 +36,7 @@
 
 #include <cstring>
 #include <vector>
+#include <algorithm>
 
 #include "prefs.h"
 #include "message.h"
@@ -50,6 +51,7 @@
 #include "BtInterestedMessage.h"
 #include "BtNotInterestedMessage.h"
 #include "BtHaveMessage.h"
+#include "BtHaveBatchMessage.h"
 #include "BtHaveAllMessage.h"
 #include "BtBitfieldMessage.h"
 #include "BtHaveNoneMessage.h"
@@ -93,6 +95,9 @@ DefaultBtInteractive::DefaultBtInteractive(
       metadataGetMode_(false),
       localNode_(nullptr),
       lastHaveIndex_(0),
+      numHaveSent_(0),
+      numHaveSuppressed_(0),
+      numHaveBatched_(0),
       allowedFastSetSize_(10),
       keepAliveTimer_(global::wallclock()),
       floodingTimer_(global::wallclock()),
@@ -109,7 +114,16 @@ DefaultBtInteractive::DefaultBtInteractive(
 {
 }
 
-DefaultBtInteractive::~DefaultBtInteractive() = default;
+DefaultBtInteractive::~DefaultBtInteractive()
+{
+  if (numHaveSuppressed_ > 0 || numHaveBatched_ > 0) {
+    A2_LOG_INFO(fmt("CUID#%" PRId64 " - Have messages: sent=%lu,"
+                    " suppressed=%lu, batched=%lu",
+                    cuid_, static_cast<unsigned long>(numHaveSent_),
+                    static_cast<unsigned long>(numHaveSuppressed_),
+                    static_cast<unsigned long>(numHaveBatched_)));
+  }
+}
 
 void DefaultBtInteractive::initiateHandshake()
 {
@@ -268,6 +282,28 @@ void DefaultBtInteractive::checkHave()
 
   lastHaveIndex_ = pieceStorage_->getAdvertisedPieceIndexes(haveIndexes, cuid_,
                                                             lastHaveIndex_);
+  if (haveIndexes.empty()) {
+    return;
+  }
+
+  // The peer does not need to know the pieces it already has.
+  // Seeders do not need any of them.
+  auto numHave = haveIndexes.size();
+  if (peer_->isSeeder()) {
+    haveIndexes.clear();
+  }
+  else {
+    haveIndexes.erase(std::remove_if(std::begin(haveIndexes),
+                                     std::end(haveIndexes),
+                                     [this](size_t index) {
+                                       return peer_->hasPiece(index);
+                                     }),
+                      std::end(haveIndexes));
+  }
+  numHaveSuppressed_ += numHave - haveIndexes.size();
+  if (haveIndexes.empty()) {
+    return;
+  }
 
   // Use bitfield message if it is equal to or less than the total
   // size of have messages.
@@ -284,9 +320,17 @@ void DefaultBtInteractive::checkHave()
     return;
   }
 
-  for (auto idx : haveIndexes) {
-    dispatcher_->addMessageToQueue(messageFactory_->createHaveMessage(idx));
+  numHaveSent_ += haveIndexes.size();
+  if (haveIndexes.size() == 1) {
+    dispatcher_->addMessageToQueue(
+        messageFactory_->createHaveMessage(haveIndexes[0]));
+    return;
   }
+  // Send all haves in one buffer, rather than queuing a message and a
+  // buffer for each of them.
+  numHaveBatched_ += haveIndexes.size() - 1;
+  dispatcher_->addMessageToQueue(
+      messageFactory_->createHaveBatchMessage(std::move(haveIndexes)));
 }
 
 void DefaultBtInteractive::sendKeepAlive()
@@ -126,6 +126,13 @@ private:
 
   // The last haveIndex we have advertised to the peer.
   uint64_t lastHaveIndex_;
+  // The number of haves sent to the peer.
+  size_t numHaveSent_;
+  // The number of haves not sent because the peer has the piece.
+  size_t numHaveSuppressed_;
+  // The number of have messages which were not queued separately
+  // because they were sent in a batch.
+  size_t numHaveBatched_;
 
   size_t allowedFastSetSize_;
   Timer keepAliveTimer_;
@@ -166,6 +173,12 @@ public:
 
   virtual ~DefaultBtInteractive();
 
+  size_t getNumHaveSent() const { return numHaveSent_; }
+
+  size_t getNumHaveSuppressed() const { return numHaveSuppressed_; }
+
+  size_t getNumHaveBatched() const { return numHaveBatched_; }
+
   virtual void initiateHandshake() CXX11_OVERRIDE;
 
   virtual std::unique_ptr<BtHandshakeMessage>
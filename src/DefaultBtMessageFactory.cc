@@ -41,6 +41,7 @@
 #include "BtInterestedMessage.h"
 #include "BtNotInterestedMessage.h"
 #include "BtHaveMessage.h"
+#include "BtHaveBatchMessage.h"
 #include "BtBitfieldMessage.h"
 #include "BtBitfieldMessageValidator.h"
 #include "RangeBtMessageValidator.h"
@@ -306,6 +307,14 @@ DefaultBtMessageFactory::createHaveMessage(size_t index)
   return msg;
 }
 
+std::unique_ptr<BtHaveBatchMessage>
+DefaultBtMessageFactory::createHaveBatchMessage(std::vector<size_t> indexes)
+{
+  auto msg = make_unique<BtHaveBatchMessage>(std::move(indexes));
+  setCommonProperty(msg.get());
+  return msg;
+}
+
 std::unique_ptr<BtChokeMessage> DefaultBtMessageFactory::createChokeMessage()
 {
   auto msg = make_unique<BtChokeMessage>();
@@ -113,6 +113,9 @@ public:
   virtual std::unique_ptr<BtHaveMessage>
   createHaveMessage(size_t index) CXX11_OVERRIDE;
 
+  virtual std::unique_ptr<BtHaveBatchMessage>
+  createHaveBatchMessage(std::vector<size_t> indexes) CXX11_OVERRIDE;
+
   virtual std::unique_ptr<BtChokeMessage> createChokeMessage() CXX11_OVERRIDE;
 
   virtual std::unique_ptr<BtUnchokeMessage>
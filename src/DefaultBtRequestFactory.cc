@@ -201,28 +201,18 @@ DefaultBtRequestFactory::createRequestMessagesOnEndGame(size_t max)
   for (auto itr = std::begin(pieces_), eoi = std::end(pieces_);
        itr != eoi && requests.size() < max; ++itr) {
     auto& piece = *itr;
-    const size_t mislen = piece->getBitfieldLength();
-    auto misbitfield = make_unique<unsigned char[]>(mislen);
-
-    piece->getAllMissingBlockIndexes(misbitfield.get(), mislen);
-
-    auto missingBlockIndexes = std::vector<size_t>{};
-    size_t blockIndex = 0;
-    for (size_t i = 0; i < mislen; ++i) {
-      unsigned char bits = misbitfield[i];
-      unsigned char mask = 128;
-      for (size_t bi = 0; bi < 8; ++bi, mask >>= 1, ++blockIndex) {
-        if (bits & mask) {
-          missingBlockIndexes.push_back(blockIndex);
-        }
-      }
+    const size_t nblocks = piece->countBlock();
+    if (nblocks == 0) {
+      continue;
     }
-    std::shuffle(std::begin(missingBlockIndexes), std::end(missingBlockIndexes),
-                 *SimpleRandomizer::getInstance());
-    for (auto bitr = std::begin(missingBlockIndexes),
-              eoi2 = std::end(missingBlockIndexes);
-         bitr != eoi2 && requests.size() < max; ++bitr) {
-      size_t blockIndex = *bitr;
+    // Start from a random block, so that peers in end game request
+    // different blocks first.
+    size_t start = SimpleRandomizer::getInstance()->getRandomNumber(nblocks);
+    for (size_t k = 0; k < nblocks && requests.size() < max; ++k) {
+      size_t blockIndex = (start + k) % nblocks;
+      if (piece->hasBlock(blockIndex)) {
+        continue;
+      }
       if (!dispatcher_->isOutstandingRequest(piece->getIndex(), blockIndex)) {
         A2_LOG_DEBUG(
             fmt("Creating RequestMessage index=%lu, begin=%u,"
@@ -43,11 +43,13 @@
 #include "BtRuntime.h"
 #include "BtSeederStateChoke.h"
 #include "BtLeecherStateChoke.h"
+#include "UploadSlotTuner.h"
 #include "PieceStorage.h"
 #include "wallclock.h"
 #include "a2functional.h"
 #include "fmt.h"
 #include "SimpleRandomizer.h"
+#include "prefs.h"
 
 namespace aria2 {
 
@@ -61,6 +63,7 @@ DefaultPeerStorage::DefaultPeerStorage()
     : maxPeerListSize_(MAX_PEER_LIST_SIZE),
       seederStateChoke_(make_unique<BtSeederStateChoke>()),
       leecherStateChoke_(make_unique<BtLeecherStateChoke>()),
+      maxUploadSpeedLimit_(0),
       lastTransferStatMapUpdated_(Timer::zero())
 {
 }
@@ -339,6 +342,25 @@ bool DefaultPeerStorage::chokeRoundIntervalElapsed()
 
 void DefaultPeerStorage::executeChoke()
 {
+  if (uploadSlotTuner_) {
+    int uploadSpeed = 0;
+    size_t numCandidates = 0;
+    for (const auto& p : usedPeers_) {
+      if (!p->isActive()) {
+        continue;
+      }
+      uploadSpeed += p->calculateUploadSpeed();
+      if (p->peerInterested()) {
+        ++numCandidates;
+      }
+    }
+    uploadSlotTuner_->update(uploadSpeed, numCandidates);
+    auto numSlots = uploadSlotTuner_->getNumSlots();
+    A2_LOG_INFO(fmt("Upload slots=%d, ulspd=%d, capacity=%d", numSlots,
+                    uploadSpeed, uploadSlotTuner_->getCapacity()));
+    seederStateChoke_->setNumSlots(numSlots);
+    leecherStateChoke_->setNumSlots(numSlots);
+  }
   if (pieceStorage_->downloadFinished()) {
     return seederStateChoke_->executeChoke(usedPeers_);
   }
@@ -353,6 +375,38 @@ void DefaultPeerStorage::setPieceStorage(
   pieceStorage_ = ps;
 }
 
+void DefaultPeerStorage::setSeedChokingAlgorithm(const std::string& algorithm)
+{
+  if (algorithm == V_FASTEST_UPLOAD) {
+    seederStateChoke_->setAlgorithm(BtSeederStateChoke::FASTEST_UPLOAD);
+  }
+  else if (algorithm == V_ANTI_LEECH) {
+    seederStateChoke_->setAlgorithm(BtSeederStateChoke::ANTI_LEECH);
+  }
+  else {
+    seederStateChoke_->setAlgorithm(BtSeederStateChoke::ROUND_ROBIN);
+  }
+}
+
+void DefaultPeerStorage::setUploadSlotTarget(int targetPercent)
+{
+  if (targetPercent > 0) {
+    uploadSlotTuner_ = make_unique<UploadSlotTuner>(targetPercent);
+    uploadSlotTuner_->setMaxUploadSpeed(maxUploadSpeedLimit_);
+  }
+  else {
+    uploadSlotTuner_.reset();
+  }
+}
+
+void DefaultPeerStorage::setMaxUploadSpeedLimit(int speed)
+{
+  maxUploadSpeedLimit_ = speed;
+  if (uploadSlotTuner_) {
+    uploadSlotTuner_->setMaxUploadSpeed(speed);
+  }
+}
+
 void DefaultPeerStorage::setBtRuntime(
     const std::shared_ptr<BtRuntime>& btRuntime)
 {
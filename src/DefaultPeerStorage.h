@@ -47,6 +47,7 @@ namespace aria2 {
 class BtRuntime;
 class BtSeederStateChoke;
 class BtLeecherStateChoke;
+class UploadSlotTuner;
 class PieceStorage;
 
 class DefaultPeerStorage : public PeerStorage {
@@ -68,6 +69,11 @@ private:
 
   std::unique_ptr<BtSeederStateChoke> seederStateChoke_;
   std::unique_ptr<BtLeecherStateChoke> leecherStateChoke_;
+  // Null if upload slots are not tuned automatically.
+  std::unique_ptr<UploadSlotTuner> uploadSlotTuner_;
+  // Maximum upload speed of this download in bytes/sec.  0 means
+  // unlimited.
+  int maxUploadSpeedLimit_;
 
   Timer lastTransferStatMapUpdated_;
 
@@ -128,6 +134,20 @@ public:
 
   void setBtRuntime(const std::shared_ptr<BtRuntime>& btRuntime);
 
+  // Sets the algorithm used in seeder choke rounds.  algorithm must
+  // be one of V_ROUND_ROBIN, V_FASTEST_UPLOAD and V_ANTI_LEECH.
+  // Other values select V_ROUND_ROBIN.
+  void setSeedChokingAlgorithm(const std::string& algorithm);
+
+  // Enables automatic tuning of the number of upload slots so that
+  // upload speed stays around targetPercent of the measured capacity.
+  // If targetPercent is 0, the number of slots is fixed.
+  void setUploadSlotTarget(int targetPercent);
+
+  // Sets the maximum upload speed of this download.  If it is
+  // positive, the upload slot tuning uses it as the upload capacity.
+  void setMaxUploadSpeedLimit(int speed);
+
   void setMaxPeerListSize(size_t maxPeerListSize)
   {
     maxPeerListSize_ = maxPeerListSize;
@@ -36,10 +36,13 @@
 
 #include <numeric>
 #include <algorithm>
+#include <limits>
+#include <functional>
 
 #include "DownloadContext.h"
 #include "Piece.h"
 #include "Peer.h"
+#include "PeerBitfield.h"
 #include "LogFactory.h"
 #include "Logger.h"
 #include "prefs.h"
@@ -75,6 +78,10 @@
 
 namespace aria2 {
 
+namespace {
+const uint32_t NO_SLOT = std::numeric_limits<uint32_t>::max();
+} // namespace
+
 DefaultPieceStorage::DefaultPieceStorage(
     const std::shared_ptr<DownloadContext>& downloadContext,
     const Option* option)
@@ -82,8 +89,10 @@ DefaultPieceStorage::DefaultPieceStorage(
       bitfieldMan_(make_unique<BitfieldMan>(downloadContext->getPieceLength(),
                                             downloadContext->getTotalLength())),
       diskWriterFactory_(std::make_shared<DefaultDiskWriterFactory>()),
+      usedPieceSlots_(downloadContext->getNumPieces(), NO_SLOT),
       endGame_(false),
       endGamePieceNum_(END_GAME_PIECE_NUM),
+      endGamePiecesValid_(false),
       option_(option),
       // The DefaultBtInteractive has the default value of
       // lastHaveIndex of 0, so we need to make nextHaveIndex_ more
@@ -164,86 +173,175 @@ std::shared_ptr<Piece> DefaultPieceStorage::getPiece(size_t index)
 
 void DefaultPieceStorage::addUsedPiece(const std::shared_ptr<Piece>& piece)
 {
-  usedPieces_.insert(piece);
+  auto index = piece->getIndex();
+  if (index >= usedPieceSlots_.size()) {
+    usedPieceSlots_.resize(index + 1, NO_SLOT);
+  }
+  if (usedPieceSlots_[index] == NO_SLOT) {
+    usedPieceSlots_[index] = usedPieces_.size();
+    usedPieces_.push_back(piece);
+  }
   A2_LOG_DEBUG(fmt("usedPieces_.size()=%lu",
                    static_cast<unsigned long>(usedPieces_.size())));
 }
 
 std::shared_ptr<Piece> DefaultPieceStorage::findUsedPiece(size_t index) const
 {
-  auto p = std::make_shared<Piece>();
-  p->setIndex(index);
-
-  auto i = usedPieces_.find(p);
-  if (i == usedPieces_.end()) {
-    p.reset();
-    return p;
-  }
-  else {
-    return *i;
+  if (index >= usedPieceSlots_.size() || usedPieceSlots_[index] == NO_SLOT) {
+    return nullptr;
   }
+  return usedPieces_[usedPieceSlots_[index]];
+}
+
+std::vector<std::shared_ptr<Piece>>
+DefaultPieceStorage::getSortedUsedPieces() const
+{
+  auto pieces = usedPieces_;
+  std::sort(std::begin(pieces), std::end(pieces),
+            DerefLess<std::shared_ptr<Piece>>());
+  return pieces;
 }
 
 #ifdef ENABLE_BITTORRENT
 
 bool DefaultPieceStorage::hasMissingPiece(const std::shared_ptr<Peer>& peer)
 {
-  return bitfieldMan_->hasMissingPiece(peer->getBitfield(),
-                                       peer->getBitfieldLength());
+  const auto& peerBitfield = peer->getPeerBitfield();
+  if (peerBitfield.isSparse()) {
+    if (peerBitfield.countBlock() != bitfieldMan_->countBlock()) {
+      return false;
+    }
+    const bool filter = bitfieldMan_->isFilterEnabled();
+    for (auto i : peerBitfield.getSparseIndexes()) {
+      if (!bitfieldMan_->isBitSet(i) &&
+          (!filter || bitfieldMan_->isFilterBitSet(i))) {
+        return true;
+      }
+    }
+    return false;
+  }
+  return bitfieldMan_->hasMissingPiece(peerBitfield.getBitfield(),
+                                       peerBitfield.getBitfieldLength());
+}
+
+namespace {
+size_t gcd(size_t a, size_t b)
+{
+  while (b) {
+    auto t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+} // namespace
+
+void DefaultPieceStorage::buildEndGamePieces()
+{
+  endGamePieces_.clear();
+  const size_t nbits = bitfieldMan_->countBlock();
+  const bool filter = bitfieldMan_->isFilterEnabled();
+  for (size_t i = 0; i < nbits; ++i) {
+    if (!bitfieldMan_->isBitSet(i) &&
+        (!filter || bitfieldMan_->isFilterBitSet(i))) {
+      endGamePieces_.push_back(i);
+    }
+  }
+  endGamePiecesValid_ = true;
+}
+
+template <typename Pred>
+void DefaultPieceStorage::getMissingPieceOnEndGame(
+    std::vector<std::shared_ptr<Piece>>& pieces, size_t minMissingBlocks,
+    Pred isCandidate, cuid_t cuid)
+{
+  if (!endGamePiecesValid_) {
+    buildEndGamePieces();
+  }
+  const size_t n = endGamePieces_.size();
+  if (n == 0) {
+    return;
+  }
+  // Visit positions start, start + step, start + 2 * step, ... modulo
+  // n.  step is coprime to n, so that each position is visited
+  // exactly once, in random order without shuffling all of them.
+  auto& rand = *SimpleRandomizer::getInstance();
+  size_t start = rand.getRandomNumber(n);
+  size_t step = 1;
+  if (n > 2) {
+    do {
+      step = 1 + rand.getRandomNumber(n - 1);
+    } while (gcd(step, n) != 1);
+  }
+  const bool filter = bitfieldMan_->isFilterEnabled();
+  std::vector<size_t> completed;
+  size_t misBlock = 0;
+  for (size_t k = 0, pos = start; k < n && misBlock < minMissingBlocks;
+       ++k, pos = (pos + step) % n) {
+    size_t index = endGamePieces_[pos];
+    if (bitfieldMan_->isBitSet(index)) {
+      completed.push_back(pos);
+      continue;
+    }
+    if ((filter && !bitfieldMan_->isFilterBitSet(index)) ||
+        !isCandidate(index)) {
+      continue;
+    }
+    std::shared_ptr<Piece> piece = checkOutPiece(index, cuid);
+    if (piece->getUsedBySegment()) {
+      // We don't share piece downloaded via HTTP/FTP
+      piece->removeUser(cuid);
+    }
+    else {
+      pieces.push_back(piece);
+      misBlock += piece->countMissingBlock();
+    }
+  }
+  // Removing from the highest position does not move the other
+  // positions to be removed.
+  std::sort(std::begin(completed), std::end(completed),
+            std::greater<size_t>());
+  for (auto pos : completed) {
+    endGamePieces_[pos] = endGamePieces_.back();
+    endGamePieces_.pop_back();
+  }
 }
 
 void DefaultPieceStorage::getMissingPiece(
     std::vector<std::shared_ptr<Piece>>& pieces, size_t minMissingBlocks,
     const unsigned char* bitfield, size_t length, cuid_t cuid)
 {
+  if (isEndGame()) {
+    if (length != bitfieldMan_->getBitfieldLength()) {
+      return;
+    }
+    const size_t nbits = bitfieldMan_->countBlock();
+    getMissingPieceOnEndGame(
+        pieces, minMissingBlocks,
+        [bitfield, nbits](size_t index) {
+          return bitfield::test(bitfield, nbits, index);
+        },
+        cuid);
+    return;
+  }
   const size_t mislen = bitfieldMan_->getBitfieldLength();
   auto misbitfield = make_unique<unsigned char[]>(mislen);
   size_t blocks = bitfieldMan_->countBlock();
   size_t misBlock = 0;
-  if (isEndGame()) {
-    bool r = bitfieldMan_->getAllMissingIndexes(misbitfield.get(), mislen,
-                                                bitfield, length);
-    if (!r) {
-      return;
-    }
-    std::vector<size_t> indexes;
-    for (size_t i = 0; i < blocks; ++i) {
-      if (bitfield::test(misbitfield, blocks, i)) {
-        indexes.push_back(i);
-      }
-    }
-    std::shuffle(indexes.begin(), indexes.end(),
-                 *SimpleRandomizer::getInstance());
-    for (std::vector<size_t>::const_iterator i = indexes.begin(),
-                                             eoi = indexes.end();
-         i != eoi && misBlock < minMissingBlocks; ++i) {
-      std::shared_ptr<Piece> piece = checkOutPiece(*i, cuid);
-      if (piece->getUsedBySegment()) {
-        // We don't share piece downloaded via HTTP/FTP
-        piece->removeUser(cuid);
-      }
-      else {
-        pieces.push_back(piece);
-        misBlock += piece->countMissingBlock();
-      }
-    }
+  bool r = bitfieldMan_->getAllMissingUnusedIndexes(misbitfield.get(), mislen,
+                                                    bitfield, length);
+  if (!r) {
+    return;
   }
-  else {
-    bool r = bitfieldMan_->getAllMissingUnusedIndexes(misbitfield.get(), mislen,
-                                                      bitfield, length);
-    if (!r) {
-      return;
+  while (misBlock < minMissingBlocks) {
+    size_t index;
+    if (pieceSelector_->select(index, misbitfield.get(), blocks)) {
+      pieces.push_back(checkOutPiece(index, cuid));
+      bitfield::flipBit(misbitfield.get(), blocks, index);
+      misBlock += pieces.back()->countMissingBlock();
     }
-    while (misBlock < minMissingBlocks) {
-      size_t index;
-      if (pieceSelector_->select(index, misbitfield.get(), blocks)) {
-        pieces.push_back(checkOutPiece(index, cuid));
-        bitfield::flipBit(misbitfield.get(), blocks, index);
-        misBlock += pieces.back()->countMissingBlock();
-      }
-      else {
-        break;
-      }
+    else {
+      break;
     }
   }
 }
@@ -273,8 +371,21 @@ void DefaultPieceStorage::getMissingPiece(
     std::vector<std::shared_ptr<Piece>>& pieces, size_t minMissingBlocks,
     const std::shared_ptr<Peer>& peer, cuid_t cuid)
 {
-  getMissingPiece(pieces, minMissingBlocks, peer->getBitfield(),
-                  peer->getBitfieldLength(), cuid);
+  const auto& peerBitfield = peer->getPeerBitfield();
+  if (isEndGame()) {
+    if (peerBitfield.countBlock() == bitfieldMan_->countBlock()) {
+      getMissingPieceOnEndGame(
+          pieces, minMissingBlocks,
+          [&peerBitfield](size_t index) {
+            return peerBitfield.isBitSet(index);
+          },
+          cuid);
+    }
+    return;
+  }
+  std::vector<unsigned char> buf;
+  getMissingPiece(pieces, minMissingBlocks, peerBitfield.getBitfield(buf),
+                  peerBitfield.getBitfieldLength(), cuid);
 }
 
 void DefaultPieceStorage::getMissingPiece(
@@ -282,9 +393,26 @@ void DefaultPieceStorage::getMissingPiece(
     const std::shared_ptr<Peer>& peer,
     const std::vector<size_t>& excludedIndexes, cuid_t cuid)
 {
+  const auto& peerBitfield = peer->getPeerBitfield();
+  if (isEndGame()) {
+    if (peerBitfield.countBlock() == bitfieldMan_->countBlock()) {
+      getMissingPieceOnEndGame(
+          pieces, minMissingBlocks,
+          [&peerBitfield, &excludedIndexes](size_t index) {
+            return peerBitfield.isBitSet(index) &&
+                   std::find(std::begin(excludedIndexes),
+                             std::end(excludedIndexes),
+                             index) == std::end(excludedIndexes);
+          },
+          cuid);
+    }
+    return;
+  }
   BitfieldMan tempBitfield(bitfieldMan_->getBlockLength(),
                            bitfieldMan_->getTotalLength());
-  tempBitfield.setBitfield(peer->getBitfield(), peer->getBitfieldLength());
+  std::vector<unsigned char> buf;
+  tempBitfield.setBitfield(peerBitfield.getBitfield(buf),
+                           peerBitfield.getBitfieldLength());
   unsetExcludedIndexes(tempBitfield, excludedIndexes);
   getMissingPiece(pieces, minMissingBlocks, tempBitfield.getBitfield(),
                   tempBitfield.getBitfieldLength(), cuid);
@@ -416,7 +544,15 @@ void DefaultPieceStorage::deleteUsedPiece(const std::shared_ptr<Piece>& piece)
   if (!piece) {
     return;
   }
-  usedPieces_.erase(piece);
+  auto index = piece->getIndex();
+  if (index < usedPieceSlots_.size() && usedPieceSlots_[index] != NO_SLOT) {
+    // Move the last piece to the vacant slot.
+    auto slot = usedPieceSlots_[index];
+    usedPieceSlots_[usedPieces_.back()->getIndex()] = slot;
+    usedPieceSlots_[index] = NO_SLOT;
+    std::swap(usedPieces_[slot], usedPieces_.back());
+    usedPieces_.pop_back();
+  }
   piece->releaseWrCache(wrDiskCache_);
 }
 
@@ -611,10 +747,15 @@ void DefaultPieceStorage::setupFileFilter()
     }
   }
   bitfieldMan_->enableFilter();
+  endGamePiecesValid_ = false;
 }
 
 // not unittested
-void DefaultPieceStorage::clearFileFilter() { bitfieldMan_->clearFilter(); }
+void DefaultPieceStorage::clearFileFilter()
+{
+  bitfieldMan_->clearFilter();
+  endGamePiecesValid_ = false;
+}
 
 // not unittested
 bool DefaultPieceStorage::downloadFinished()
@@ -665,6 +806,7 @@ void DefaultPieceStorage::setBitfield(const unsigned char* bitfield,
                                       size_t bitfieldLength)
 {
   bitfieldMan_->setBitfield(bitfield, bitfieldLength);
+  endGamePiecesValid_ = false;
   addPieceStats(bitfield, bitfieldLength);
 }
 
@@ -690,10 +832,9 @@ void DefaultPieceStorage::flushWrDiskCacheEntry()
   if (!wrDiskCache_) {
     return;
   }
-  // UsedPieceSet is sorted by piece index. It means we can flush
-  // cache by non-decreasing offset, which is good to reduce disk seek
-  // unless the file is heavily fragmented.
-  for (auto& piece : usedPieces_) {
+  // Flush cache by non-decreasing offset, which is good to reduce
+  // disk seek unless the file is heavily fragmented.
+  for (auto& piece : getSortedUsedPieces()) {
     auto ce = piece->getWrDiskCacheEntry();
     if (ce) {
       piece->flushWrCache(wrDiskCache_);
@@ -747,7 +888,11 @@ void DefaultPieceStorage::removeAdvertisedPiece(const Timer& expiry)
   haves_.erase(std::begin(haves_), it);
 }
 
-void DefaultPieceStorage::markAllPiecesDone() { bitfieldMan_->setAllBit(); }
+void DefaultPieceStorage::markAllPiecesDone()
+{
+  bitfieldMan_->setAllBit();
+  endGamePiecesValid_ = false;
+}
 
 void DefaultPieceStorage::markPiecesDone(int64_t length)
 {
@@ -758,6 +903,7 @@ void DefaultPieceStorage::markPiecesDone(int64_t length)
     // TODO this would go to markAllPiecesUndone()
     bitfieldMan_->clearAllBit();
     usedPieces_.clear();
+    std::fill(std::begin(usedPieceSlots_), std::end(usedPieceSlots_), NO_SLOT);
   }
   else {
     size_t numPiece = length / bitfieldMan_->getBlockLength();
@@ -778,17 +924,21 @@ void DefaultPieceStorage::markPiecesDone(int64_t length)
       addUsedPiece(p);
     }
   }
+  endGamePiecesValid_ = false;
 }
 
 void DefaultPieceStorage::markPieceMissing(size_t index)
 {
   bitfieldMan_->unsetBit(index);
+  endGamePiecesValid_ = false;
 }
 
 void DefaultPieceStorage::addInFlightPiece(
     const std::vector<std::shared_ptr<Piece>>& pieces)
 {
-  usedPieces_.insert(pieces.begin(), pieces.end());
+  for (auto& piece : pieces) {
+    addUsedPiece(piece);
+  }
 }
 
 size_t DefaultPieceStorage::countInFlightPiece() { return usedPieces_.size(); }
@@ -796,7 +946,8 @@ size_t DefaultPieceStorage::countInFlightPiece() { return usedPieces_.size(); }
 void DefaultPieceStorage::getInFlightPieces(
     std::vector<std::shared_ptr<Piece>>& pieces)
 {
-  pieces.insert(pieces.end(), usedPieces_.begin(), usedPieces_.end());
+  auto sorted = getSortedUsedPieces();
+  pieces.insert(std::end(pieces), std::begin(sorted), std::end(sorted));
 }
 
 void DefaultPieceStorage::setDiskWriterFactory(
@@ -817,6 +968,16 @@ void DefaultPieceStorage::subtractPieceStats(const unsigned char* bitfield,
   pieceStatMan_->subtractPieceStats(bitfield, bitfieldLength);
 }
 
+void DefaultPieceStorage::addPieceStats(const PeerBitfield& bitfield)
+{
+  pieceStatMan_->addPieceStats(bitfield);
+}
+
+void DefaultPieceStorage::subtractPieceStats(const PeerBitfield& bitfield)
+{
+  pieceStatMan_->subtractPieceStats(bitfield);
+}
+
 void DefaultPieceStorage::updatePieceStats(const unsigned char* newBitfield,
                                            size_t newBitfieldLength,
                                            const unsigned char* oldBitfield)
@@ -38,7 +38,7 @@
 #include "PieceStorage.h"
 
 #include <deque>
-#include <set>
+#include <vector>
 
 #include "a2functional.h"
 
@@ -76,12 +76,23 @@ private:
   std::unique_ptr<BitfieldMan> bitfieldMan_;
   std::shared_ptr<DiskAdaptor> diskAdaptor_;
   std::shared_ptr<DiskWriterFactory> diskWriterFactory_;
-  typedef std::set<std::shared_ptr<Piece>, DerefLess<std::shared_ptr<Piece>>>
-      UsedPieceSet;
-  UsedPieceSet usedPieces_;
+  // In-flight pieces in no particular order.
+  std::vector<std::shared_ptr<Piece>> usedPieces_;
+  // usedPieceSlots_[i] is the position of the in-flight piece of
+  // index i in usedPieces_, or NO_SLOT if piece i is not in-flight.
+  // Looking up an in-flight piece by index is O(1) and allocation
+  // free.
+  std::vector<uint32_t> usedPieceSlots_;
 
   bool endGame_;
   size_t endGamePieceNum_;
+  // Indexes of missing pieces in end game mode, in no particular
+  // order.  Completed pieces are removed lazily when they are
+  // encountered.
+  std::vector<size_t> endGamePieces_;
+  // false if endGamePieces_ has to be rebuilt because the set of
+  // missing pieces may have changed other than by completion.
+  bool endGamePiecesValid_;
   const Option* option_;
 
   // The next unique index on HaveEntry, which is ever strictly
@@ -102,6 +113,16 @@ private:
 
   void createFastIndexBitfield(BitfieldMan& bitfield,
                                const std::shared_ptr<Peer>& peer);
+
+  void buildEndGamePieces();
+
+  // Checks out pieces in end game mode, trying endGamePieces_ in
+  // random order.  Pieces for which isCandidate returns false are
+  // skipped.
+  template <typename Pred>
+  void getMissingPieceOnEndGame(std::vector<std::shared_ptr<Piece>>& pieces,
+                                size_t minMissingBlocks, Pred isCandidate,
+                                cuid_t cuid);
 #endif // ENABLE_BITTORRENT
 
   std::shared_ptr<Piece> checkOutPiece(size_t index, cuid_t cuid);
@@ -109,6 +130,8 @@ private:
   //   void reduceUsedPieces(size_t upperBound);
   void deleteUsedPiece(const std::shared_ptr<Piece>& piece);
   std::shared_ptr<Piece> findUsedPiece(size_t index) const;
+  // Returns in-flight pieces sorted by index.
+  std::vector<std::shared_ptr<Piece>> getSortedUsedPieces() const;
 
   // Returns the sum of completed length of in-flight pieces
   int64_t getInFlightPieceCompletedLength() const;
@@ -269,6 +292,10 @@ public:
   virtual void subtractPieceStats(const unsigned char* bitfield,
                                   size_t bitfieldLength) CXX11_OVERRIDE;
 
+  virtual void addPieceStats(const PeerBitfield& bitfield) CXX11_OVERRIDE;
+
+  virtual void subtractPieceStats(const PeerBitfield& bitfield) CXX11_OVERRIDE;
+
   virtual void
   updatePieceStats(const unsigned char* newBitfield, size_t newBitfieldLength,
                    const unsigned char* oldBitfield) CXX11_OVERRIDE;
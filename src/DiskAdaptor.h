@@ -121,10 +121,13 @@ public:
 
   int getFileAllocationMethod() const { return fileAllocationMethod_; }
 
-  // Closes at most |numClose| files if possible. This method is used to
-  // ensure that global number of open file stays under certain limit.
-  // Returns the number of closed files.
-  virtual size_t tryCloseFile(size_t numClose) { return 0; }
+  // Notifies that |len| bytes starting at |goff| are held in the
+  // write cache and are going to be written by writeCache() later.
+  virtual void addPendingCacheData(int64_t goff, size_t len) {}
+
+  // Notifies that |len| bytes starting at |goff| previously given to
+  // addPendingCacheData() were written or discarded.
+  virtual void removePendingCacheData(int64_t goff, size_t len) {}
 
   void
   setOpenedFileCounter(std::shared_ptr<OpenedFileCounter> openedFileCounter)
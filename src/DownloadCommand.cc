@@ -147,7 +147,20 @@ bool DownloadCommand::executeInternal()
       getPieceStorage()->getDiskAdaptor();
   std::shared_ptr<Segment> segment = getSegments().front();
   bool eof = false;
-  if (getSocketRecvBuffer()->bufferEmpty()) {
+  size_t directLength = 0;
+  if (sinkFilterOnly_ && getSocketRecvBuffer()->bufferEmpty() &&
+      segment->getPiece()->getWrDiskCacheEntry()) {
+    directLength = getSinkWriteLength(segment, SocketRecvBuffer::MAX_CAPACITY);
+  }
+  if (directLength > 0) {
+    // Read data straight into the write cache.  Since we never read
+    // beyond the segment, this is safe with HTTP pipelining as well.
+    size_t n = receiveToWrCache(segment, directLength);
+    eof = n == 0 && !getSocket()->wantRead() && !getSocket()->wantWrite();
+    peerStat_->updateDownload(n);
+    getDownloadContext()->updateDownload(n);
+  }
+  else if (getSocketRecvBuffer()->bufferEmpty()) {
     // Only read from socket when buffer is empty.  Imagine that When
     // segment length is *short* and we are using HTTP pilelining.  We
     // issued 2 requests in pipeline. When reading first response
@@ -160,26 +173,11 @@ bool DownloadCommand::executeInternal()
     eof = getSocketRecvBuffer()->recv() == 0 && !getSocket()->wantRead() &&
           !getSocket()->wantWrite();
   }
-  if (!eof) {
+  if (!eof && directLength == 0) {
     size_t bufSize;
     if (sinkFilterOnly_) {
-      if (segment->getLength() > 0) {
-        if (segment->getPosition() + segment->getLength() <=
-            getFileEntry()->getLastOffset()) {
-          bufSize = std::min(static_cast<size_t>(segment->getLength() -
-                                                 segment->getWrittenLength()),
-                             getSocketRecvBuffer()->getBufferLength());
-        }
-        else {
-          bufSize =
-              std::min(static_cast<size_t>(getFileEntry()->getLastOffset() -
-                                           segment->getPositionToWrite()),
-                       getSocketRecvBuffer()->getBufferLength());
-        }
-      }
-      else {
-        bufSize = getSocketRecvBuffer()->getBufferLength();
-      }
+      bufSize = getSinkWriteLength(segment,
+                                   getSocketRecvBuffer()->getBufferLength());
       streamFilter_->transform(diskAdaptor, segment,
                                getSocketRecvBuffer()->getBuffer(), bufSize);
     }
@@ -242,7 +240,7 @@ bool DownloadCommand::executeInternal()
       A2_LOG_INFO(fmt(MSG_SEGMENT_DOWNLOAD_COMPLETED, getCuid()));
 
       {
-        const std::string& expectedPieceHash =
+        std::string expectedPieceHash =
             getDownloadContext()->getPieceHash(segment->getIndex());
         if (pieceHashValidationEnabled_ && !expectedPieceHash.empty()) {
           if (
@@ -400,6 +398,66 @@ void DownloadCommand::validatePieceHash(const std::shared_ptr<Segment>& segment,
   }
 }
 
+size_t
+DownloadCommand::getSinkWriteLength(const std::shared_ptr<Segment>& segment,
+                                    size_t len) const
+{
+  if (segment->getLength() == 0) {
+    return len;
+  }
+  if (segment->getPosition() + segment->getLength() <=
+      getFileEntry()->getLastOffset()) {
+    return std::min(static_cast<size_t>(segment->getLength() -
+                                        segment->getWrittenLength()),
+                    len);
+  }
+  return std::min(static_cast<size_t>(getFileEntry()->getLastOffset() -
+                                      segment->getPositionToWrite()),
+                  len);
+}
+
+size_t
+DownloadCommand::receiveToWrCache(const std::shared_ptr<Segment>& segment,
+                                  size_t maxlen)
+{
+  auto wrDiskCache = getPieceStorage()->getWrDiskCache();
+  const auto& piece = segment->getPiece();
+  int64_t goff = segment->getPositionToWrite();
+  size_t len;
+  auto buf = piece->getWrCacheAppendBuffer(goff, len);
+  std::unique_ptr<unsigned char[]> data;
+  size_t capacity = 0;
+  if (buf && len > 0) {
+    len = std::min(len, maxlen);
+  }
+  else {
+    // The cache does not count the unused space of the cell, so the
+    // cell is kept small.  Later reads fill it up through the append
+    // buffer above.
+    capacity = std::min(maxlen, WrDiskCacheEntry::MAX_CELL_SLACK);
+    data.reset(new unsigned char[capacity]);
+    buf = data.get();
+    len = capacity;
+  }
+  len = getSocketRecvBuffer()->recv(buf, len);
+  if (len == 0) {
+    return 0;
+  }
+  // Update hash before handing the data to the cache, since the
+  // cache may be flushed and freed in WrDiskCache::update().
+  if (pieceHashValidationEnabled_) {
+    segment->updateHash(segment->getWrittenLength(), buf, len);
+  }
+  if (data) {
+    piece->updateWrCache(wrDiskCache, data.release(), 0, len, capacity, goff);
+  }
+  else {
+    piece->commitWrCacheAppend(wrDiskCache, len);
+  }
+  segment->updateWrittenLength(len);
+  return len;
+}
+
 void DownloadCommand::completeSegment(cuid_t cuid,
                                       const std::shared_ptr<Segment>& segment)
 {
@@ -69,6 +69,18 @@ private:
 
   void completeSegment(cuid_t cuid, const std::shared_ptr<Segment>& segment);
 
+  // Returns the number of bytes which can be written to |segment|
+  // when only SinkStreamFilter is used, capped by |len|.
+  size_t getSinkWriteLength(const std::shared_ptr<Segment>& segment,
+                            size_t len) const;
+
+  // Reads at most |maxlen| bytes from socket directly into the write
+  // cache of |segment|, and returns the number of bytes read.  Only
+  // used when only SinkStreamFilter is used and the receive buffer is
+  // empty.
+  size_t receiveToWrCache(const std::shared_ptr<Segment>& segment,
+                          size_t maxlen);
+
 protected:
   virtual bool executeInternal() CXX11_OVERRIDE;
 
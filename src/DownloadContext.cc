@@ -70,6 +70,7 @@ DownloadContext::DownloadContext(int32_t pieceLength, int64_t totalLength,
 {
   fileEntries_.push_back(
       std::make_shared<FileEntry>(std::move(path), totalLength, 0));
+  resetFileOffsetIndex();
 }
 
 DownloadContext::~DownloadContext() = default;
@@ -92,6 +93,11 @@ Timer::Clock::duration DownloadContext::calculateSessionTime() const
   return startTime.difference(downloadStopTime_);
 }
 
+void DownloadContext::resetFileOffsetIndex()
+{
+  fileOffsetIndex_.reset(std::begin(fileEntries_), std::end(fileEntries_));
+}
+
 std::shared_ptr<FileEntry>
 DownloadContext::findFileEntryByOffset(int64_t offset) const
 {
@@ -100,16 +106,11 @@ DownloadContext::findFileEntryByOffset(int64_t offset) const
     return nullptr;
   }
 
-  auto obj = std::make_shared<FileEntry>();
-  obj->setOffset(offset);
-  auto i = std::upper_bound(fileEntries_.begin(), fileEntries_.end(), obj,
-                            DerefLess<std::shared_ptr<FileEntry>>());
-  if (i != fileEntries_.end() && (*i)->getOffset() == offset) {
-    return *i;
-  }
-  else {
-    return *(--i);
+  auto i = fileOffsetIndex_.find(offset);
+  if (i == FileOffsetIndex::npos) {
+    return nullptr;
   }
+  return fileEntries_[i];
 }
 
 void DownloadContext::setFilePathWithIndex(size_t index,
@@ -262,18 +263,28 @@ bool DownloadContext::isChecksumVerificationAvailable() const
 
 bool DownloadContext::isPieceHashVerificationAvailable() const
 {
-  return !pieceHashType_.empty() && pieceHashes_.size() > 0 &&
-         pieceHashes_.size() == getNumPieces();
+  return !pieceHashType_.empty() && countPieceHash() > 0 &&
+         countPieceHash() == getNumPieces();
 }
 
-const std::string& DownloadContext::getPieceHash(size_t index) const
+std::string DownloadContext::getPieceHash(size_t index) const
 {
-  if (index < pieceHashes_.size()) {
-    return pieceHashes_[index];
-  }
-  else {
-    return A2STR::NIL;
-  }
+  return pieceHashes_.get(index);
+}
+
+bool DownloadContext::pieceHashEquals(size_t index,
+                                      const std::string& digest) const
+{
+  return pieceHashes_.equals(index, digest);
+}
+
+size_t DownloadContext::countPieceHash() const { return pieceHashes_.size(); }
+
+void DownloadContext::setPieceHashes(const std::string& hashType,
+                                     PieceHashes pieceHashes)
+{
+  pieceHashType_ = hashType;
+  pieceHashes_ = std::move(pieceHashes);
 }
 
 void DownloadContext::setDigest(const std::string& hashType,
@@ -48,6 +48,8 @@
 #include "SegList.h"
 #include "ContextAttribute.h"
 #include "NetStat.h"
+#include "FileOffsetIndex.h"
+#include "PieceHashes.h"
 
 namespace aria2 {
 
@@ -65,7 +67,10 @@ private:
 
   std::vector<std::shared_ptr<FileEntry>> fileEntries_;
 
-  std::vector<std::string> pieceHashes_;
+  // Offsets of fileEntries_, used by findFileEntryByOffset().
+  FileOffsetIndex fileOffsetIndex_;
+
+  PieceHashes pieceHashes_;
 
   NetStat netStat_;
 
@@ -89,6 +94,8 @@ private:
   // (including both Metalink XML and Metalink/HTTP) twice.
   bool acceptMetalink_;
 
+  void resetFileOffsetIndex();
+
 public:
   DownloadContext();
 
@@ -99,19 +106,27 @@ public:
 
   ~DownloadContext();
 
-  const std::string& getPieceHash(size_t index) const;
+  // Returns the hash of piece |index|.  If it is not available,
+  // returns empty string.
+  std::string getPieceHash(size_t index) const;
 
-  const std::vector<std::string>& getPieceHashes() const
-  {
-    return pieceHashes_;
-  }
+  // Returns true if the hash of piece |index| is available and equals
+  // to |digest|.  Unlike getPieceHash(), this does not make a copy of
+  // hash.
+  bool pieceHashEquals(size_t index, const std::string& digest) const;
+
+  size_t countPieceHash() const;
+
+  // Sets piece hashes of type |hashType|.
+  void setPieceHashes(const std::string& hashType, PieceHashes pieceHashes);
 
+  // Sets piece hashes in range [first, last) of strings.  All hashes
+  // must have the same length.  Otherwise, piece hashes are cleared.
   template <typename InputIterator>
   void setPieceHashes(const std::string& hashType, InputIterator first,
                       InputIterator last)
   {
-    pieceHashType_ = hashType;
-    pieceHashes_.assign(first, last);
+    setPieceHashes(hashType, PieceHashes(first, last));
   }
 
   int64_t getTotalLength() const;
@@ -144,6 +159,7 @@ public:
   void setFileEntries(InputIterator first, InputIterator last)
   {
     fileEntries_.assign(first, last);
+    resetFileOffsetIndex();
   }
 
   int32_t getPieceLength() const { return pieceLength_; }
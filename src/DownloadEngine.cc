@@ -50,6 +50,7 @@
 #include "LogFactory.h"
 #include "Logger.h"
 #include "SocketCore.h"
+#include "SocketPool.h"
 #include "util.h"
 #include "a2functional.h"
 #include "DlAbortEx.h"
@@ -92,11 +93,14 @@ volatile sig_atomic_t globalHaltRequested = 0;
 
 namespace {
 constexpr auto DEFAULT_REFRESH_INTERVAL = 1_s;
+// The maximum number of idle connections pooled per endpoint.
+constexpr size_t MAX_IDLE_SOCKET_PER_ENDPOINT = 64;
 } // namespace
 
 DownloadEngine::DownloadEngine(std::unique_ptr<EventPoll> eventPoll)
     : eventPoll_(std::move(eventPoll)),
       haltRequested_(0),
+      socketPool_(make_unique<SocketPool>(MAX_IDLE_SOCKET_PER_ENDPOINT)),
       noWait_(true),
       refreshInterval_(DEFAULT_REFRESH_INTERVAL),
       lastRefresh_(Timer::zero()),
@@ -247,6 +251,8 @@ void DownloadEngine::onEndOfRun()
   requestGroupMan_->removeStoppedGroup(this);
   requestGroupMan_->closeFile();
   requestGroupMan_->save();
+  A2_LOG_INFO(fmt("SocketPool: %" PRIu64 " hits, %" PRIu64 " misses",
+                  socketPool_->getNumHits(), socketPool_->getNumMisses()));
 }
 
 void DownloadEngine::afterEachIteration()
@@ -309,50 +315,15 @@ void DownloadEngine::addRoutineCommand(std::unique_ptr<Command> command)
   routineCommands_.push_back(std::move(command));
 }
 
-void DownloadEngine::poolSocket(const std::string& key,
-                                const SocketPoolEntry& entry)
-{
-  A2_LOG_INFO(fmt("Pool socket for %s", key.c_str()));
-  std::multimap<std::string, SocketPoolEntry>::value_type p(key, entry);
-  socketPool_.insert(p);
-}
-
 void DownloadEngine::evictSocketPool()
 {
-  if (socketPool_.empty()) {
-    return;
-  }
-
-  std::multimap<std::string, SocketPoolEntry> newPool;
-  A2_LOG_DEBUG("Scanning SocketPool and erasing timed out entry.");
-  for (auto& elem : socketPool_) {
-    if (!elem.second.isTimeout()) {
-      newPool.insert(elem);
-    }
-  }
-  A2_LOG_DEBUG(
-      fmt("%lu entries removed.",
-          static_cast<unsigned long>(socketPool_.size() - newPool.size())));
-  socketPool_ = std::move(newPool);
-}
-
-namespace {
-std::string createSockPoolKey(const std::string& host, uint16_t port,
-                              const std::string& username,
-                              const std::string& proxyhost, uint16_t proxyport)
-{
-  std::string key;
-  if (!username.empty()) {
-    key += util::percentEncode(username);
-    key += "@";
-  }
-  key += fmt("%s(%u)", host.c_str(), port);
-  if (!proxyhost.empty()) {
-    key += fmt("/%s(%u)", proxyhost.c_str(), proxyport);
-  }
-  return key;
+  socketPool_->evict();
+  A2_LOG_DEBUG(fmt("SocketPool: %lu idle, %" PRIu64 " hits, %" PRIu64
+                   " misses, %" PRIu64 " dropped",
+                   static_cast<unsigned long>(socketPool_->size()),
+                   socketPool_->getNumHits(), socketPool_->getNumMisses(),
+                   socketPool_->getNumDropped()));
 }
-} // namespace
 
 void DownloadEngine::poolSocket(const std::string& ipaddr, uint16_t port,
                                 const std::string& username,
@@ -362,9 +333,9 @@ void DownloadEngine::poolSocket(const std::string& ipaddr, uint16_t port,
                                 const std::string& options,
                                 std::chrono::seconds timeout)
 {
-  SocketPoolEntry e(sock, options, std::move(timeout));
-  poolSocket(createSockPoolKey(ipaddr, port, username, proxyhost, proxyport),
-             e);
+  socketPool_->push(
+      SocketPool::Key(ipaddr, port, username, proxyhost, proxyport), sock,
+      options, std::move(timeout));
 }
 
 void DownloadEngine::poolSocket(const std::string& ipaddr, uint16_t port,
@@ -373,9 +344,9 @@ void DownloadEngine::poolSocket(const std::string& ipaddr, uint16_t port,
                                 const std::shared_ptr<SocketCore>& sock,
                                 std::chrono::seconds timeout)
 {
-  SocketPoolEntry e(sock, std::move(timeout));
-  poolSocket(createSockPoolKey(ipaddr, port, A2STR::NIL, proxyhost, proxyport),
-             e);
+  socketPool_->push(
+      SocketPool::Key(ipaddr, port, A2STR::NIL, proxyhost, proxyport), sock,
+      A2STR::NIL, std::move(timeout));
 }
 
 namespace {
@@ -435,37 +406,14 @@ void DownloadEngine::poolSocket(const std::shared_ptr<Request>& request,
   }
 }
 
-std::multimap<std::string, DownloadEngine::SocketPoolEntry>::iterator
-DownloadEngine::findSocketPoolEntry(const std::string& key)
-{
-  std::pair<std::multimap<std::string, SocketPoolEntry>::iterator,
-            std::multimap<std::string, SocketPoolEntry>::iterator>
-      range = socketPool_.equal_range(key);
-  for (auto i = range.first, eoi = range.second; i != eoi; ++i) {
-    const SocketPoolEntry& e = (*i).second;
-    // We assume that if socket is readable it means peer shutdowns
-    // connection and the socket will receive EOF. So skip it.
-    if (!e.isTimeout() && !e.getSocket()->isReadable(0)) {
-      A2_LOG_INFO(fmt("Found socket for %s", key.c_str()));
-      return i;
-    }
-  }
-  return socketPool_.end();
-}
-
 std::shared_ptr<SocketCore>
 DownloadEngine::popPooledSocket(const std::string& ipaddr, uint16_t port,
                                 const std::string& proxyhost,
                                 uint16_t proxyport)
 {
-  std::shared_ptr<SocketCore> s;
-  auto i = findSocketPoolEntry(
-      createSockPoolKey(ipaddr, port, A2STR::NIL, proxyhost, proxyport));
-  if (i != socketPool_.end()) {
-    s = (*i).second.getSocket();
-    socketPool_.erase(i);
-  }
-  return s;
+  std::string options;
+  return socketPool_->pop(
+      options, SocketPool::Key(ipaddr, port, A2STR::NIL, proxyhost, proxyport));
 }
 
 std::shared_ptr<SocketCore>
@@ -474,15 +422,8 @@ DownloadEngine::popPooledSocket(std::string& options, const std::string& ipaddr,
                                 const std::string& proxyhost,
                                 uint16_t proxyport)
 {
-  std::shared_ptr<SocketCore> s;
-  auto i = findSocketPoolEntry(
-      createSockPoolKey(ipaddr, port, username, proxyhost, proxyport));
-  if (i != socketPool_.end()) {
-    s = (*i).second.getSocket();
-    options = (*i).second.getOptions();
-    socketPool_.erase(i);
-  }
-  return s;
+  return socketPool_->pop(
+      options, SocketPool::Key(ipaddr, port, username, proxyhost, proxyport));
 }
 
 std::shared_ptr<SocketCore>
@@ -514,26 +455,6 @@ DownloadEngine::popPooledSocket(std::string& options,
   return s;
 }
 
-DownloadEngine::SocketPoolEntry::SocketPoolEntry(
-    const std::shared_ptr<SocketCore>& socket, const std::string& options,
-    std::chrono::seconds timeout)
-    : socket_(socket), options_(options), timeout_(std::move(timeout))
-{
-}
-
-DownloadEngine::SocketPoolEntry::SocketPoolEntry(
-    const std::shared_ptr<SocketCore>& socket, std::chrono::seconds timeout)
-    : socket_(socket), timeout_(std::move(timeout))
-{
-}
-
-DownloadEngine::SocketPoolEntry::~SocketPoolEntry() = default;
-
-bool DownloadEngine::SocketPoolEntry::isTimeout() const
-{
-  return registeredTime_.difference(global::wallclock()) >= timeout_;
-}
-
 cuid_t DownloadEngine::newCUID() { return cuidCounter_.newID(); }
 
 const std::string&
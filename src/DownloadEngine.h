@@ -39,7 +39,6 @@
 
 #include <string>
 #include <deque>
-#include <map>
 #include <vector>
 #include <memory>
 
@@ -60,6 +59,7 @@ class Option;
 class RequestGroupMan;
 class StatCalc;
 class SocketCore;
+class SocketPool;
 class CookieStorage;
 class AuthConfigFactory;
 class Request;
@@ -93,34 +93,7 @@ private:
 
   int haltRequested_;
 
-  class SocketPoolEntry {
-  private:
-    std::shared_ptr<SocketCore> socket_;
-    // protocol specific option string
-    std::string options_;
-
-    std::chrono::seconds timeout_;
-
-    Timer registeredTime_;
-
-  public:
-    SocketPoolEntry(const std::shared_ptr<SocketCore>& socket,
-                    const std::string& option, std::chrono::seconds timeout);
-
-    SocketPoolEntry(const std::shared_ptr<SocketCore>& socket,
-                    std::chrono::seconds timeout);
-
-    ~SocketPoolEntry();
-
-    bool isTimeout() const;
-
-    const std::shared_ptr<SocketCore>& getSocket() const { return socket_; }
-
-    const std::string& getOptions() const { return options_; }
-  };
-
-  // key = IP address:port, value = SocketPoolEntry
-  std::multimap<std::string, SocketPoolEntry> socketPool_;
+  std::unique_ptr<SocketPool> socketPool_;
 
   Timer lastSocketPoolScan_;
 
@@ -158,11 +131,6 @@ private:
 
   void afterEachIteration();
 
-  void poolSocket(const std::string& key, const SocketPoolEntry& entry);
-
-  std::multimap<std::string, SocketPoolEntry>::iterator
-  findSocketPoolEntry(const std::string& key);
-
   std::unique_ptr<RequestGroupMan> requestGroupMan_;
   std::unique_ptr<FileAllocationMan> fileAllocationMan_;
   std::unique_ptr<CheckIntegrityMan> checkIntegrityMan_;
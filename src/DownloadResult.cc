@@ -33,7 +33,12 @@
  */
 /* copyright --> */
 #include "DownloadResult.h"
+
+#include <algorithm>
+#include <unordered_map>
+
 #include "FileEntry.h"
+#include "A2STR.h"
 #include "Option.h"
 #include "MetadataInfo.h"
 
@@ -56,4 +61,259 @@ DownloadResult::DownloadResult()
 
 DownloadResult::~DownloadResult() = default;
 
+namespace {
+void putNum(std::string& buf, uint64_t n)
+{
+  for (; n >= 0x80u; n >>= 7) {
+    buf += static_cast<char>((n & 0x7fu) | 0x80u);
+  }
+  buf += static_cast<char>(n);
+}
+} // namespace
+
+namespace {
+uint64_t getNum(const unsigned char*& p)
+{
+  uint64_t n = 0;
+  for (int shift = 0;; shift += 7) {
+    uint64_t c = *p++;
+    n |= (c & 0x7fu) << shift;
+    if (c < 0x80u) {
+      return n;
+    }
+  }
+}
+} // namespace
+
+namespace {
+enum {
+  FILE_REQUESTED = 1,
+  // The offset is stored because it is not the end of the previous
+  // file.
+  FILE_OFFSET = 1 << 1
+};
+} // namespace
+
+// The files are encoded as below.  All numbers are unsigned base 128
+// varints.
+//
+//   the number of files, the number of strings
+//   for each string: the length of the prefix shared with the
+//     previous string, the length of the rest, the rest
+//   for each file: flags, offset (only if FILE_OFFSET is set),
+//     length, the index of path, the number of spent URIs, their
+//     indexes, the number of remaining URIs, their indexes
+void DownloadResult::setFileEntries(
+    const std::vector<std::shared_ptr<FileEntry>>& fileEntries)
+{
+  files_.clear();
+  if (fileEntries.empty()) {
+    files_.shrink_to_fit();
+    return;
+  }
+  std::unordered_map<std::string, size_t> stringIndex;
+  std::vector<const std::string*> strings;
+  std::vector<size_t> refs;
+  auto intern = [&](const std::string& s) {
+    auto rv = stringIndex.insert(std::make_pair(s, strings.size()));
+    if (rv.second) {
+      strings.push_back(&(*rv.first).first);
+    }
+    refs.push_back((*rv.first).second);
+  };
+  // FileEntry is read through const reference, so that files without
+  // URIs, such as those of BitTorrent downloads, do not allocate URI
+  // state here.
+  for (auto& p : fileEntries) {
+    const FileEntry& fe = *p;
+    intern(fe.getPath());
+    for (auto& uri : fe.getSpentUris()) {
+      intern(uri);
+    }
+    for (auto& uri : fe.getRemainingUris()) {
+      intern(uri);
+    }
+  }
+  std::string buf;
+  putNum(buf, fileEntries.size());
+  putNum(buf, strings.size());
+  const std::string* prev = &A2STR::NIL;
+  for (auto s : strings) {
+    size_t len = std::min(prev->size(), s->size());
+    size_t prefix = 0;
+    while (prefix < len && (*prev)[prefix] == (*s)[prefix]) {
+      ++prefix;
+    }
+    putNum(buf, prefix);
+    putNum(buf, s->size() - prefix);
+    buf.append(*s, prefix, std::string::npos);
+    prev = s;
+  }
+  auto ref = std::begin(refs);
+  int64_t offset = 0;
+  for (auto& p : fileEntries) {
+    const FileEntry& fe = *p;
+    int flags = 0;
+    if (fe.isRequested()) {
+      flags |= FILE_REQUESTED;
+    }
+    if (fe.getOffset() != offset) {
+      flags |= FILE_OFFSET;
+    }
+    putNum(buf, flags);
+    if (flags & FILE_OFFSET) {
+      putNum(buf, fe.getOffset());
+    }
+    putNum(buf, fe.getLength());
+    putNum(buf, *ref++);
+    size_t numSpent = fe.getSpentUris().size();
+    putNum(buf, numSpent);
+    for (size_t i = 0; i < numSpent; ++i) {
+      putNum(buf, *ref++);
+    }
+    size_t numRemaining = fe.getRemainingUris().size();
+    putNum(buf, numRemaining);
+    for (size_t i = 0; i < numRemaining; ++i) {
+      putNum(buf, *ref++);
+    }
+    offset = fe.getOffset() + fe.getLength();
+  }
+  files_ = std::move(buf);
+  files_.shrink_to_fit();
+}
+
+std::vector<std::shared_ptr<FileEntry>> DownloadResult::getFileEntries() const
+{
+  std::vector<std::shared_ptr<FileEntry>> res;
+  if (files_.empty()) {
+    return res;
+  }
+  auto p = reinterpret_cast<const unsigned char*>(files_.data());
+  size_t numFiles = getNum(p);
+  size_t numStrings = getNum(p);
+  std::vector<std::string> strings;
+  strings.reserve(numStrings);
+  for (size_t i = 0; i < numStrings; ++i) {
+    size_t prefix = getNum(p);
+    size_t len = getNum(p);
+    std::string s;
+    if (prefix > 0) {
+      s.assign(strings.back(), 0, prefix);
+    }
+    s.append(reinterpret_cast<const char*>(p), len);
+    p += len;
+    strings.push_back(std::move(s));
+  }
+  res.reserve(numFiles);
+  int64_t offset = 0;
+  for (size_t i = 0; i < numFiles; ++i) {
+    int flags = getNum(p);
+    if (flags & FILE_OFFSET) {
+      offset = getNum(p);
+    }
+    int64_t length = getNum(p);
+    auto fe = std::make_shared<FileEntry>(strings[getNum(p)], length, offset);
+    fe->setRequested(flags & FILE_REQUESTED);
+    for (size_t n = getNum(p); n > 0; --n) {
+      fe->getSpentUris().push_back(strings[getNum(p)]);
+    }
+    for (size_t n = getNum(p); n > 0; --n) {
+      fe->getRemainingUris().push_back(strings[getNum(p)]);
+    }
+    offset += length;
+    res.push_back(std::move(fe));
+  }
+  return res;
+}
+
+namespace {
+// Decodes the |i|-th string of the pool.  |strings| holds the start of
+// each encoded string.  Since a string shares its prefix with the
+// previous one, decoding starts from the nearest string which shares
+// nothing.
+std::string decodeString(const std::vector<const unsigned char*>& strings,
+                         size_t i)
+{
+  size_t first = i;
+  for (;; --first) {
+    auto p = strings[first];
+    if (getNum(p) == 0) {
+      break;
+    }
+  }
+  std::string s;
+  for (; first <= i; ++first) {
+    auto p = strings[first];
+    size_t prefix = getNum(p);
+    size_t len = getNum(p);
+    s.resize(prefix);
+    s.append(reinterpret_cast<const char*>(p), len);
+  }
+  return s;
+}
+} // namespace
+
+std::shared_ptr<FileEntry> DownloadResult::getFileEntry(size_t index) const
+{
+  if (files_.empty()) {
+    return nullptr;
+  }
+  auto p = reinterpret_cast<const unsigned char*>(files_.data());
+  size_t numFiles = getNum(p);
+  if (index >= numFiles) {
+    return nullptr;
+  }
+  size_t numStrings = getNum(p);
+  std::vector<const unsigned char*> strings;
+  strings.reserve(numStrings);
+  for (size_t i = 0; i < numStrings; ++i) {
+    strings.push_back(p);
+    getNum(p);
+    size_t len = getNum(p);
+    p += len;
+  }
+  int64_t offset = 0;
+  for (size_t i = 0;; ++i) {
+    int flags = getNum(p);
+    if (flags & FILE_OFFSET) {
+      offset = getNum(p);
+    }
+    int64_t length = getNum(p);
+    if (i == index) {
+      auto fe = std::make_shared<FileEntry>(decodeString(strings, getNum(p)),
+                                            length, offset);
+      fe->setRequested(flags & FILE_REQUESTED);
+      for (size_t n = getNum(p); n > 0; --n) {
+        fe->getSpentUris().push_back(decodeString(strings, getNum(p)));
+      }
+      for (size_t n = getNum(p); n > 0; --n) {
+        fe->getRemainingUris().push_back(decodeString(strings, getNum(p)));
+      }
+      return fe;
+    }
+    // Skip the path and URIs.
+    getNum(p);
+    for (size_t j = 0; j < 2; ++j) {
+      for (size_t n = getNum(p); n > 0; --n) {
+        getNum(p);
+      }
+    }
+    offset += length;
+  }
+}
+
+size_t DownloadResult::countFileEntry() const
+{
+  if (files_.empty()) {
+    return 0;
+  }
+  auto p = reinterpret_cast<const unsigned char*>(files_.data());
+  return getNum(p);
+}
+
+size_t DownloadResult::getFileEntryMemoryUsage() const
+{
+  return files_.size();
+}
+
 } // namespace aria2
@@ -76,8 +76,6 @@ struct DownloadResult {
 
   std::vector<std::shared_ptr<ContextAttribute>> attrs;
 
-  std::vector<std::shared_ptr<FileEntry>> fileEntries;
-
   // This field contains GIDs. See comment in
   // RequestGroup.cc::followedByGIDs_.
   std::vector<a2_gid_t> followedBy;
@@ -107,6 +105,29 @@ struct DownloadResult {
   // Don't allow copying
   DownloadResult(const DownloadResult& c) = delete;
   DownloadResult& operator=(const DownloadResult& c) = delete;
+
+  // Stores |fileEntries| in a compact encoding held in a single
+  // buffer.  Paths and URIs are pooled, and the FileEntry objects are
+  // not retained.
+  void
+  setFileEntries(const std::vector<std::shared_ptr<FileEntry>>& fileEntries);
+
+  // Decodes the files stored by setFileEntries().  The returned
+  // objects carry the path, length, offset, selection and URIs of
+  // each file.
+  std::vector<std::shared_ptr<FileEntry>> getFileEntries() const;
+
+  // Decodes the |index|-th file stored by setFileEntries() without
+  // decoding the others.  Returns nullptr if there is no such file.
+  std::shared_ptr<FileEntry> getFileEntry(size_t index) const;
+
+  size_t countFileEntry() const;
+
+  // Returns the number of bytes used to store the files.
+  size_t getFileEntryMemoryUsage() const;
+
+private:
+  std::string files_;
 };
 
 } // namespace aria2
@@ -96,14 +96,13 @@ std::string FeedbackURISelector::selectRarer(
     if (uri_split(&us, u.c_str()) == -1) {
       continue;
     }
-    auto host = uri::getFieldString(us, USR_HOST, u.c_str());
-    auto protocol = uri::getFieldString(us, USR_SCHEME, u.c_str());
-    auto ss = serverStatMan_->find(host, protocol);
+    auto ss = serverStatMan_->find(u.c_str(), us);
     if (ss && ss->isError()) {
       A2_LOG_DEBUG(fmt("Error not considered: %s", u.c_str()));
       continue;
     }
-    cands.push_back(std::make_pair(host, u));
+    cands.push_back(
+        std::make_pair(uri::getFieldString(us, USR_HOST, u.c_str()), u));
   }
   for (const auto& h : usedHosts) {
     for (const auto& c : cands) {
@@ -140,8 +139,7 @@ std::string FeedbackURISelector::selectFaster(
       A2_LOG_DEBUG(fmt("%s is in usedHosts, not considered", u.c_str()));
       continue;
     }
-    auto protocol = uri::getFieldString(us, USR_SCHEME, u.c_str());
-    auto ss = serverStatMan_->find(host, protocol);
+    auto ss = serverStatMan_->find(u.c_str(), us);
     if (!ss) {
       normCands.push_back(u);
     }
@@ -36,6 +36,7 @@
 
 #include <cassert>
 #include <algorithm>
+#include <limits>
 
 #include "util.h"
 #include "URISelector.h"
@@ -66,25 +67,34 @@ operator()(const std::shared_ptr<Request>& lhs,
   return lspd > rspd || (lspd == rspd && lhs.get() < rhs.get());
 }
 
+FileEntry::UriState::UriState() : lastFasterReplace(Timer::zero()) {}
+
 FileEntry::FileEntry(std::string path, int64_t length, int64_t offset,
                      const std::vector<std::string>& uris)
     : length_(length),
       offset_(offset),
-      uris_(uris.begin(), uris.end()),
       path_(std::move(path)),
-      lastFasterReplace_(Timer::zero()),
+      suffixPathLength_(0),
       maxConnectionPerServer_(1),
       requested_(true),
-      uniqueProtocol_(false)
+      uniqueProtocol_(false),
+      suffixPathInPath_(false),
+      originalNameIsSuffixPath_(false)
 {
+  if (!uris.empty()) {
+    uriState().uris.assign(uris.begin(), uris.end());
+  }
 }
 
 FileEntry::FileEntry()
     : length_(0),
       offset_(0),
+      suffixPathLength_(0),
       maxConnectionPerServer_(1),
       requested_(false),
-      uniqueProtocol_(false)
+      uniqueProtocol_(false),
+      suffixPathInPath_(false),
+      originalNameIsSuffixPath_(false)
 {
 }
 
@@ -93,6 +103,7 @@ FileEntry::~FileEntry() = default;
 FileEntry& FileEntry::operator=(const FileEntry& entry)
 {
   if (this != &entry) {
+    detachNames();
     path_ = entry.path_;
     length_ = entry.length_;
     offset_ = entry.offset_;
@@ -114,11 +125,62 @@ int64_t FileEntry::gtoloff(int64_t goff) const
   return goff - offset_;
 }
 
+FileEntry::UriState& FileEntry::uriState()
+{
+  if (!uriState_) {
+    uriState_ = make_unique<UriState>();
+  }
+  return *uriState_;
+}
+
+namespace {
+const std::deque<std::string> emptyUris;
+const std::deque<URIResult> emptyURIResults;
+const FileEntry::InFlightRequestSet emptyRequests;
+} // namespace
+
+const std::deque<std::string>& FileEntry::getRemainingUris() const
+{
+  return uriState_ ? uriState_->uris : emptyUris;
+}
+
+std::deque<std::string>& FileEntry::getRemainingUris()
+{
+  return uriState().uris;
+}
+
+const std::deque<std::string>& FileEntry::getSpentUris() const
+{
+  return uriState_ ? uriState_->spentUris : emptyUris;
+}
+
+std::deque<std::string>& FileEntry::getSpentUris()
+{
+  return uriState().spentUris;
+}
+
+const std::deque<URIResult>& FileEntry::getURIResults() const
+{
+  return uriState_ ? uriState_->uriResults : emptyURIResults;
+}
+
+const FileEntry::InFlightRequestSet& FileEntry::getInFlightRequests() const
+{
+  return uriState_ ? uriState_->inFlightRequests : emptyRequests;
+}
+
+const std::string& FileEntry::getContentType() const
+{
+  return uriState_ ? uriState_->contentType : A2STR::NIL;
+}
+
 std::vector<std::string> FileEntry::getUris() const
 {
-  std::vector<std::string> uris(std::begin(spentUris_), std::end(spentUris_));
-  uris.insert(std::end(uris), std::begin(uris_), std::end(uris_));
-  return uris;
+  const auto& spentUris = getSpentUris();
+  const auto& uris = getRemainingUris();
+  std::vector<std::string> res(std::begin(spentUris), std::end(spentUris));
+  res.insert(std::end(res), std::begin(uris), std::end(uris));
+  return res;
 }
 
 namespace {
@@ -142,6 +204,7 @@ std::shared_ptr<Request> FileEntry::getRequestWithInFlightHosts(
     const std::string& referer, const std::string& method,
     const std::vector<std::string>& inFlightHosts)
 {
+  auto& st = uriState();
   std::shared_ptr<Request> req;
 
   for (int g = 0; g < 2; ++g) {
@@ -169,16 +232,17 @@ std::shared_ptr<Request> FileEntry::getRequestWithInFlightHosts(
           req->setReferer(util::percentEncodeMini(referer));
         }
         req->setMethod(method);
-        spentUris_.push_back(uri);
-        inFlightRequests_.insert(req);
+        st.spentUris.push_back(uri);
+        st.inFlightRequests.insert(req);
         break;
       }
       else {
         req.reset();
       }
     }
-    uris_.insert(std::begin(uris_), std::begin(pending), std::end(pending));
-    if (g == 0 && uriReuse && !req && uris_.size() == pending.size()) {
+    st.uris.insert(std::begin(st.uris), std::begin(pending),
+                   std::end(pending));
+    if (g == 0 && uriReuse && !req && st.uris.size() == pending.size()) {
       // Reuse URIs other than ones in pending
       reuseUri(ignoreHost);
       continue;
@@ -194,11 +258,14 @@ std::shared_ptr<Request> FileEntry::getRequest(
     const std::vector<std::pair<size_t, std::string>>& usedHosts,
     const std::string& referer, const std::string& method)
 {
+  auto& st = uriState();
+  auto& requestPool = st.requestPool;
+  auto& inFlightRequests = st.inFlightRequests;
   std::shared_ptr<Request> req;
-  if (requestPool_.empty()) {
+  if (requestPool.empty()) {
     std::vector<std::string> inFlightHosts;
-    enumerateInFlightHosts(std::begin(inFlightRequests_),
-                           std::end(inFlightRequests_),
+    enumerateInFlightHosts(std::begin(inFlightRequests),
+                           std::end(inFlightRequests),
                            std::back_inserter(inFlightHosts));
     return getRequestWithInFlightHosts(selector, uriReuse, usedHosts, referer,
                                        method, inFlightHosts);
@@ -208,35 +275,35 @@ std::shared_ptr<Request> FileEntry::getRequest(
   // sleeping(Request::getWakeTime() < global::wallclock()).  If all
   // pooled objects are sleeping, we may return first one.  Caller
   // should inspect returned object's getWakeTime().
-  auto i = std::begin(requestPool_);
-  for (; i != std::end(requestPool_); ++i) {
+  auto i = std::begin(requestPool);
+  for (; i != std::end(requestPool); ++i) {
     if ((*i)->getWakeTime() <= global::wallclock()) {
       break;
     }
   }
-  if (i == std::end(requestPool_)) {
+  if (i == std::end(requestPool)) {
     // all requests are sleeping; try to another URI
     std::vector<std::string> inFlightHosts;
-    enumerateInFlightHosts(std::begin(inFlightRequests_),
-                           std::end(inFlightRequests_),
+    enumerateInFlightHosts(std::begin(inFlightRequests),
+                           std::end(inFlightRequests),
                            std::back_inserter(inFlightHosts));
-    enumerateInFlightHosts(std::begin(requestPool_), std::end(requestPool_),
+    enumerateInFlightHosts(std::begin(requestPool), std::end(requestPool),
                            std::back_inserter(inFlightHosts));
 
     req = getRequestWithInFlightHosts(selector, uriReuse, usedHosts, referer,
                                       method, inFlightHosts);
-    if (!req || req->getUri() == (*std::begin(requestPool_))->getUri()) {
-      i = std::begin(requestPool_);
+    if (!req || req->getUri() == (*std::begin(requestPool))->getUri()) {
+      i = std::begin(requestPool);
     }
   }
 
-  if (i != std::end(requestPool_)) {
+  if (i != std::end(requestPool)) {
     req = *i;
-    requestPool_.erase(i);
+    requestPool.erase(i);
     A2_LOG_DEBUG(fmt("Picked up from pool: %s", req->getUri().c_str()));
   }
 
-  inFlightRequests_.insert(req);
+  inFlightRequests.insert(req);
 
   return req;
 }
@@ -248,12 +315,14 @@ constexpr auto startupIdleTime = 10_s;
 std::shared_ptr<Request>
 FileEntry::findFasterRequest(const std::shared_ptr<Request>& base)
 {
-  if (requestPool_.empty() ||
-      lastFasterReplace_.difference(global::wallclock()) < startupIdleTime) {
+  if (!uriState_ || uriState_->requestPool.empty() ||
+      uriState_->lastFasterReplace.difference(global::wallclock()) <
+          startupIdleTime) {
     return nullptr;
   }
+  auto& requestPool = uriState_->requestPool;
   const std::shared_ptr<PeerStat>& fastest =
-      (*requestPool_.begin())->getPeerStat();
+      (*requestPool.begin())->getPeerStat();
   if (!fastest) {
     return nullptr;
   }
@@ -264,10 +333,10 @@ FileEntry::findFasterRequest(const std::shared_ptr<Request>& base)
                     fastest->getAvgDownloadSpeed() * 0.8 >
                         basestat->calculateDownloadSpeed())) {
     // TODO we should consider that "fastest" is very slow.
-    std::shared_ptr<Request> fastestRequest = *requestPool_.begin();
-    requestPool_.erase(requestPool_.begin());
-    inFlightRequests_.insert(fastestRequest);
-    lastFasterReplace_ = global::wallclock();
+    std::shared_ptr<Request> fastestRequest = *requestPool.begin();
+    requestPool.erase(requestPool.begin());
+    uriState_->inFlightRequests.insert(fastestRequest);
+    uriState_->lastFasterReplace = global::wallclock();
     return fastestRequest;
   }
   return nullptr;
@@ -279,11 +348,15 @@ std::shared_ptr<Request> FileEntry::findFasterRequest(
     const std::shared_ptr<ServerStatMan>& serverStatMan)
 {
   constexpr int SPEED_THRESHOLD = 20_k;
-  if (lastFasterReplace_.difference(global::wallclock()) < startupIdleTime) {
+  if (!uriState_ ||
+      uriState_->lastFasterReplace.difference(global::wallclock()) <
+          startupIdleTime) {
     return nullptr;
   }
+  auto& st = *uriState_;
   std::vector<std::string> inFlightHosts;
-  enumerateInFlightHosts(inFlightRequests_.begin(), inFlightRequests_.end(),
+  enumerateInFlightHosts(st.inFlightRequests.begin(),
+                         st.inFlightRequests.end(),
                          std::back_inserter(inFlightHosts));
   const std::shared_ptr<PeerStat>& basestat = base->getPeerStat();
   A2_LOG_DEBUG("Search faster server using ServerStat.");
@@ -291,15 +364,14 @@ std::shared_ptr<Request> FileEntry::findFasterRequest(
   const size_t NUM_URI = 10;
   std::vector<std::pair<std::shared_ptr<ServerStat>, std::string>> fastCands;
   std::vector<std::string> normCands;
-  for (std::deque<std::string>::const_iterator i = uris_.begin(),
-                                               eoi = uris_.end();
+  for (std::deque<std::string>::const_iterator i = st.uris.begin(),
+                                               eoi = st.uris.end();
        i != eoi && fastCands.size() < NUM_URI; ++i) {
     uri_split_result us;
     if (uri_split(&us, (*i).c_str()) == -1) {
       continue;
     }
     std::string host = uri::getFieldString(us, USR_HOST, (*i).c_str());
-    std::string protocol = uri::getFieldString(us, USR_SCHEME, (*i).c_str());
     if (std::count(inFlightHosts.begin(), inFlightHosts.end(), host) >=
         maxConnectionPerServer_) {
       A2_LOG_DEBUG(fmt("%s has already used %d times, not considered.",
@@ -311,7 +383,7 @@ std::shared_ptr<Request> FileEntry::findFasterRequest(
       A2_LOG_DEBUG(fmt("%s is in usedHosts, not considered", (*i).c_str()));
       continue;
     }
-    std::shared_ptr<ServerStat> ss = serverStatMan->find(host, protocol);
+    std::shared_ptr<ServerStat> ss = serverStatMan->find((*i).c_str(), us);
     if (ss && ss->isOK()) {
       if ((basestat &&
            ss->getDownloadSpeed() > basestat->calculateDownloadSpeed() * 1.5) ||
@@ -328,10 +400,10 @@ std::shared_ptr<Request> FileEntry::findFasterRequest(
     // Candidate URIs where already parsed when populating fastCands.
     (void)fastestRequest->setUri(uri);
     fastestRequest->setReferer(base->getReferer());
-    uris_.erase(std::find(uris_.begin(), uris_.end(), uri));
-    spentUris_.push_back(uri);
-    inFlightRequests_.insert(fastestRequest);
-    lastFasterReplace_ = global::wallclock();
+    st.uris.erase(std::find(st.uris.begin(), st.uris.end(), uri));
+    st.spentUris.push_back(uri);
+    st.inFlightRequests.insert(fastestRequest);
+    st.lastFasterReplace = global::wallclock();
     return fastestRequest;
   }
   A2_LOG_DEBUG("No faster server found.");
@@ -346,7 +418,7 @@ void FileEntry::storePool(const std::shared_ptr<Request>& request)
     // store Request in the right position in the pool.
     peerStat->calculateAvgDownloadSpeed();
   }
-  requestPool_.insert(request);
+  uriState().requestPool.insert(request);
 }
 
 void FileEntry::poolRequest(const std::shared_ptr<Request>& request)
@@ -359,14 +431,18 @@ void FileEntry::poolRequest(const std::shared_ptr<Request>& request)
 
 bool FileEntry::removeRequest(const std::shared_ptr<Request>& request)
 {
-  return inFlightRequests_.erase(request) == 1;
+  return uriState_ && uriState_->inFlightRequests.erase(request) == 1;
 }
 
 void FileEntry::removeURIWhoseHostnameIs(const std::string& hostname)
 {
+  if (!uriState_) {
+    return;
+  }
+  auto& uris = uriState_->uris;
   std::deque<std::string> newURIs;
-  for (std::deque<std::string>::const_iterator itr = uris_.begin(),
-                                               eoi = uris_.end();
+  for (std::deque<std::string>::const_iterator itr = uris.begin(),
+                                               eoi = uris.end();
        itr != eoi; ++itr) {
     uri_split_result us;
     if (uri_split(&us, (*itr).c_str()) == -1) {
@@ -379,19 +455,23 @@ void FileEntry::removeURIWhoseHostnameIs(const std::string& hostname)
     }
   }
   A2_LOG_DEBUG(fmt("Removed %lu duplicate hostname URIs for path=%s",
-                   static_cast<unsigned long>(uris_.size() - newURIs.size()),
+                   static_cast<unsigned long>(uris.size() - newURIs.size()),
                    getPath().c_str()));
-  uris_.swap(newURIs);
+  uris.swap(newURIs);
 }
 
 void FileEntry::removeIdenticalURI(const std::string& uri)
 {
-  uris_.erase(std::remove(uris_.begin(), uris_.end(), uri), uris_.end());
+  if (!uriState_) {
+    return;
+  }
+  auto& uris = uriState_->uris;
+  uris.erase(std::remove(uris.begin(), uris.end(), uri), uris.end());
 }
 
 void FileEntry::addURIResult(std::string uri, error_code::Value result)
 {
-  uriResults_.push_back(URIResult(uri, result));
+  uriState().uriResults.push_back(URIResult(uri, result));
 }
 
 namespace {
@@ -412,25 +492,33 @@ public:
 void FileEntry::extractURIResult(std::deque<URIResult>& res,
                                  error_code::Value r)
 {
-  auto i = std::stable_partition(uriResults_.begin(), uriResults_.end(),
+  if (!uriState_) {
+    return;
+  }
+  auto& uriResults = uriState_->uriResults;
+  auto i = std::stable_partition(uriResults.begin(), uriResults.end(),
                                  FindURIResultByResult(r));
-  std::copy(uriResults_.begin(), i, std::back_inserter(res));
-  uriResults_.erase(uriResults_.begin(), i);
+  std::copy(uriResults.begin(), i, std::back_inserter(res));
+  uriResults.erase(uriResults.begin(), i);
 }
 
 void FileEntry::reuseUri(const std::vector<std::string>& ignore)
 {
+  if (!uriState_) {
+    return;
+  }
+  auto& st = *uriState_;
   if (A2_LOG_DEBUG_ENABLED) {
     for (const auto& i : ignore) {
       A2_LOG_DEBUG(fmt("ignore host=%s", i.c_str()));
     }
   }
-  std::deque<std::string> uris = spentUris_;
+  std::deque<std::string> uris = st.spentUris;
   std::sort(uris.begin(), uris.end());
   uris.erase(std::unique(uris.begin(), uris.end()), uris.end());
 
-  std::vector<std::string> errorUris(uriResults_.size());
-  std::transform(uriResults_.begin(), uriResults_.end(), errorUris.begin(),
+  std::vector<std::string> errorUris(st.uriResults.size());
+  std::transform(st.uriResults.begin(), st.uriResults.end(), errorUris.begin(),
                  std::mem_fn(&URIResult::getURI));
   std::sort(errorUris.begin(), errorUris.end());
   errorUris.erase(std::unique(errorUris.begin(), errorUris.end()),
@@ -469,13 +557,15 @@ void FileEntry::reuseUri(const std::vector<std::string>& ignore)
       A2_LOG_DEBUG(fmt("URI=%s", (*i).c_str()));
     }
   }
-  uris_.insert(uris_.end(), reusableURIs.begin(), reusableURIs.end());
+  st.uris.insert(st.uris.end(), reusableURIs.begin(), reusableURIs.end());
 }
 
 void FileEntry::releaseRuntimeResource()
 {
-  requestPool_.clear();
-  inFlightRequests_.clear();
+  if (uriState_) {
+    uriState_->requestPool.clear();
+    uriState_->inFlightRequests.clear();
+  }
 }
 
 namespace {
@@ -491,8 +581,12 @@ void putBackUri(std::deque<std::string>& uris, InputIterator first,
 
 void FileEntry::putBackRequest()
 {
-  putBackUri(uris_, requestPool_.begin(), requestPool_.end());
-  putBackUri(uris_, inFlightRequests_.begin(), inFlightRequests_.end());
+  if (!uriState_) {
+    return;
+  }
+  auto& st = *uriState_;
+  putBackUri(st.uris, st.requestPool.begin(), st.requestPool.end());
+  putBackUri(st.uris, st.inFlightRequests.begin(), st.inFlightRequests.end());
 }
 
 namespace {
@@ -511,27 +605,31 @@ InputIterator findRequestByUri(InputIterator first, InputIterator last,
 
 bool FileEntry::removeUri(const std::string& uri)
 {
-  auto itr = std::find(spentUris_.begin(), spentUris_.end(), uri);
-  if (itr == spentUris_.end()) {
-    itr = std::find(uris_.begin(), uris_.end(), uri);
-    if (itr == uris_.end()) {
+  if (!uriState_) {
+    return false;
+  }
+  auto& st = *uriState_;
+  auto itr = std::find(st.spentUris.begin(), st.spentUris.end(), uri);
+  if (itr == st.spentUris.end()) {
+    itr = std::find(st.uris.begin(), st.uris.end(), uri);
+    if (itr == st.uris.end()) {
       return false;
     }
-    uris_.erase(itr);
+    st.uris.erase(itr);
     return true;
   }
-  spentUris_.erase(itr);
+  st.spentUris.erase(itr);
   std::shared_ptr<Request> req;
-  auto riter =
-      findRequestByUri(inFlightRequests_.begin(), inFlightRequests_.end(), uri);
-  if (riter == inFlightRequests_.end()) {
+  auto riter = findRequestByUri(st.inFlightRequests.begin(),
+                                st.inFlightRequests.end(), uri);
+  if (riter == st.inFlightRequests.end()) {
     auto riter =
-        findRequestByUri(requestPool_.begin(), requestPool_.end(), uri);
-    if (riter == requestPool_.end()) {
+        findRequestByUri(st.requestPool.begin(), st.requestPool.end(), uri);
+    if (riter == st.requestPool.end()) {
       return true;
     }
     req = *riter;
-    requestPool_.erase(riter);
+    st.requestPool.erase(riter);
   }
   else {
     req = *riter;
@@ -546,7 +644,9 @@ std::string FileEntry::getDirname() const { return File(path_).getDirname(); }
 
 size_t FileEntry::setUris(const std::vector<std::string>& uris)
 {
-  uris_.clear();
+  if (uriState_) {
+    uriState_->uris.clear();
+  }
   return addUris(uris.begin(), uris.end());
 }
 
@@ -554,7 +654,7 @@ bool FileEntry::addUri(const std::string& uri)
 {
   std::string peUri = util::percentEncodeMini(uri);
   if (uri_split(nullptr, peUri.c_str()) == 0) {
-    uris_.push_back(peUri);
+    uriState().uris.push_back(peUri);
     return true;
   }
   else {
@@ -568,38 +668,133 @@ bool FileEntry::insertUri(const std::string& uri, size_t pos)
   if (uri_split(nullptr, peUri.c_str()) != 0) {
     return false;
   }
-  pos = std::min(pos, uris_.size());
-  uris_.insert(uris_.begin() + pos, peUri);
+  auto& uris = uriState().uris;
+  pos = std::min(pos, uris.size());
+  uris.insert(uris.begin() + pos, peUri);
   return true;
 }
 
-void FileEntry::setPath(std::string path) { path_ = std::move(path); }
+void FileEntry::setPath(std::string path)
+{
+  detachNames();
+  path_ = std::move(path);
+}
 
 void FileEntry::setContentType(std::string contentType)
 {
-  contentType_ = std::move(contentType);
+  uriState().contentType = std::move(contentType);
 }
 
 size_t FileEntry::countInFlightRequest() const
 {
-  return inFlightRequests_.size();
+  return uriState_ ? uriState_->inFlightRequests.size() : 0;
 }
 
-size_t FileEntry::countPooledRequest() const { return requestPool_.size(); }
+size_t FileEntry::countPooledRequest() const
+{
+  return uriState_ ? uriState_->requestPool.size() : 0;
+}
+
+void FileEntry::detachNames()
+{
+  if (originalNameIsSuffixPath_) {
+    originalName_ = getSuffixPath();
+    originalNameIsSuffixPath_ = false;
+  }
+  if (suffixPathInPath_) {
+    suffixPath_ = getSuffixPath();
+    suffixPathInPath_ = false;
+    suffixPathLength_ = 0;
+  }
+}
 
 void FileEntry::setOriginalName(std::string originalName)
 {
-  originalName_ = std::move(originalName);
+  // For BitTorrent downloads, the original name usually equals the
+  // suffix path, which in turn is the tail of the path.
+  if (!originalName.empty() &&
+      (suffixPathInPath_ ? originalName.size() == suffixPathLength_ &&
+                               util::endsWith(path_, originalName)
+                         : originalName == suffixPath_)) {
+    originalName_.clear();
+    originalName_.shrink_to_fit();
+    originalNameIsSuffixPath_ = true;
+  }
+  else {
+    originalName_ = std::move(originalName);
+    originalNameIsSuffixPath_ = false;
+  }
+}
+
+std::string FileEntry::getOriginalName() const
+{
+  return originalNameIsSuffixPath_ ? getSuffixPath() : originalName_;
 }
 
 void FileEntry::setSuffixPath(std::string suffixPath)
 {
-  suffixPath_ = std::move(suffixPath);
+  if (originalNameIsSuffixPath_) {
+    originalName_ = getSuffixPath();
+    originalNameIsSuffixPath_ = false;
+  }
+  if (suffixPath.size() <= std::numeric_limits<uint32_t>::max() &&
+      util::endsWith(path_, suffixPath)) {
+    suffixPath_.clear();
+    suffixPath_.shrink_to_fit();
+    suffixPathLength_ = suffixPath.size();
+    suffixPathInPath_ = true;
+  }
+  else {
+    suffixPath_ = std::move(suffixPath);
+    suffixPathLength_ = 0;
+    suffixPathInPath_ = false;
+  }
+}
+
+std::string FileEntry::getSuffixPath() const
+{
+  if (suffixPathInPath_) {
+    return path_.substr(path_.size() - suffixPathLength_);
+  }
+  return suffixPath_;
 }
 
 bool FileEntry::emptyRequestUri() const
 {
-  return uris_.empty() && inFlightRequests_.empty() && requestPool_.empty();
+  return !uriState_ ||
+         (uriState_->uris.empty() && uriState_->inFlightRequests.empty() &&
+          uriState_->requestPool.empty());
+}
+
+namespace {
+size_t stringMemoryUsage(const std::string& s)
+{
+  return sizeof(s) + s.capacity();
+}
+} // namespace
+
+size_t FileEntry::estimateMemoryUsage() const
+{
+  size_t n = sizeof(*this) + path_.capacity() + originalName_.capacity() +
+             suffixPath_.capacity();
+  if (uriState_) {
+    auto& st = *uriState_;
+    n += sizeof(st) + st.contentType.capacity();
+    for (auto& uri : st.uris) {
+      n += stringMemoryUsage(uri);
+    }
+    for (auto& uri : st.spentUris) {
+      n += stringMemoryUsage(uri);
+    }
+    for (auto& res : st.uriResults) {
+      n += sizeof(res) + res.getURI().capacity();
+    }
+    // Each node of std::set has 3 pointers and a color in addition to
+    // the element.
+    n += (st.requestPool.size() + st.inFlightRequests.size()) *
+         (sizeof(std::shared_ptr<Request>) + 4 * sizeof(void*));
+  }
+  return n;
 }
 
 void writeFilePath(std::ostream& o, const std::shared_ptr<FileEntry>& entry,
@@ -71,29 +71,51 @@ private:
   };
   typedef std::set<std::shared_ptr<Request>, RequestFaster> RequestPool;
 
+  // State used only to download the file from URIs. It is allocated
+  // when it is needed for the first time, so that files of a
+  // BitTorrent download without web-seeding do not pay for it.
+  struct UriState {
+    std::deque<std::string> uris;
+    std::deque<std::string> spentUris;
+    // URIResult is stored in the ascending order of the time when its
+    // result is available.
+    std::deque<URIResult> uriResults;
+    RequestPool requestPool;
+    InFlightRequestSet inFlightRequests;
+    std::string contentType;
+    Timer lastFasterReplace;
+
+    UriState();
+  };
+
   int64_t length_;
   int64_t offset_;
 
-  std::deque<std::string> uris_;
-  std::deque<std::string> spentUris_;
-  // URIResult is stored in the ascending order of the time when its result is
-  // available.
-  std::deque<URIResult> uriResults_;
-  RequestPool requestPool_;
-  InFlightRequestSet inFlightRequests_;
+  std::unique_ptr<UriState> uriState_;
 
   std::string path_;
-  std::string contentType_;
   std::string originalName_;
   // path_ without parent directory component.  This is primarily used
-  // to change directory (PREF_DIR option).
+  // to change directory (PREF_DIR option).  If suffixPathInPath_ is
+  // true, this is empty and the last suffixPathLength_ bytes of path_
+  // are used instead.
   std::string suffixPath_;
+  uint32_t suffixPathLength_;
 
-  Timer lastFasterReplace_;
   int maxConnectionPerServer_;
 
   bool requested_;
   bool uniqueProtocol_;
+  bool suffixPathInPath_;
+  // true if originalName_ is empty and getSuffixPath() is used
+  // instead.
+  bool originalNameIsSuffixPath_;
+
+  UriState& uriState();
+
+  // Copies the suffix path and the original name borrowed from path_
+  // into their own strings.
+  void detachNames();
 
   void storePool(const std::shared_ptr<Request>& request);
 
@@ -135,14 +157,16 @@ public:
 
   void setRequested(bool flag) { requested_ = flag; }
 
-  const std::deque<std::string>& getRemainingUris() const { return uris_; }
+  const std::deque<std::string>& getRemainingUris() const;
 
-  std::deque<std::string>& getRemainingUris() { return uris_; }
+  // This allocates the state for URIs if it has not been allocated
+  // yet. Use const version to just read URIs.
+  std::deque<std::string>& getRemainingUris();
 
-  const std::deque<std::string>& getSpentUris() const { return spentUris_; }
+  const std::deque<std::string>& getSpentUris() const;
 
   // Exposed for unittest
-  std::deque<std::string>& getSpentUris() { return spentUris_; }
+  std::deque<std::string>& getSpentUris();
 
   size_t setUris(const std::vector<std::string>& uris);
 
@@ -162,12 +186,13 @@ public:
 
   bool insertUri(const std::string& uri, size_t pos);
 
-  // Returns uris_ and spentUris_ in single std::vector<std::string>.
+  // Returns spent URIs and remaining URIs in single
+  // std::vector<std::string>.
   std::vector<std::string> getUris() const;
 
   void setContentType(std::string contentType);
 
-  const std::string& getContentType() const { return contentType_; }
+  const std::string& getContentType() const;
 
   // If pooled Request object is available, one of them is removed
   // from the pool and returned.  If pool is empty, then select URI
@@ -177,9 +202,9 @@ public:
   // pool, referer is ignored.  If method is given, it is set to newly
   // created Request. If Request object is retrieved from the pool,
   // method is ignored. If uriReuse is true and selector does not
-  // returns Request object either because uris_ is empty or all URI
-  // are not be usable because maxConnectionPerServer_ limit, then
-  // reuse used URIs and do selection again.
+  // returns Request object either because remaining URIs are empty or
+  // all URI are not be usable because maxConnectionPerServer_ limit,
+  // then reuse used URIs and do selection again.
   std::shared_ptr<Request>
   getRequest(URISelector* selector, bool uriReuse,
              const std::vector<std::pair<size_t, std::string>>& usedHosts,
@@ -206,10 +231,7 @@ public:
 
   size_t countPooledRequest() const;
 
-  const InFlightRequestSet& getInFlightRequests() const
-  {
-    return inFlightRequests_;
-  }
+  const InFlightRequestSet& getInFlightRequests() const;
 
   bool operator<(const FileEntry& fileEntry) const;
 
@@ -224,10 +246,10 @@ public:
 
   void addURIResult(std::string uri, error_code::Value result);
 
-  const std::deque<URIResult>& getURIResults() const { return uriResults_; }
+  const std::deque<URIResult>& getURIResults() const;
 
   // Extracts URIResult whose _result is r and stores them into res.
-  // The extracted URIResults are removed from uriResults_.
+  // The extracted URIResults are removed from this object.
   void extractURIResult(std::deque<URIResult>& res, error_code::Value r);
 
   void setMaxConnectionPerServer(int n) { maxConnectionPerServer_ = n; }
@@ -236,21 +258,22 @@ public:
 
   // Reuse URIs which have not emitted error so far and whose host
   // component is not included in ignore. The reusable URIs are
-  // appended to uris_ maxConnectionPerServer_ times.
+  // appended to remaining URIs.
   void reuseUri(const std::vector<std::string>& ignore);
 
   void releaseRuntimeResource();
 
-  // Push URIs in pooled or in-flight requests to the front of uris_.
+  // Push URIs in pooled or in-flight requests to the front of
+  // remaining URIs.
   void putBackRequest();
 
   void setOriginalName(std::string originalName);
 
-  const std::string& getOriginalName() const { return originalName_; }
+  std::string getOriginalName() const;
 
   void setSuffixPath(std::string suffixPath);
 
-  const std::string& getSuffixPath() const { return suffixPath_; }
+  std::string getSuffixPath() const;
 
   bool removeUri(const std::string& uri);
 
@@ -259,6 +282,10 @@ public:
   void setUniqueProtocol(bool f) { uniqueProtocol_ = f; }
 
   bool isUniqueProtocol() const { return uniqueProtocol_; }
+
+  // Returns the approximate number of bytes this object occupies,
+  // including the memory it owns.
+  size_t estimateMemoryUsage() const;
 };
 
 // Returns the first FileEntry which isRequested() method returns
@@ -295,7 +322,10 @@ template <typename InputIterator>
 bool isUriSuppliedForRequsetFileEntry(InputIterator first, InputIterator last)
 {
   for (; first != last; ++first) {
-    if ((*first)->isRequested() && !(*first)->getRemainingUris().empty()) {
+    // Read through const reference, so that files without URIs do
+    // not allocate URI state.
+    const FileEntry& fe = **first;
+    if (fe.isRequested() && !fe.getRemainingUris().empty()) {
       return true;
     }
   }
@@ -0,0 +1,59 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "FileOffsetIndex.h"
+
+namespace aria2 {
+
+const size_t FileOffsetIndex::npos;
+
+size_t FileOffsetIndex::find(int64_t offset) const
+{
+  if (offsets_.empty() || offset < offsets_[0]) {
+    return npos;
+  }
+  // Invariant: base[0] <= offset and the answer is in [base, base +
+  // n).  The loop body compiles to a conditional move, so its running
+  // time depends only on the number of files.
+  auto base = offsets_.data();
+  size_t n = offsets_.size();
+  while (n > 1) {
+    size_t half = n / 2;
+    base = base[half] <= offset ? base + half : base;
+    n -= half;
+  }
+  return base - offsets_.data();
+}
+
+} // namespace aria2
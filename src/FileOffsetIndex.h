@@ -0,0 +1,79 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_FILE_OFFSET_INDEX_H
+#define D_FILE_OFFSET_INDEX_H
+
+#include "common.h"
+
+#include <vector>
+
+namespace aria2 {
+
+// Sorted array of the offsets of files laid out in a single download.
+// It maps a global offset to the index of the file which contains it
+// without touching FileEntry objects and without allocation.
+class FileOffsetIndex {
+public:
+  // Returned by find() if no file starts at or before the offset.
+  static const size_t npos = static_cast<size_t>(-1);
+
+  // Rebuilds the index from the range [first, last) of smart
+  // pointers to FileEntry.  The range must be sorted by offset.
+  template <typename InputIterator>
+  void reset(InputIterator first, InputIterator last)
+  {
+    offsets_.clear();
+    for (; first != last; ++first) {
+      offsets_.push_back((*first)->getOffset());
+    }
+  }
+
+  // Returns the index of the last file whose offset is less than or
+  // equal to |offset|.  If files of zero length share an offset with
+  // the following file, the last one of them is returned.  If there
+  // is no such file, returns npos.
+  size_t find(int64_t offset) const;
+
+  size_t size() const { return offsets_.size(); }
+
+  bool empty() const { return offsets_.empty(); }
+
+private:
+  std::vector<int64_t> offsets_;
+};
+
+} // namespace aria2
+
+#endif // D_FILE_OFFSET_INDEX_H
@@ -0,0 +1,101 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_FREE_LIST_H
+#define D_FREE_LIST_H
+
+#include "common.h"
+
+#include <new>
+#include <vector>
+
+namespace aria2 {
+
+// Keeps up to N freed memory blocks of sizeof(T) bytes for reuse.
+// Classes which are created and destroyed at high rate, such as
+// BitTorrent wire messages, define their class-specific operator new
+// and operator delete with this, so that they are allocated without
+// going to the global allocator in steady state.  Blocks of other
+// sizes, which come from derived classes, are passed through to the
+// global allocator.
+//
+// This is not thread-safe.  Only use it for objects which are created
+// and destroyed in the main thread.
+template <typename T, size_t N = 1024> class FreeList {
+private:
+  struct Blocks {
+    std::vector<void*> blocks;
+    ~Blocks()
+    {
+      for (auto p : blocks) {
+        ::operator delete(p);
+      }
+    }
+  };
+
+  static std::vector<void*>& getBlocks()
+  {
+    static Blocks b;
+    return b.blocks;
+  }
+
+public:
+  static void* allocate(size_t size)
+  {
+    auto& blocks = getBlocks();
+    if (size != sizeof(T) || blocks.empty()) {
+      return ::operator new(size);
+    }
+    auto p = blocks.back();
+    blocks.pop_back();
+    return p;
+  }
+
+  static void deallocate(void* p, size_t size)
+  {
+    auto& blocks = getBlocks();
+    if (size != sizeof(T) || blocks.size() >= N) {
+      ::operator delete(p);
+      return;
+    }
+    blocks.push_back(p);
+  }
+
+  // Returns the number of blocks available for reuse.
+  static size_t size() { return getBlocks().size(); }
+};
+
+} // namespace aria2
+
+#endif // D_FREE_LIST_H
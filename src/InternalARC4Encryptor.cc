@@ -44,7 +44,7 @@ void ARC4Encryptor::init(const unsigned char* key, size_t keyLength)
     c = j++;
 
   j = 0;
-  for (i = 0; i < sizeof(state_); ++i) {
+  for (i = 0; i < 256; ++i) {
     j = (j + state_[i] + key[i % keyLength]) & 0xff;
     auto tmp = state_[i];
     state_[i] = state_[j];
@@ -53,17 +53,38 @@ void ARC4Encryptor::init(const unsigned char* key, size_t keyLength)
   i = j = 0;
 }
 
+#define ARC4_STEP(k)                                                           \
+  {                                                                            \
+    x = (x + 1) & 0xff;                                                        \
+    auto sx = state[x];                                                        \
+    y = (y + sx) & 0xff;                                                       \
+    auto sy = state[y];                                                        \
+    state[y] = sx;                                                             \
+    state[x] = sy;                                                             \
+    out[k] = in[k] ^ state[(sx + sy) & 0xff];                                  \
+  }
+
 void ARC4Encryptor::encrypt(size_t len, unsigned char* out,
                             const unsigned char* in)
 {
-  for (auto c = 0u; c < len; ++c) {
-    i = (i + 1) & 0xff;
-    j = (j + state_[i]) & 0xff;
-    auto sj = state_[i];
-    auto si = state_[i] = state_[j];
-    state_[j] = sj;
-    out[c] = in[c] ^ state_[(si + sj) & 0xff];
+  // Work on local copies of the indices so that the compiler can keep
+  // them in registers; the member variables are written back once.
+  auto state = state_;
+  uint32_t x = i;
+  uint32_t y = j;
+  for (; len >= 4; len -= 4, in += 4, out += 4) {
+    ARC4_STEP(0);
+    ARC4_STEP(1);
+    ARC4_STEP(2);
+    ARC4_STEP(3);
   }
+  for (; len > 0; --len, ++in, ++out) {
+    ARC4_STEP(0);
+  }
+  i = x;
+  j = y;
 }
 
+#undef ARC4_STEP
+
 } // namespace aria2
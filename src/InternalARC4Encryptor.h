@@ -37,11 +37,16 @@
 
 #include "common.h"
 
+#include <cstdint>
+
 namespace aria2 {
 
 class ARC4Encryptor {
 private:
-  unsigned char state_[256];
+  // Keep the permutation in word sized cells.  Byte sized cells
+  // cause partial register stalls on the load/swap/store chain and
+  // are measurably slower on current x86 and ARM cores.
+  uint32_t state_[256];
   unsigned i, j;
 
 public:
@@ -73,7 +73,7 @@ void IteratableChunkChecksumValidator::validateChunk()
     std::string actualChecksum;
     try {
       actualChecksum = calculateActualChecksum();
-      if (actualChecksum == dctx_->getPieceHashes()[currentIndex_]) {
+      if (dctx_->pieceHashEquals(currentIndex_, actualChecksum)) {
         bitfield_->setBit(currentIndex_);
       }
       else {
@@ -81,7 +81,7 @@ void IteratableChunkChecksumValidator::validateChunk()
             fmt(EX_INVALID_CHUNK_CHECKSUM,
                 static_cast<unsigned long>(currentIndex_),
                 static_cast<int64_t>(getCurrentOffset()),
-                util::toHex(dctx_->getPieceHashes()[currentIndex_]).c_str(),
+                util::toHex(dctx_->getPieceHash(currentIndex_)).c_str(),
                 util::toHex(actualChecksum).c_str()));
         bitfield_->unsetBit(currentIndex_);
       }
@@ -55,7 +55,11 @@ TLSContext* TLSContext::make(TLSSessionSide side, TLSVersion ver)
 }
 
 GnuTLSContext::GnuTLSContext(TLSSessionSide side, TLSVersion ver)
-    : certCred_(0), side_(side), minTLSVer_(ver), verifyPeer_(true)
+    : certCred_(0),
+      ticketKey_{nullptr, 0},
+      side_(side),
+      minTLSVer_(ver),
+      verifyPeer_(true)
 {
   int r = gnutls_certificate_allocate_credentials(&certCred_);
   if (r == GNUTLS_E_SUCCESS) {
@@ -69,6 +73,18 @@ GnuTLSContext::GnuTLSContext(TLSSessionSide side, TLSVersion ver)
                      " Cause: %s",
                      gnutls_strerror(r)));
   }
+  if (good_ && side_ == TLS_SERVER) {
+    // Issue session tickets so that returning clients can resume
+    // their sessions.  On failure, sessions are just not resumed.
+    r = gnutls_session_ticket_key_generate(&ticketKey_);
+    if (r != GNUTLS_E_SUCCESS) {
+      ticketKey_.data = nullptr;
+      ticketKey_.size = 0;
+      A2_LOG_INFO(fmt("gnutls_session_ticket_key_generate() failed."
+                      " Cause: %s",
+                      gnutls_strerror(r)));
+    }
+  }
 }
 
 GnuTLSContext::~GnuTLSContext()
@@ -76,6 +92,14 @@ GnuTLSContext::~GnuTLSContext()
   if (certCred_) {
     gnutls_certificate_free_credentials(certCred_);
   }
+  if (ticketKey_.data) {
+    gnutls_free(ticketKey_.data);
+  }
+}
+
+const gnutls_datum_t* GnuTLSContext::getSessionTicketKey() const
+{
+  return ticketKey_.data ? &ticketKey_ : nullptr;
 }
 
 bool GnuTLSContext::good() const { return good_; }
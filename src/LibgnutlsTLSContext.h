@@ -74,8 +74,13 @@ public:
 
   TLSVersion getMinTLSVersion() const { return minTLSVer_; }
 
+  // Returns the key used to encrypt session tickets issued by this
+  // server side context, or nullptr for client side context.
+  const gnutls_datum_t* getSessionTicketKey() const;
+
 private:
   gnutls_certificate_credentials_t certCred_;
+  gnutls_datum_t ticketKey_;
   TLSSessionSide side_;
   TLSVersion minTLSVer_;
   bool good_;
@@ -124,6 +124,14 @@ int GnuTLSSession::init(sock_t sockfd)
     }
   }
 #endif // A2_DISABLE_OCSP
+  if (tlsContext_->getSide() == TLS_SERVER &&
+      tlsContext_->getSessionTicketKey()) {
+    rv_ = gnutls_session_ticket_enable_server(
+        sslSession_, tlsContext_->getSessionTicketKey());
+    if (rv_ != GNUTLS_E_SUCCESS) {
+      return TLS_ERR_ERROR;
+    }
+  }
 
   // It seems err is not error message, but the argument string
   // which causes syntax error.
@@ -373,4 +381,30 @@ int GnuTLSSession::tlsAccept(TLSVersion& version)
 
 std::string GnuTLSSession::getLastErrorString() { return gnutls_strerror(rv_); }
 
+std::string GnuTLSSession::getSessionData()
+{
+  gnutls_datum_t data;
+  rv_ = gnutls_session_get_data2(sslSession_, &data);
+  if (rv_ != GNUTLS_E_SUCCESS) {
+    return std::string();
+  }
+  std::string res(data.data, data.data + data.size);
+  gnutls_free(data.data);
+  return res;
+}
+
+int GnuTLSSession::setSessionData(const std::string& data)
+{
+  rv_ = gnutls_session_set_data(sslSession_, data.data(), data.size());
+  if (rv_ != GNUTLS_E_SUCCESS) {
+    return TLS_ERR_ERROR;
+  }
+  return TLS_ERR_OK;
+}
+
+bool GnuTLSSession::isSessionResumed()
+{
+  return gnutls_session_is_resumed(sslSession_);
+}
+
 } // namespace aria2
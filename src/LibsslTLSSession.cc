@@ -375,4 +375,38 @@ std::string OpenSSLTLSSession::getLastErrorString()
   }
 }
 
+std::string OpenSSLTLSSession::getSessionData()
+{
+  auto session = SSL_get_session(ssl_);
+  if (!session) {
+    return std::string();
+  }
+  auto len = i2d_SSL_SESSION(session, nullptr);
+  if (len <= 0) {
+    return std::string();
+  }
+  std::string data(len, '\0');
+  auto p = reinterpret_cast<unsigned char*>(&data[0]);
+  i2d_SSL_SESSION(session, &p);
+  return data;
+}
+
+int OpenSSLTLSSession::setSessionData(const std::string& data)
+{
+  ERR_clear_error();
+  auto p = reinterpret_cast<const unsigned char*>(data.data());
+  auto session = d2i_SSL_SESSION(nullptr, &p, data.size());
+  if (!session) {
+    return TLS_ERR_ERROR;
+  }
+  rv_ = SSL_set_session(ssl_, session);
+  SSL_SESSION_free(session);
+  if (rv_ != 1) {
+    return TLS_ERR_ERROR;
+  }
+  return TLS_ERR_OK;
+}
+
+bool OpenSSLTLSSession::isSessionResumed() { return SSL_session_reused(ssl_); }
+
 } // namespace aria2
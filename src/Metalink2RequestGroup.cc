@@ -277,8 +277,7 @@ void Metalink2RequestGroup::createRequestGroup(
       }
       if (entry->chunkChecksum) {
         dctx->setPieceHashes(entry->chunkChecksum->getHashType(),
-                             std::begin(entry->chunkChecksum->getPieceHashes()),
-                             std::end(entry->chunkChecksum->getPieceHashes()));
+                             entry->chunkChecksum->getPieceHashes());
       }
       dctx->setSignature(entry->popSignature());
       rg->setNumConcurrentCommand(
@@ -345,7 +344,7 @@ void Metalink2RequestGroup::createRequestGroup(
       if (currentBtStopTimeout == 0 || currentBtStopTimeout > btStopTimeout) {
         bool allHaveUri = true;
         for (auto& fe : dctx->getFileEntries()) {
-          if (fe->getRemainingUris().empty()) {
+          if (fe->emptyRequestUri()) {
             allHaveUri = false;
             break;
           }
@@ -375,7 +375,7 @@ void MetalinkParserController::commitChunkChecksumTransactionV4()
   if (!tEntry_->chunkChecksum ||
       MessageDigest::isStronger(tChunkChecksumV4_->getHashType(),
                                 tEntry_->chunkChecksum->getHashType())) {
-    tChunkChecksumV4_->setPieceHashes(std::move(tempChunkChecksumsV4_));
+    tChunkChecksumV4_->setPieceHashes(tempChunkChecksumsV4_);
     tEntry_->chunkChecksum = std::move(tChunkChecksumV4_);
   }
   tChunkChecksumV4_.reset();
@@ -479,7 +479,7 @@ void MetalinkParserController::commitChunkChecksumTransaction()
         std::begin(tempChunkChecksums_), std::end(tempChunkChecksums_),
         std::back_inserter(pieceHashes),
         [](const std::pair<size_t, std::string>& p) { return p.second; });
-    tChunkChecksum_->setPieceHashes(std::move(pieceHashes));
+    tChunkChecksum_->setPieceHashes(pieceHashes);
     tEntry_->chunkChecksum = std::move(tChunkChecksum_);
   }
   tChunkChecksum_.reset();
@@ -49,7 +49,6 @@
 #include "fmt.h"
 #include "Logger.h"
 #include "LogFactory.h"
-#include "SimpleRandomizer.h"
 #include "WrDiskCacheEntry.h"
 #include "OpenedFileCounter.h"
 
@@ -57,6 +56,7 @@ namespace aria2 {
 
 DiskWriterEntry::DiskWriterEntry(const std::shared_ptr<FileEntry>& fileEntry)
     : fileEntry_{fileEntry},
+      pendingCacheLength_{0},
       open_{false},
       needsFileAllocation_{false},
       needsDiskWriter_{false}
@@ -109,6 +109,12 @@ void DiskWriterEntry::setDiskWriter(std::unique_ptr<DiskWriter> diskWriter)
   diskWriter_ = std::move(diskWriter);
 }
 
+void DiskWriterEntry::updatePendingCacheLength(int64_t delta)
+{
+  pendingCacheLength_ = std::max(static_cast<int64_t>(0),
+                                 pendingCacheLength_ + delta);
+}
+
 bool DiskWriterEntry::operator<(const DiskWriterEntry& entry) const
 {
   return *fileEntry_ < *entry.fileEntry_;
@@ -130,8 +136,12 @@ createDiskWriterEntry(const std::shared_ptr<FileEntry>& fileEntry)
 
 void MultiDiskAdaptor::resetDiskWriterEntries()
 {
-  assert(openedDiskWriterEntries_.empty());
+  assert(std::none_of(std::begin(diskWriterEntries_),
+                      std::end(diskWriterEntries_),
+                      std::mem_fn(&DiskWriterEntry::isOpen)));
   diskWriterEntries_.clear();
+  fileOffsetIndex_.reset(std::begin(getFileEntries()),
+                         std::end(getFileEntries()));
   if (getFileEntries().empty()) {
     return;
   }
@@ -194,38 +204,21 @@ void MultiDiskAdaptor::resetDiskWriterEntries()
   }
 }
 
-size_t MultiDiskAdaptor::tryCloseFile(size_t numClose)
-{
-  size_t left = numClose;
-  for (; !openedDiskWriterEntries_.empty() && left > 0; --left) {
-    // Choose one DiskWriterEntry randomly and close it.
-    size_t index = SimpleRandomizer::getInstance()->getRandomNumber(
-        openedDiskWriterEntries_.size());
-    auto i = std::begin(openedDiskWriterEntries_);
-    std::advance(i, index);
-    (*i)->closeFile();
-    (*i) = openedDiskWriterEntries_.back();
-    openedDiskWriterEntries_.pop_back();
-  }
-  return numClose - left;
-}
-
 void MultiDiskAdaptor::openIfNot(DiskWriterEntry* entry,
                                  void (DiskWriterEntry::*open)())
 {
+  auto& openedFileCounter = getOpenedFileCounter();
   if (!entry->isOpen()) {
-    // A2_LOG_NOTICE(fmt("DiskWriterEntry: Cache MISS. offset=%s",
-    //        util::itos(entry->getFileEntry()->getOffset()).c_str()));
-    auto& openedFileCounter = getOpenedFileCounter();
     if (openedFileCounter) {
       openedFileCounter->ensureMaxOpenFileLimit(1);
     }
     (entry->*open)();
-    openedDiskWriterEntries_.push_back(entry);
+    if (openedFileCounter && entry->isOpen()) {
+      openedFileCounter->fileOpened(entry);
+    }
   }
-  else {
-    // A2_LOG_NOTICE(fmt("DiskWriterEntry: Cache HIT. offset=%s",
-    //        util::itos(entry->getFileEntry()->getOffset()).c_str()));
+  else if (openedFileCounter) {
+    openedFileCounter->fileAccessed(entry);
   }
 }
 
@@ -262,19 +255,16 @@ void MultiDiskAdaptor::openExistingFile()
 
 void MultiDiskAdaptor::closeFile()
 {
-  for (auto& dwent : openedDiskWriterEntries_) {
-    auto& dw = dwent->getDiskWriter();
-    // required for unit test
-    if (!dw) {
+  auto& openedFileCounter = getOpenedFileCounter();
+  for (auto& dwent : diskWriterEntries_) {
+    if (!dwent->isOpen()) {
       continue;
     }
-    dw->closeFile();
-  }
-  auto& openedFileCounter = getOpenedFileCounter();
-  if (openedFileCounter) {
-    openedFileCounter->reduceNumOfOpenedFile(openedDiskWriterEntries_.size());
+    dwent->closeFile();
+    if (openedFileCounter) {
+      openedFileCounter->fileClosed(dwent.get());
+    }
   }
-  openedDiskWriterEntries_.clear();
 }
 
 namespace {
@@ -297,31 +287,20 @@ ssize_t calculateLength(DiskWriterEntry* entry, int64_t fileOffset, ssize_t rem)
 }
 } // namespace
 
-namespace {
-class OffsetCompare {
-public:
-  bool operator()(int64_t offset, const std::unique_ptr<DiskWriterEntry>& dwe)
-  {
-    return offset < dwe->getFileEntry()->getOffset();
-  }
-};
-} // namespace
-
 namespace {
 DiskWriterEntries::const_iterator
 findFirstDiskWriterEntry(const DiskWriterEntries& diskWriterEntries,
+                         const FileOffsetIndex& fileOffsetIndex,
                          int64_t offset)
 {
-  auto first =
-      std::upper_bound(std::begin(diskWriterEntries),
-                       std::end(diskWriterEntries), offset, OffsetCompare());
-  --first;
+  auto i = fileOffsetIndex.find(offset);
   // In case when offset is out-of-range
-  if (!isInRange((*first).get(), offset)) {
+  if (i == FileOffsetIndex::npos ||
+      !isInRange(diskWriterEntries[i].get(), offset)) {
     throw DL_ABORT_EX(
         fmt(EX_FILE_OFFSET_OUT_OF_RANGE, static_cast<int64_t>(offset)));
   }
-  return first;
+  return std::begin(diskWriterEntries) + i;
 }
 } // namespace
 
@@ -337,7 +316,8 @@ void throwOnDiskWriterNotOpened(DiskWriterEntry* e, int64_t offset)
 void MultiDiskAdaptor::writeData(const unsigned char* data, size_t len,
                                  int64_t offset)
 {
-  auto first = findFirstDiskWriterEntry(diskWriterEntries_, offset);
+  auto first =
+      findFirstDiskWriterEntry(diskWriterEntries_, fileOffsetIndex_, offset);
   ssize_t rem = len;
   int64_t fileOffset = offset - (*first)->getFileEntry()->getOffset();
   for (auto i = first, eoi = diskWriterEntries_.cend(); i != eoi; ++i) {
@@ -372,7 +352,8 @@ ssize_t MultiDiskAdaptor::readDataDropCache(unsigned char* data, size_t len,
 ssize_t MultiDiskAdaptor::readData(unsigned char* data, size_t len,
                                    int64_t offset, bool dropCache)
 {
-  auto first = findFirstDiskWriterEntry(diskWriterEntries_, offset);
+  auto first =
+      findFirstDiskWriterEntry(diskWriterEntries_, fileOffsetIndex_, offset);
   ssize_t rem = len;
   ssize_t totalReadLength = 0;
   int64_t fileOffset = offset - (*first)->getFileEntry()->getOffset();
@@ -419,6 +400,38 @@ void MultiDiskAdaptor::writeCache(const WrDiskCacheEntry* entry)
   }
 }
 
+void MultiDiskAdaptor::updatePendingCacheLength(int64_t goff, int64_t len,
+                                                int sign)
+{
+  auto index = fileOffsetIndex_.find(goff);
+  if (index == FileOffsetIndex::npos) {
+    return;
+  }
+  auto i = std::begin(diskWriterEntries_) + index;
+  for (auto eoi = std::end(diskWriterEntries_); i != eoi && len > 0; ++i) {
+    auto& fileEntry = (*i)->getFileEntry();
+    int64_t fileOffset = goff - fileEntry->getOffset();
+    if (fileOffset >= fileEntry->getLength()) {
+      // zero length file or offset is out-of-range
+      continue;
+    }
+    int64_t n = std::min(len, fileEntry->getLength() - fileOffset);
+    (*i)->updatePendingCacheLength(sign * n);
+    goff += n;
+    len -= n;
+  }
+}
+
+void MultiDiskAdaptor::addPendingCacheData(int64_t goff, size_t len)
+{
+  updatePendingCacheLength(goff, len, 1);
+}
+
+void MultiDiskAdaptor::removePendingCacheData(int64_t goff, size_t len)
+{
+  updatePendingCacheLength(goff, len, -1);
+}
+
 bool MultiDiskAdaptor::fileExists()
 {
   return std::find_if(std::begin(getFileEntries()), std::end(getFileEntries()),
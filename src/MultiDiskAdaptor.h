@@ -36,6 +36,7 @@
 #define D_MULTI_DISK_ADAPTOR_H
 
 #include "DiskAdaptor.h"
+#include "FileOffsetIndex.h"
 
 namespace aria2 {
 
@@ -47,6 +48,9 @@ class DiskWriterEntry {
 private:
   std::shared_ptr<FileEntry> fileEntry_;
   std::unique_ptr<DiskWriter> diskWriter_;
+  // The number of bytes of this file which are held in the write
+  // cache and not yet written to the disk.
+  int64_t pendingCacheLength_;
   bool open_;
   bool needsFileAllocation_;
   bool needsDiskWriter_;
@@ -88,6 +92,12 @@ public:
   bool needsDiskWriter() const { return needsDiskWriter_; }
 
   void needsDiskWriter(bool f) { needsDiskWriter_ = f; }
+
+  // Adds |delta| bytes to the amount of data pending in the write
+  // cache.  |delta| may be negative.
+  void updatePendingCacheLength(int64_t delta);
+
+  bool hasPendingCacheData() const { return pendingCacheLength_ > 0; }
 };
 
 typedef std::vector<std::unique_ptr<DiskWriterEntry>> DiskWriterEntries;
@@ -98,8 +108,8 @@ class MultiDiskAdaptor : public DiskAdaptor {
 private:
   int32_t pieceLength_;
   DiskWriterEntries diskWriterEntries_;
-
-  std::vector<DiskWriterEntry*> openedDiskWriterEntries_;
+  // Offsets of diskWriterEntries_, rebuilt with them.
+  FileOffsetIndex fileOffsetIndex_;
 
   bool readOnly_;
 
@@ -107,6 +117,8 @@ private:
 
   void openIfNot(DiskWriterEntry* entry, void (DiskWriterEntry::*f)());
 
+  void updatePendingCacheLength(int64_t goff, int64_t len, int sign);
+
   ssize_t readData(unsigned char* data, size_t len, int64_t offset,
                    bool dropCache);
 
@@ -135,6 +147,11 @@ public:
 
   virtual void writeCache(const WrDiskCacheEntry* entry) CXX11_OVERRIDE;
 
+  virtual void addPendingCacheData(int64_t goff, size_t len) CXX11_OVERRIDE;
+
+  virtual void removePendingCacheData(int64_t goff,
+                                      size_t len) CXX11_OVERRIDE;
+
   virtual bool fileExists() CXX11_OVERRIDE;
 
   virtual int64_t size() CXX11_OVERRIDE;
@@ -164,8 +181,6 @@ public:
   {
     return diskWriterEntries_;
   }
-
-  virtual size_t tryCloseFile(size_t numClose) CXX11_OVERRIDE;
 };
 
 } // namespace aria2
@@ -35,18 +35,22 @@
 #include "OpenedFileCounter.h"
 
 #include <cassert>
+#include <algorithm>
 
-#include "RequestGroupMan.h"
-#include "RequestGroup.h"
-#include "PieceStorage.h"
-#include "DiskAdaptor.h"
-#include "SimpleRandomizer.h"
+#include "MultiDiskAdaptor.h"
+#include "LogFactory.h"
+#include "Logger.h"
+#include "fmt.h"
 
 namespace aria2 {
 
 OpenedFileCounter::OpenedFileCounter(RequestGroupMan* rgman,
                                      size_t maxOpenFiles)
-    : rgman_(rgman), maxOpenFiles_(maxOpenFiles), numOpenFiles_(0)
+    : rgman_(rgman),
+      maxOpenFiles_(maxOpenFiles),
+      numHits_(0),
+      numMisses_(0),
+      numEvictions_(0)
 {
 }
 
@@ -56,58 +60,84 @@ void OpenedFileCounter::ensureMaxOpenFileLimit(size_t numNewFiles)
     return;
   }
 
-  if (numOpenFiles_ + numNewFiles <= maxOpenFiles_) {
-    numOpenFiles_ += numNewFiles;
+  if (lru_.size() + numNewFiles <= maxOpenFiles_) {
     return;
   }
   assert(numNewFiles <= maxOpenFiles_);
-  size_t numClose = numOpenFiles_ + numNewFiles - maxOpenFiles_;
-  size_t left = numClose;
-
-  auto& requestGroups = rgman_->getRequestGroups();
-
-  auto mark = std::begin(requestGroups);
-  std::advance(mark, SimpleRandomizer::getInstance()->getRandomNumber(
-                         requestGroups.size()));
-
-  auto closeFun = [&left](const std::shared_ptr<RequestGroup>& group) {
-    auto& ps = group->getPieceStorage();
-
-    if (!ps) {
-      return;
-    }
-
-    auto diskAdaptor = ps->getDiskAdaptor();
-
-    if (!diskAdaptor) {
-      return;
+  size_t numClose = lru_.size() + numNewFiles - maxOpenFiles_;
+
+  for (; numClose > 0 && !lru_.empty(); --numClose) {
+    // Closing a file which still has data in the write cache just
+    // makes the cache flush reopen it shortly, so prefer the ones
+    // without pending data.
+    auto victim = std::find_if(std::begin(lru_), std::end(lru_),
+                               [](DiskWriterEntry* entry) {
+                                 return !entry->hasPendingCacheData();
+                               });
+    if (victim == std::end(lru_)) {
+      victim = std::begin(lru_);
     }
+    auto entry = *victim;
+    index_.erase(entry);
+    lru_.erase(victim);
+    entry->closeFile();
+    ++numEvictions_;
+  }
+}
 
-    left -= diskAdaptor->tryCloseFile(left);
-  };
+void OpenedFileCounter::fileOpened(DiskWriterEntry* entry)
+{
+  if (!rgman_) {
+    return;
+  }
 
-  for (auto i = mark; i != std::end(requestGroups) && left > 0; ++i) {
-    closeFun(*i);
+  ++numMisses_;
+  auto i = index_.find(entry);
+  if (i != std::end(index_)) {
+    lru_.splice(std::end(lru_), lru_, (*i).second);
+    return;
   }
+  index_.emplace(entry, lru_.insert(std::end(lru_), entry));
+}
 
-  for (auto i = std::begin(requestGroups); i != mark && left > 0; ++i) {
-    closeFun(*i);
+void OpenedFileCounter::fileAccessed(DiskWriterEntry* entry)
+{
+  if (!rgman_) {
+    return;
   }
 
-  assert(left == 0);
-  numOpenFiles_ += numNewFiles - numClose;
+  auto i = index_.find(entry);
+  if (i == std::end(index_)) {
+    return;
+  }
+  ++numHits_;
+  lru_.splice(std::end(lru_), lru_, (*i).second);
 }
 
-void OpenedFileCounter::reduceNumOfOpenedFile(size_t numCloseFiles)
+void OpenedFileCounter::fileClosed(DiskWriterEntry* entry)
 {
   if (!rgman_) {
     return;
   }
 
-  assert(numOpenFiles_ >= numCloseFiles);
-  numOpenFiles_ -= numCloseFiles;
+  auto i = index_.find(entry);
+  if (i == std::end(index_)) {
+    return;
+  }
+  lru_.erase((*i).second);
+  index_.erase(i);
 }
 
-void OpenedFileCounter::deactivate() { rgman_ = nullptr; }
+void OpenedFileCounter::deactivate()
+{
+  if (rgman_) {
+    A2_LOG_DEBUG(fmt("OpenedFileCounter: hits=%" PRIu64 ", misses=%" PRIu64
+                     ", evictions=%" PRIu64,
+                     numHits_, numMisses_, numEvictions_));
+  }
+  rgman_ = nullptr;
+  lru_.clear();
+  index_.clear();
+}
 
 } // namespace aria2
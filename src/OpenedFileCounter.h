@@ -37,10 +37,17 @@
 
 #include "common.h"
 
+#include <list>
+#include <unordered_map>
+
 namespace aria2 {
 
 class RequestGroupMan;
+class DiskWriterEntry;
 
+// Keeps track of the files opened by MultiDiskAdaptor across all
+// RequestGroups and closes the least recently used ones when the
+// global limit is exceeded.
 class OpenedFileCounter {
 public:
   OpenedFileCounter(RequestGroupMan* rgman, size_t maxOpenFiles);
@@ -48,24 +55,51 @@ public:
   // Keeps the number of open files under the global limit specified
   // in the option.  The caller requests that |numNewFiles| files are
   // going to be opened.  This function requires that |numNewFiles| is
-  // less than or equal to the limit.
+  // less than or equal to the limit.  The least recently used files
+  // are closed first.  Files which have data pending in the write
+  // cache are skipped unless there is no other candidate.
   //
   // Currently the only download using MultiDiskAdaptor is affected by
   // the global limit.
   void ensureMaxOpenFileLimit(size_t numNewFiles);
 
-  // Reduces the number of open files managed by this object.
-  void reduceNumOfOpenedFile(size_t numCloseFiles);
+  // Records that |entry| has just been opened.  |entry| becomes the
+  // most recently used file.
+  void fileOpened(DiskWriterEntry* entry);
+
+  // Records that already opened |entry| is accessed again.
+  void fileAccessed(DiskWriterEntry* entry);
+
+  // Records that |entry| has been closed by its owner.
+  void fileClosed(DiskWriterEntry* entry);
 
   void setMaxOpenFiles(size_t maxOpenFiles) { maxOpenFiles_ = maxOpenFiles; }
 
+  size_t getNumOpenFiles() const { return lru_.size(); }
+
+  // The number of accesses to the files which were already opened.
+  uint64_t getNumHits() const { return numHits_; }
+
+  // The number of accesses which required the file to be opened.
+  uint64_t getNumMisses() const { return numMisses_; }
+
+  // The number of files closed to keep the global limit.
+  uint64_t getNumEvictions() const { return numEvictions_; }
+
   // Deactivates this object.
   void deactivate();
 
 private:
   RequestGroupMan* rgman_;
   size_t maxOpenFiles_;
-  size_t numOpenFiles_;
+  uint64_t numHits_;
+  uint64_t numMisses_;
+  uint64_t numEvictions_;
+  // Opened files in least recently used order.  The front is the
+  // least recently used one.
+  std::list<DiskWriterEntry*> lru_;
+  std::unordered_map<DiskWriterEntry*, std::list<DiskWriterEntry*>::iterator>
+      index_;
 };
 
 } // namespace aria2
@@ -36,65 +36,100 @@
 
 #include <cstdlib>
 #include <cstring>
+#include <algorithm>
 
-#include "bitfield.h"
+#include "A2STR.h"
 
 namespace aria2 {
 
-Option::Option()
-    : table_(option::countOption()), use_((option::countOption() + 7) / 8)
-{
-}
+Option::Option() = default;
 
 Option::~Option() = default;
 
 Option::Option(const Option& option) = default;
 
-Option& Option::operator=(const Option& option)
-{
-  if (this != &option) {
-    table_ = option.table_;
-    use_ = option.use_;
-    parent_ = option.parent_;
-  }
-  return *this;
-}
+Option& Option::operator=(const Option& option) = default;
 
 namespace {
+struct PrefIndexLess {
+  template <typename T>
+  bool operator()(const std::pair<size_t, T>& lhs, size_t rhs) const
+  {
+    return lhs.first < rhs;
+  }
+};
+} // namespace
 
-template <typename V> void setBit(V& b, PrefPtr pref)
+namespace {
+// Returns shared string of |value|.  Very common values share one
+// string object.
+std::shared_ptr<const std::string> makeValue(const std::string& value)
 {
-  b[pref->i / 8] |= 128 >> (pref->i % 8);
+  static auto emptyValue = std::make_shared<const std::string>();
+  static auto trueValue = std::make_shared<const std::string>(A2_V_TRUE);
+  static auto falseValue = std::make_shared<const std::string>(A2_V_FALSE);
+  if (value.empty()) {
+    return emptyValue;
+  }
+  if (value == A2_V_TRUE) {
+    return trueValue;
+  }
+  if (value == A2_V_FALSE) {
+    return falseValue;
+  }
+  return std::make_shared<const std::string>(value);
 }
+} // namespace
 
-template <typename V> void unsetBit(V& b, PrefPtr pref)
+const std::string* Option::findLocal(PrefPtr pref) const
 {
-  b[pref->i / 8] &= ~(128 >> (pref->i % 8));
+  if (!table_) {
+    return nullptr;
+  }
+  auto i = std::lower_bound(std::begin(*table_), std::end(*table_), pref->i,
+                            PrefIndexLess());
+  if (i == std::end(*table_) || (*i).first != pref->i) {
+    return nullptr;
+  }
+  return (*i).second.get();
 }
 
-} // namespace
+Option::Table& Option::getMutableTable()
+{
+  if (!table_) {
+    table_ = std::make_shared<Table>();
+  }
+  else if (table_.use_count() > 1) {
+    table_ = std::make_shared<Table>(*table_);
+  }
+  return *table_;
+}
 
 void Option::put(PrefPtr pref, const std::string& value)
 {
-  setBit(use_, pref);
-  table_[pref->i] = value;
+  auto& table = getMutableTable();
+  auto i = std::lower_bound(std::begin(table), std::end(table), pref->i,
+                            PrefIndexLess());
+  if (i != std::end(table) && (*i).first == pref->i) {
+    (*i).second = makeValue(value);
+  }
+  else {
+    table.insert(i, std::make_pair(pref->i, makeValue(value)));
+  }
 }
 
 bool Option::defined(PrefPtr pref) const
 {
-  return bitfield::test(use_, use_.size() * 8, pref->i) ||
-         (parent_ && parent_->defined(pref));
+  return findLocal(pref) || (parent_ && parent_->defined(pref));
 }
 
-bool Option::definedLocal(PrefPtr pref) const
-{
-  return bitfield::test(use_, use_.size() * 8, pref->i);
-}
+bool Option::definedLocal(PrefPtr pref) const { return findLocal(pref); }
 
 bool Option::blank(PrefPtr pref) const
 {
-  if (bitfield::test(use_, use_.size() * 8, pref->i)) {
-    return table_[pref->i].empty();
+  auto value = findLocal(pref);
+  if (value) {
+    return value->empty();
   }
   else {
     return !parent_ || parent_->blank(pref);
@@ -103,8 +138,9 @@ bool Option::blank(PrefPtr pref) const
 
 const std::string& Option::get(PrefPtr pref) const
 {
-  if (bitfield::test(use_, use_.size() * 8, pref->i)) {
-    return table_[pref->i];
+  auto value = findLocal(pref);
+  if (value) {
+    return *value;
   }
   else if (parent_) {
     return parent_->get(pref);
@@ -151,8 +187,12 @@ double Option::getAsDouble(PrefPtr pref) const
 
 void Option::removeLocal(PrefPtr pref)
 {
-  unsetBit(use_, pref);
-  table_[pref->i].clear();
+  if (!findLocal(pref)) {
+    return;
+  }
+  auto& table = getMutableTable();
+  table.erase(std::lower_bound(std::begin(table), std::end(table), pref->i,
+                               PrefIndexLess()));
 }
 
 void Option::remove(PrefPtr pref)
@@ -163,21 +203,33 @@ void Option::remove(PrefPtr pref)
   }
 }
 
-void Option::clear()
-{
-  std::fill(use_.begin(), use_.end(), 0);
-  std::fill(table_.begin(), table_.end(), "");
-}
+void Option::clear() { table_.reset(); }
 
 void Option::merge(const Option& option)
 {
-  size_t bits = option.use_.size() * 8;
-  for (size_t i = 1, len = table_.size(); i < len; ++i) {
-    if (bitfield::test(option.use_, bits, i)) {
-      use_[i / 8] |= 128 >> (i % 8);
-      table_[i] = option.table_[i];
+  if (!option.table_) {
+    return;
+  }
+  if (!table_) {
+    table_ = option.table_;
+    return;
+  }
+  // Both tables are sorted, so merge them in one pass.  Values are
+  // immutable and can be shared.
+  Table table;
+  table.reserve(table_->size() + option.table_->size());
+  auto i = std::begin(*table_), eoi = std::end(*table_);
+  for (auto& e : *option.table_) {
+    for (; i != eoi && (*i).first < e.first; ++i) {
+      table.push_back(*i);
+    }
+    if (i != eoi && (*i).first == e.first) {
+      ++i;
     }
+    table.push_back(e);
   }
+  table.insert(std::end(table), i, eoi);
+  table_ = std::make_shared<Table>(std::move(table));
 }
 
 void Option::setParent(const std::shared_ptr<Option>& parent)
@@ -187,10 +239,6 @@ void Option::setParent(const std::shared_ptr<Option>& parent)
 
 const std::shared_ptr<Option>& Option::getParent() const { return parent_; }
 
-bool Option::emptyLocal() const
-{
-  size_t dst;
-  return !bitfield::getFirstSetBitIndex(dst, use_, use_.size() * 8);
-}
+bool Option::emptyLocal() const { return !table_ || table_->empty(); }
 
 } // namespace aria2
@@ -47,16 +47,32 @@ namespace aria2 {
 
 class Option {
 private:
-  std::vector<std::string> table_;
-  std::vector<unsigned char> use_;
+  // Option values defined in this object, sorted by Pref::i.  Most
+  // Option objects only override a few values over parent_, so this
+  // is much smaller than a table of all options.  Values are held by
+  // pointer so that references returned by get() stay valid when
+  // other values are put.
+  typedef std::vector<std::pair<size_t, std::shared_ptr<const std::string>>>
+      Table;
+  // The table is shared between copies of Option until one of them
+  // modifies it.  nullptr means no option value is defined.
+  std::shared_ptr<Table> table_;
   std::shared_ptr<Option> parent_;
 
+  // Returns pointer to the value of |pref| in this object, or nullptr
+  // if it is not defined.
+  const std::string* findLocal(PrefPtr pref) const;
+  // Returns the table which is not shared with other Option object.
+  Table& getMutableTable();
+
 public:
   Option();
   ~Option();
   Option(const Option& option);
   Option& operator=(const Option& option);
 
+  // Sets |value| to |pref|.  This invalidates the reference returned
+  // by get() for |pref| before this call.
   void put(PrefPtr pref, const std::string& value);
   // Returns true if name is defined. Otherwise returns false.  Note
   // that even if the value is a empty string, this method returns
@@ -69,7 +85,9 @@ public:
   // Otherwise returns false.
   bool blank(PrefPtr pref) const;
   // Returns option value for |pref|. If the |pref| is not defined in
-  // this object, parent_ is looked up.
+  // this object, parent_ is looked up.  The returned reference stays
+  // valid until |pref| is put or removed in the object which holds
+  // the value; putting other prefs does not invalidate it.
   const std::string& get(PrefPtr pref) const;
   int32_t getAsInt(PrefPtr pref) const;
   int64_t getAsLLInt(PrefPtr pref) const;
@@ -83,9 +101,6 @@ public:
   // Removes all option values from this object. This function does
   // not modify parent_.
   void clear();
-  // Returns the option value table of this object. It does not
-  // contain option values in parent_ and so forth.
-  const std::vector<std::string>& getTable() const { return table_; }
   // Copy option values defined in option to this option. parent_ is
   // left unmodified for this object.
   void merge(const Option& option);
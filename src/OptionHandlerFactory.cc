@@ -1622,12 +1622,39 @@ std::vector<OptionHandler*> OptionHandlerFactory::createOptionHandlers()
     op->setChangeOptionForReserved(true);
     handlers.push_back(op);
   }
+  {
+    OptionHandler* op(new BooleanOptionHandler(PREF_BT_REUSE_PORT,
+                                               TEXT_BT_REUSE_PORT, A2_V_FALSE,
+                                               OptionHandler::OPT_ARG));
+    op->addTag(TAG_BITTORRENT);
+    handlers.push_back(op);
+  }
   {
     OptionHandler* op(new NumberOptionHandler(PREF_BT_REQUEST_TIMEOUT,
                                               NO_DESCRIPTION, "60", 1, 600));
     op->hide();
     handlers.push_back(op);
   }
+  {
+    OptionHandler* op(new ParameterOptionHandler(
+        PREF_BT_SEED_CHOKING_ALGORITHM, TEXT_BT_SEED_CHOKING_ALGORITHM,
+        V_ROUND_ROBIN, {V_ROUND_ROBIN, V_FASTEST_UPLOAD, V_ANTI_LEECH}));
+    op->addTag(TAG_BITTORRENT);
+    op->setInitialOption(true);
+    op->setChangeGlobalOption(true);
+    op->setChangeOptionForReserved(true);
+    handlers.push_back(op);
+  }
+  {
+    OptionHandler* op(new NumberOptionHandler(PREF_BT_UPLOAD_SLOT_TARGET,
+                                              TEXT_BT_UPLOAD_SLOT_TARGET, "0",
+                                              0, 100));
+    op->addTag(TAG_BITTORRENT);
+    op->setInitialOption(true);
+    op->setChangeGlobalOption(true);
+    op->setChangeOptionForReserved(true);
+    handlers.push_back(op);
+  }
   {
     OptionHandler* op(new BooleanOptionHandler(
         PREF_BT_SEED_UNVERIFIED, TEXT_BT_SEED_UNVERIFIED, A2_V_FALSE,
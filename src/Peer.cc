@@ -248,6 +248,12 @@ size_t Peer::getBitfieldLength() const
   return res_->getBitfieldLength();
 }
 
+const PeerBitfield& Peer::getPeerBitfield() const
+{
+  assert(res_);
+  return res_->getPeerBitfield();
+}
+
 bool Peer::shouldBeChoking() const
 {
   assert(res_);
@@ -278,7 +284,7 @@ size_t Peer::countPeerAllowedIndexSet() const
   return res_->peerAllowedIndexSet().size();
 }
 
-const std::set<size_t>& Peer::getPeerAllowedIndexSet() const
+const std::vector<size_t>& Peer::getPeerAllowedIndexSet() const
 {
   assert(res_);
   return res_->peerAllowedIndexSet();
@@ -39,7 +39,7 @@
 
 #include <cassert>
 #include <string>
-#include <set>
+#include <vector>
 #include <algorithm>
 
 #include "TimerA2.h"
@@ -51,6 +51,7 @@
 namespace aria2 {
 
 class PeerSessionResource;
+class PeerBitfield;
 class BtMessageDispatcher;
 
 class Peer {
@@ -203,6 +204,11 @@ public:
 
   size_t getBitfieldLength() const;
 
+  // Returns the bitfield in its compact form.  Prefer this over
+  // getBitfield(), which may convert the bitfield to the byte array
+  // form permanently.
+  const PeerBitfield& getPeerBitfield() const;
+
   void setAllBitfield();
 
   /**
@@ -221,7 +227,7 @@ public:
 
   size_t countPeerAllowedIndexSet() const;
 
-  const std::set<size_t>& getPeerAllowedIndexSet() const;
+  const std::vector<size_t>& getPeerAllowedIndexSet() const;
 
   void addAmAllowedIndex(size_t index);
 
@@ -0,0 +1,234 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "PeerBitfield.h"
+
+#include <cstring>
+#include <algorithm>
+#include <map>
+
+#include "bitfield.h"
+
+namespace aria2 {
+
+namespace {
+// Returns all-ones bitfield of nbits bits.  Bitfields are shared
+// while they are referenced, so that seeders of the same torrent
+// take no memory for their bitfields.
+std::shared_ptr<const std::vector<unsigned char>>
+getAllSetBitfield(size_t nbits)
+{
+  static std::map<size_t, std::weak_ptr<const std::vector<unsigned char>>>
+      cache;
+  auto& entry = cache[nbits];
+  auto bitfield = entry.lock();
+  if (!bitfield) {
+    auto v = std::make_shared<std::vector<unsigned char>>((nbits + 7) / 8,
+                                                          0xffu);
+    v->back() = bitfield::lastByteMask(nbits);
+    bitfield = v;
+    entry = bitfield;
+  }
+  return bitfield;
+}
+} // namespace
+
+PeerBitfield::PeerBitfield(size_t nbits) : nbits_(nbits), count_(0) {}
+
+PeerBitfield::~PeerBitfield() = default;
+
+size_t PeerBitfield::getSparseLimit() const
+{
+  // The list of indexes must not take more than the half of the byte
+  // array form.
+  return getBitfieldLength() / 8;
+}
+
+void PeerBitfield::expand(unsigned char* dest) const
+{
+  memset(dest, 0, getBitfieldLength());
+  for (auto i : indexes_) {
+    dest[i / 8] |= 128 >> (i % 8);
+  }
+}
+
+void PeerBitfield::toDense() const
+{
+  dense_.resize(getBitfieldLength());
+  expand(dense_.data());
+  std::vector<uint32_t>().swap(indexes_);
+}
+
+void PeerBitfield::toAllSet()
+{
+  allSet_ = getAllSetBitfield(nbits_);
+  std::vector<unsigned char>().swap(dense_);
+  std::vector<uint32_t>().swap(indexes_);
+}
+
+bool PeerBitfield::isBitSet(size_t index) const
+{
+  if (allSet_) {
+    return index < nbits_;
+  }
+  if (!dense_.empty()) {
+    return bitfield::test(dense_, nbits_, index);
+  }
+  return std::binary_search(std::begin(indexes_), std::end(indexes_), index);
+}
+
+bool PeerBitfield::setBit(size_t index)
+{
+  if (index >= nbits_) {
+    return false;
+  }
+  if (allSet_) {
+    return true;
+  }
+  if (!dense_.empty()) {
+    unsigned char mask = 128 >> (index % 8);
+    if (dense_[index / 8] & mask) {
+      return true;
+    }
+    dense_[index / 8] |= mask;
+  }
+  else {
+    auto i = std::lower_bound(std::begin(indexes_), std::end(indexes_), index);
+    if (i != std::end(indexes_) && *i == index) {
+      return true;
+    }
+    if (indexes_.size() < getSparseLimit()) {
+      indexes_.insert(i, static_cast<uint32_t>(index));
+    }
+    else {
+      toDense();
+      dense_[index / 8] |= 128 >> (index % 8);
+    }
+  }
+  if (++count_ == nbits_) {
+    toAllSet();
+  }
+  return true;
+}
+
+bool PeerBitfield::unsetBit(size_t index)
+{
+  if (index >= nbits_) {
+    return false;
+  }
+  if (allSet_) {
+    dense_.assign(std::begin(*allSet_), std::end(*allSet_));
+    allSet_.reset();
+  }
+  if (!dense_.empty()) {
+    unsigned char mask = 128 >> (index % 8);
+    if (dense_[index / 8] & mask) {
+      dense_[index / 8] &= ~mask;
+      --count_;
+    }
+  }
+  else {
+    auto i = std::lower_bound(std::begin(indexes_), std::end(indexes_), index);
+    if (i != std::end(indexes_) && *i == index) {
+      indexes_.erase(i);
+      --count_;
+    }
+  }
+  return true;
+}
+
+void PeerBitfield::setAllBit()
+{
+  if (nbits_ == 0) {
+    return;
+  }
+  count_ = nbits_;
+  toAllSet();
+}
+
+void PeerBitfield::setBitfield(const unsigned char* bitfield,
+                               size_t bitfieldLength)
+{
+  if (getBitfieldLength() != bitfieldLength) {
+    return;
+  }
+  auto count = bitfield::countSetBit(bitfield, nbits_);
+  if (nbits_ > 0 && count == nbits_) {
+    setAllBit();
+    return;
+  }
+  allSet_.reset();
+  count_ = count;
+  if (count <= getSparseLimit()) {
+    std::vector<unsigned char>().swap(dense_);
+    indexes_.clear();
+    indexes_.reserve(count);
+    for (size_t i = 0; indexes_.size() < count; ++i) {
+      if (bitfield::test(bitfield, nbits_, i)) {
+        indexes_.push_back(i);
+      }
+    }
+  }
+  else {
+    dense_.assign(bitfield, bitfield + bitfieldLength);
+    std::vector<uint32_t>().swap(indexes_);
+  }
+}
+
+const unsigned char* PeerBitfield::getBitfield() const
+{
+  if (allSet_) {
+    return allSet_->data();
+  }
+  if (dense_.empty() && nbits_ > 0) {
+    toDense();
+  }
+  return dense_.data();
+}
+
+const unsigned char*
+PeerBitfield::getBitfield(std::vector<unsigned char>& buf) const
+{
+  if (allSet_) {
+    return allSet_->data();
+  }
+  if (!dense_.empty()) {
+    return dense_.data();
+  }
+  buf.resize(getBitfieldLength());
+  expand(buf.data());
+  return buf.data();
+}
+
+} // namespace aria2
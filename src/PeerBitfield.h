@@ -0,0 +1,124 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_PEER_BITFIELD_H
+#define D_PEER_BITFIELD_H
+
+#include "common.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace aria2 {
+
+// Bitfield of the pieces a remote peer has.  Unlike BitfieldMan, it
+// only tracks which pieces are available, and picks the cheapest
+// representation for it:
+//
+// * If all bits are set, the bitfield is a reference to an all-ones
+//   bitfield shared by all seeders of the same number of pieces.
+//
+// * If only a few bits are set, the bitfield is a sorted list of set
+//   indexes.  This is the case for leechers which just joined the
+//   swarm.
+//
+// * Otherwise, the bitfield is stored as is.
+class PeerBitfield {
+private:
+  size_t nbits_;
+  size_t count_;
+  // Non-null if all bits are set.
+  std::shared_ptr<const std::vector<unsigned char>> allSet_;
+  // Non-empty if the bitfield is stored as is.
+  mutable std::vector<unsigned char> dense_;
+  // Set indexes in ascending order if the bitfield is sparse.
+  mutable std::vector<uint32_t> indexes_;
+
+  size_t getSparseLimit() const;
+
+  void expand(unsigned char* dest) const;
+
+  void toDense() const;
+
+  void toAllSet();
+
+public:
+  explicit PeerBitfield(size_t nbits);
+
+  ~PeerBitfield();
+
+  size_t countBlock() const { return nbits_; }
+
+  size_t getBitfieldLength() const { return (nbits_ + 7) / 8; }
+
+  size_t countSetBit() const { return count_; }
+
+  bool isAllBitSet() const { return count_ == nbits_; }
+
+  // Returns true if the bitfield is stored as a list of set indexes.
+  bool isSparse() const { return !allSet_ && dense_.empty(); }
+
+  // Returns set indexes in ascending order.  Only valid if
+  // isSparse() is true.
+  const std::vector<uint32_t>& getSparseIndexes() const { return indexes_; }
+
+  bool isBitSet(size_t index) const;
+
+  // Returns false if index is out of range.
+  bool setBit(size_t index);
+
+  // Returns false if index is out of range.
+  bool unsetBit(size_t index);
+
+  void setAllBit();
+
+  // Does nothing if bitfieldLength does not match
+  // getBitfieldLength().
+  void setBitfield(const unsigned char* bitfield, size_t bitfieldLength);
+
+  // Returns the bitfield as a byte array.  If the bitfield is sparse,
+  // it is converted to the byte array form permanently.  Prefer the
+  // other overload in frequently called code.
+  const unsigned char* getBitfield() const;
+
+  // Returns the bitfield as a byte array.  If the bitfield is sparse,
+  // it is expanded into buf and buf.data() is returned.  This object
+  // is left intact.
+  const unsigned char* getBitfield(std::vector<unsigned char>& buf) const;
+};
+
+} // namespace aria2
+
+#endif // D_PEER_BITFIELD_H
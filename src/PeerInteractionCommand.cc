@@ -285,8 +285,7 @@ PeerInteractionCommand::PeerInteractionCommand(
 PeerInteractionCommand::~PeerInteractionCommand()
 {
   if (getPeer()->getCompletedLength() > 0) {
-    pieceStorage_->subtractPieceStats(getPeer()->getBitfield(),
-                                      getPeer()->getBitfieldLength());
+    pieceStorage_->subtractPieceStats(getPeer()->getPeerBitfield());
   }
   getPeer()->releaseSessionResource();
 
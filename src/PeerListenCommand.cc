@@ -40,6 +40,9 @@
 #include "DownloadEngine.h"
 #include "Peer.h"
 #include "RequestGroupMan.h"
+#include "BtRegistry.h"
+#include "Option.h"
+#include "prefs.h"
 #include "RecoverableException.h"
 #include "message.h"
 #include "ReceiverMSEHandshakeCommand.h"
@@ -49,15 +52,40 @@
 #include "SimpleRandomizer.h"
 #include "util.h"
 #include "fmt.h"
+#include "wallclock.h"
 
 namespace aria2 {
 
+const size_t PeerListenCommand::ACCEPT_BUDGET;
+
 PeerListenCommand::PeerListenCommand(cuid_t cuid, DownloadEngine* e, int family)
-    : Command(cuid), e_(e), family_(family)
+    : Command(cuid),
+      e_(e),
+      family_(family),
+      numAccepted_(0),
+      numRejected_(0),
+      numAcceptFailures_(0),
+      maxAcceptBatch_(0),
+      numAcceptedSinceLastLog_(0),
+      lastLog_(global::wallclock())
 {
 }
 
-PeerListenCommand::~PeerListenCommand() = default;
+PeerListenCommand::~PeerListenCommand()
+{
+  if (numAccepted_ > 0) {
+    logStat("accept statistics");
+  }
+}
+
+void PeerListenCommand::logStat(const char* msg) const
+{
+  A2_LOG_INFO(fmt("IPv%d BitTorrent: %s: accepted=%" PRIu64
+                  ", rejected=%" PRIu64 ", failed=%" PRIu64 ", max batch=%lu",
+                  family_ == AF_INET ? 4 : 6, msg, numAccepted_, numRejected_,
+                  numAcceptFailures_,
+                  static_cast<unsigned long>(maxAcceptBatch_)));
+}
 
 bool PeerListenCommand::bindPort(uint16_t& port, SegList<int>& sgl)
 {
@@ -73,6 +101,7 @@ bool PeerListenCommand::bindPort(uint16_t& port, SegList<int>& sgl)
        i != eoi; ++i) {
     port = *i;
     try {
+      socket_->setReusePort(e_->getOption()->getAsBool(PREF_BT_REUSE_PORT));
       socket_->bind(nullptr, port, family_);
       socket_->beginListen();
       A2_LOG_NOTICE(
@@ -97,17 +126,37 @@ uint16_t PeerListenCommand::getPort() const
   return socket_->getAddrInfo().port;
 }
 
+bool PeerListenCommand::rejectPeer(const std::string& ipaddr) const
+{
+  return e_->getBtRegistry()->isBadPeer(ipaddr);
+}
+
 bool PeerListenCommand::execute()
 {
   if (e_->isHaltRequested() || e_->getRequestGroupMan()->downloadFinished()) {
     return true;
   }
-  for (int i = 0; i < 3 && socket_->isReadable(0); ++i) {
+  // Drain the accept queue up to ACCEPT_BUDGET connections so that
+  // the backlog does not overflow when many peers connect at once.
+  size_t batch = 0;
+  for (; batch < ACCEPT_BUDGET; ++batch) {
     std::shared_ptr<SocketCore> peerSocket;
     try {
-      peerSocket = socket_->acceptConnection();
+      Endpoint endpoint;
+      peerSocket = socket_->acceptPendingConnection(endpoint);
+      if (!peerSocket) {
+        break;
+      }
+      ++numAccepted_;
+      ++numAcceptedSinceLastLog_;
+      if (rejectPeer(endpoint.addr)) {
+        ++numRejected_;
+        A2_LOG_DEBUG(fmt("Rejected the connection from %s:%u because it is"
+                         " marked bad.",
+                         endpoint.addr.c_str(), endpoint.port));
+        continue;
+      }
       peerSocket->applyIpDscp();
-      auto endpoint = peerSocket->getPeerInfo();
 
       auto peer = std::make_shared<Peer>(endpoint.addr, endpoint.port, true);
       cuid_t cuid = e_->newCUID();
@@ -119,9 +168,28 @@ bool PeerListenCommand::execute()
           "Added CUID#%" PRId64 " to receive BitTorrent/MSE handshake.", cuid));
     }
     catch (RecoverableException& ex) {
+      ++numAcceptFailures_;
       A2_LOG_DEBUG_EX(fmt(MSG_ACCEPT_FAILURE, getCuid()), ex);
+      // Errors like EMFILE are likely to persist.  Try again in the
+      // next execution.
+      break;
     }
   }
+  maxAcceptBatch_ = std::max(maxAcceptBatch_, batch);
+  if (numAcceptedSinceLastLog_ > 0 &&
+      lastLog_.difference(global::wallclock()) >= 1_min) {
+    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
+                       lastLog_.difference(global::wallclock()))
+                       .count();
+    A2_LOG_INFO(fmt("IPv%d BitTorrent: accepted %" PRIu64
+                    " connections in the last %ld seconds (%.1f/s)",
+                    family_ == AF_INET ? 4 : 6, numAcceptedSinceLastLog_,
+                    static_cast<long>(elapsed),
+                    static_cast<double>(numAcceptedSinceLastLog_) / elapsed));
+    logStat("accept statistics");
+    numAcceptedSinceLastLog_ = 0;
+    lastLog_ = global::wallclock();
+  }
   e_->addCommand(std::unique_ptr<Command>(this));
   return false;
 }
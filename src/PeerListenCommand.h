@@ -40,6 +40,7 @@
 #include <memory>
 
 #include "SegList.h"
+#include "TimerA2.h"
 
 namespace aria2 {
 
@@ -52,6 +53,23 @@ private:
   int family_;
   std::shared_ptr<SocketCore> socket_;
 
+  // Accept statistics.  numAccepted_ includes the connections
+  // rejected by early filtering.
+  uint64_t numAccepted_;
+  uint64_t numRejected_;
+  uint64_t numAcceptFailures_;
+  size_t maxAcceptBatch_;
+  // The number of connections accepted since the last time statistics
+  // were logged.
+  uint64_t numAcceptedSinceLastLog_;
+  Timer lastLog_;
+
+  // Returns true if the connection from endpoint should be dropped
+  // without starting handshake.
+  bool rejectPeer(const std::string& ipaddr) const;
+
+  void logStat(const char* msg) const;
+
 public:
   PeerListenCommand(cuid_t cuid, DownloadEngine* e, int family);
 
@@ -67,6 +85,13 @@ public:
 
   // Returns bound port
   uint16_t getPort() const;
+
+  uint64_t getNumAccepted() const { return numAccepted_; }
+
+  uint64_t getNumRejected() const { return numRejected_; }
+
+  // The maximum number of connections accepted per execution.
+  static const size_t ACCEPT_BUDGET = 64;
 };
 
 } // namespace aria2
@@ -37,7 +37,6 @@
 #include <cassert>
 #include <algorithm>
 
-#include "BitfieldMan.h"
 #include "A2STR.h"
 #include "BtMessageDispatcher.h"
 #include "wallclock.h"
@@ -45,9 +44,34 @@
 
 namespace aria2 {
 
+namespace {
+size_t countPiece(int32_t pieceLength, int64_t totalLength)
+{
+  if (pieceLength <= 0 || totalLength <= 0) {
+    return 0;
+  }
+  return (totalLength + pieceLength - 1) / pieceLength;
+}
+
+void insertIndex(std::vector<size_t>& indexes, size_t index)
+{
+  auto i = std::lower_bound(std::begin(indexes), std::end(indexes), index);
+  if (i == std::end(indexes) || *i != index) {
+    indexes.insert(i, index);
+  }
+}
+
+bool containsIndex(const std::vector<size_t>& indexes, size_t index)
+{
+  return std::binary_search(std::begin(indexes), std::end(indexes), index);
+}
+} // namespace
+
 PeerSessionResource::PeerSessionResource(int32_t pieceLength,
                                          int64_t totalLength)
-    : bitfieldMan_(make_unique<BitfieldMan>(pieceLength, totalLength)),
+    : pieceLength_(pieceLength),
+      totalLength_(totalLength),
+      bitfield_(countPiece(pieceLength, totalLength)),
       lastDownloadUpdate_(Timer::zero()),
       lastAmUnchoking_(Timer::zero()),
       dispatcher_(nullptr),
@@ -103,70 +127,70 @@ void PeerSessionResource::snubbing(bool b)
 
 bool PeerSessionResource::hasAllPieces() const
 {
-  return bitfieldMan_->isAllBitSet();
+  return bitfield_.isAllBitSet();
 }
 
 void PeerSessionResource::updateBitfield(size_t index, int operation)
 {
   if (operation == 1) {
-    bitfieldMan_->setBit(index);
+    bitfield_.setBit(index);
   }
   else if (operation == 0) {
-    bitfieldMan_->unsetBit(index);
+    bitfield_.unsetBit(index);
   }
 }
 
 void PeerSessionResource::setBitfield(const unsigned char* bitfield,
                                       size_t bitfieldLength)
 {
-  bitfieldMan_->setBitfield(bitfield, bitfieldLength);
+  bitfield_.setBitfield(bitfield, bitfieldLength);
 }
 
 const unsigned char* PeerSessionResource::getBitfield() const
 {
-  return bitfieldMan_->getBitfield();
+  return bitfield_.getBitfield();
 }
 
 size_t PeerSessionResource::getBitfieldLength() const
 {
-  return bitfieldMan_->getBitfieldLength();
+  return bitfield_.getBitfieldLength();
 }
 
 bool PeerSessionResource::hasPiece(size_t index) const
 {
-  return bitfieldMan_->isBitSet(index);
+  return bitfield_.isBitSet(index);
 }
 
-void PeerSessionResource::markSeeder() { bitfieldMan_->setAllBit(); }
+void PeerSessionResource::markSeeder() { bitfield_.setAllBit(); }
 
 void PeerSessionResource::fastExtensionEnabled(bool b)
 {
   fastExtensionEnabled_ = b;
 }
 
-const std::set<size_t>& PeerSessionResource::peerAllowedIndexSet() const
+const std::vector<size_t>& PeerSessionResource::peerAllowedIndexSet() const
 {
   return peerAllowedIndexSet_;
 }
 
 void PeerSessionResource::addPeerAllowedIndex(size_t index)
 {
-  peerAllowedIndexSet_.insert(index);
+  insertIndex(peerAllowedIndexSet_, index);
 }
 
 bool PeerSessionResource::peerAllowedIndexSetContains(size_t index) const
 {
-  return peerAllowedIndexSet_.count(index) == 1;
+  return containsIndex(peerAllowedIndexSet_, index);
 }
 
 void PeerSessionResource::addAmAllowedIndex(size_t index)
 {
-  amAllowedIndexSet_.insert(index);
+  insertIndex(amAllowedIndexSet_, index);
 }
 
 bool PeerSessionResource::amAllowedIndexSetContains(size_t index) const
 {
-  return amAllowedIndexSet_.count(index) == 1;
+  return containsIndex(amAllowedIndexSet_, index);
 }
 
 void PeerSessionResource::extendedMessagingEnabled(bool b)
@@ -219,7 +243,16 @@ void PeerSessionResource::updateDownload(int32_t bytes)
 
 int64_t PeerSessionResource::getCompletedLength() const
 {
-  return bitfieldMan_->getCompletedLength();
+  auto count = bitfield_.countSetBit();
+  if (count == 0) {
+    return 0;
+  }
+  auto nbits = bitfield_.countBlock();
+  if (bitfield_.isBitSet(nbits - 1)) {
+    return static_cast<int64_t>(count - 1) * pieceLength_ + totalLength_ -
+           static_cast<int64_t>(nbits - 1) * pieceLength_;
+  }
+  return static_cast<int64_t>(count) * pieceLength_;
 }
 
 void PeerSessionResource::setBtMessageDispatcher(BtMessageDispatcher* dpt)
@@ -235,7 +268,9 @@ size_t PeerSessionResource::countOutstandingUpload() const
 
 void PeerSessionResource::reconfigure(int32_t pieceLength, int64_t totalLenth)
 {
-  bitfieldMan_ = make_unique<BitfieldMan>(pieceLength, totalLenth);
+  pieceLength_ = pieceLength;
+  totalLength_ = totalLenth;
+  bitfield_ = PeerBitfield(countPiece(pieceLength, totalLenth));
 }
 
 } // namespace aria2
@@ -38,26 +38,29 @@
 #include "common.h"
 
 #include <string>
-#include <set>
+#include <vector>
 #include <memory>
 
 #include "BtConstants.h"
 #include "NetStat.h"
 #include "TimerA2.h"
 #include "ExtensionMessageRegistry.h"
+#include "PeerBitfield.h"
 
 namespace aria2 {
 
-class BitfieldMan;
 class BtMessageDispatcher;
 
 class PeerSessionResource {
 private:
-  std::unique_ptr<BitfieldMan> bitfieldMan_;
-  // fast index set which a peer has sent to localhost.
-  std::set<size_t> peerAllowedIndexSet_;
+  int32_t pieceLength_;
+  int64_t totalLength_;
+  PeerBitfield bitfield_;
+  // fast index set which a peer has sent to localhost.  The allowed
+  // fast set is small, so a sorted vector is used.
+  std::vector<size_t> peerAllowedIndexSet_;
   // fast index set which localhost has sent to a peer.
-  std::set<size_t> amAllowedIndexSet_;
+  std::vector<size_t> amAllowedIndexSet_;
   ExtensionMessageRegistry extreg_;
   NetStat netStat_;
 
@@ -137,6 +140,8 @@ public:
 
   size_t getBitfieldLength() const;
 
+  const PeerBitfield& getPeerBitfield() const { return bitfield_; }
+
   void reconfigure(int32_t pieceLength, int64_t totalLength);
 
   bool hasPiece(size_t index) const;
@@ -148,14 +153,14 @@ public:
   void fastExtensionEnabled(bool b);
 
   // fast index set which a peer has sent to localhost.
-  const std::set<size_t>& peerAllowedIndexSet() const;
+  const std::vector<size_t>& peerAllowedIndexSet() const;
 
   void addPeerAllowedIndex(size_t index);
 
   bool peerAllowedIndexSetContains(size_t index) const;
 
   // fast index set which localhost has sent to a peer.
-  const std::set<size_t>& amAllowedIndexSet() const
+  const std::vector<size_t>& amAllowedIndexSet() const
   {
     return amAllowedIndexSet_;
   }
@@ -369,6 +369,25 @@ size_t Piece::appendWrCache(WrDiskCache* diskCache, int64_t goff,
   return delta;
 }
 
+unsigned char* Piece::getWrCacheAppendBuffer(int64_t goff, size_t& len)
+{
+  if (!wrCache_) {
+    return nullptr;
+  }
+  return wrCache_->getAppendBuffer(goff, len);
+}
+
+void Piece::commitWrCacheAppend(WrDiskCache* diskCache, size_t len)
+{
+  if (!diskCache || len == 0) {
+    return;
+  }
+  assert(wrCache_);
+  wrCache_->commitAppend(len);
+  bool rv = diskCache->update(wrCache_.get(), len);
+  assert(rv);
+}
+
 void Piece::releaseWrCache(WrDiskCache* diskCache)
 {
   if (diskCache && wrCache_) {
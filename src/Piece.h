@@ -187,6 +187,12 @@ public:
   }
   size_t appendWrCache(WrDiskCache* diskCache, int64_t goff,
                        const unsigned char* data, size_t len);
+  // Returns the space in the cache where the data at |goff| can be
+  // written directly, storing its length in |len|.  Returns nullptr
+  // if there is no such space.  Use commitWrCacheAppend() to cache
+  // the written data.
+  unsigned char* getWrCacheAppendBuffer(int64_t goff, size_t& len);
+  void commitWrCacheAppend(WrDiskCache* diskCache, size_t len);
   void releaseWrCache(WrDiskCache* diskCache);
   WrDiskCacheEntry* getWrDiskCacheEntry() const { return wrCache_.get(); }
 };
@@ -0,0 +1,87 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_PIECE_HASHES_H
+#define D_PIECE_HASHES_H
+
+#include "common.h"
+
+#include <string>
+
+namespace aria2 {
+
+// Piece hashes of the same length concatenated in a single buffer.
+// The hash of piece i is at [i * hashLength, (i + 1) * hashLength).
+class PieceHashes {
+public:
+  PieceHashes();
+
+  // |data| is the concatenation of hashes, each of which is
+  // |hashLength| bytes long.
+  PieceHashes(std::string data, size_t hashLength);
+
+  // Concatenates hashes in range [first, last) of strings.  All
+  // hashes must have the same length.  Otherwise, no hash is stored.
+  template <typename InputIterator>
+  PieceHashes(InputIterator first, InputIterator last)
+      : hashLength_(first == last ? 0 : (*first).size())
+  {
+    for (; first != last; ++first) {
+      if ((*first).size() != hashLength_) {
+        data_.clear();
+        break;
+      }
+      data_ += *first;
+    }
+  }
+
+  // Returns the number of hashes.
+  size_t size() const;
+
+  // Returns the hash of piece |index|.  If it is not available,
+  // returns empty string.
+  std::string get(size_t index) const;
+
+  // Returns true if the hash of piece |index| is available and equals
+  // to |digest|.  Unlike get(), this does not make a copy of hash.
+  bool equals(size_t index, const std::string& digest) const;
+
+private:
+  std::string data_;
+  size_t hashLength_;
+};
+
+} // namespace aria2
+
+#endif // D_PIECE_HASHES_H
@@ -34,16 +34,22 @@
 /* copyright --> */
 #include "PieceStatMan.h"
 
+#include <cstring>
 #include <limits>
 #include <algorithm>
 
 #include "SimpleRandomizer.h"
 #include "bitfield.h"
+#include "PeerBitfield.h"
 
 namespace aria2 {
 
 PieceStatMan::PieceStatMan(size_t pieceNum, bool randomShuffle)
-    : order_(pieceNum), counts_(pieceNum)
+    : order_(pieceNum),
+      counts_(pieceNum),
+      numSeeders_(0),
+      pos_(pieceNum),
+      bucketStart_{0}
 {
   for (size_t i = 0; i < pieceNum; ++i) {
     order_[i] = i;
@@ -53,66 +59,262 @@ PieceStatMan::PieceStatMan(size_t pieceNum, bool randomShuffle)
     std::shuffle(order_.begin(), order_.end(),
                  *SimpleRandomizer::getInstance());
   }
+  // All pieces are in the bucket of count 0.
+  sorted_ = order_;
+  for (size_t i = 0; i < pieceNum; ++i) {
+    pos_[sorted_[i]] = i;
+  }
+  bucketStart_.push_back(pieceNum);
 }
 
 PieceStatMan::~PieceStatMan() = default;
 
+size_t PieceStatMan::getBucketStart(int count) const
+{
+  if (static_cast<size_t>(count) >= bucketStart_.size()) {
+    return sorted_.size();
+  }
+  return bucketStart_[count];
+}
+
+std::vector<int> PieceStatMan::getCounts() const
+{
+  std::vector<int> counts(counts_);
+  for (auto& c : counts) {
+    c += numSeeders_;
+  }
+  return counts;
+}
+
+void PieceStatMan::inc(size_t index)
+{
+  auto c = counts_[index] + numSeeders_;
+  if (c == std::numeric_limits<int>::max()) {
+    return;
+  }
+  if (bucketStart_.size() < static_cast<size_t>(c) + 3) {
+    bucketStart_.push_back(sorted_.size());
+  }
+  // Move index to the last position of its bucket, and then shrink
+  // the bucket so that index becomes the first piece of the next
+  // bucket.
+  auto last = bucketStart_[c + 1] - 1;
+  auto other = sorted_[last];
+  std::swap(sorted_[pos_[index]], sorted_[last]);
+  pos_[other] = pos_[index];
+  pos_[index] = last;
+  --bucketStart_[c + 1];
+  ++counts_[index];
+}
+
+void PieceStatMan::sub(size_t index)
+{
+  auto c = counts_[index] + numSeeders_;
+  if (c == 0) {
+    return;
+  }
+  // Move index to the first position of its bucket, and then shrink
+  // the bucket so that index becomes the last piece of the previous
+  // bucket.
+  auto first = bucketStart_[c];
+  auto other = sorted_[first];
+  std::swap(sorted_[pos_[index]], sorted_[first]);
+  pos_[other] = pos_[index];
+  pos_[index] = first;
+  ++bucketStart_[c];
+  --counts_[index];
+}
+
 namespace {
-void inc(int& x)
+struct ByteLoader {
+  const unsigned char* bitfield;
+
+  uint64_t word(size_t i) const
+  {
+    uint64_t v;
+    memcpy(&v, bitfield + i, sizeof(v));
+    return v;
+  }
+
+  unsigned char byte(size_t i) const { return bitfield[i]; }
+};
+} // namespace
+
+namespace {
+// Loads bytes of the symmetric difference of 2 bitfields.
+struct XorLoader {
+  const unsigned char* bitfield1;
+  const unsigned char* bitfield2;
+
+  uint64_t word(size_t i) const
+  {
+    uint64_t v1, v2;
+    memcpy(&v1, bitfield1 + i, sizeof(v1));
+    memcpy(&v2, bitfield2 + i, sizeof(v2));
+    return v1 ^ v2;
+  }
+
+  unsigned char byte(size_t i) const { return bitfield1[i] ^ bitfield2[i]; }
+};
+} // namespace
+
+namespace {
+template <typename F>
+void forEachSetBitInByte(unsigned char c, size_t base, F f)
 {
-  if (x < std::numeric_limits<int>::max()) {
-    ++x;
+  for (unsigned char mask = 0x80; c; mask >>= 1, ++base) {
+    if (c & mask) {
+      f(base);
+      c &= ~mask;
+    }
   }
 }
 } // namespace
 
 namespace {
-void sub(int& x)
+// Calls f(i) for each bit i set in the bitfield of nbits bits loaded
+// by loader.  The bitfield is read 64 bits at a time and zero words
+// are skipped, so that sparse bitfields are processed quickly.
+template <typename Loader, typename F>
+void forEachSetBit(const Loader& loader, size_t nbits, F f)
 {
-  if (x > 0) {
-    --x;
+  if (nbits == 0) {
+    return;
+  }
+  const size_t len = (nbits + 7) / 8;
+  size_t i = 0;
+  // The last byte is handled separately because it may contain
+  // trailing garbage bits.
+  for (; i + sizeof(uint64_t) < len; i += sizeof(uint64_t)) {
+    if (loader.word(i) == 0) {
+      continue;
+    }
+    for (size_t j = i; j < i + sizeof(uint64_t); ++j) {
+      forEachSetBitInByte(loader.byte(j), j * 8, f);
+    }
   }
+  for (; i < len - 1; ++i) {
+    forEachSetBitInByte(loader.byte(i), i * 8, f);
+  }
+  forEachSetBitInByte(loader.byte(len - 1) & bitfield::lastByteMask(nbits),
+                      (len - 1) * 8, f);
+}
+} // namespace
+
+namespace {
+bool isAllSet(const unsigned char* bitfield, size_t nbits)
+{
+  if (nbits == 0) {
+    return false;
+  }
+  const size_t len = (nbits + 7) / 8;
+  for (size_t i = 0; i < len - 1; ++i) {
+    if (bitfield[i] != 0xffu) {
+      return false;
+    }
+  }
+  auto mask = bitfield::lastByteMask(nbits);
+  return (bitfield[len - 1] & mask) == mask;
 }
 } // namespace
 
+bool PieceStatMan::addSeeder()
+{
+  // Seeder increments all counts by one, which does not change the
+  // order of pieces.  Fall back to per piece update if the largest
+  // count would overflow.
+  if (getCount(sorted_.back()) == std::numeric_limits<int>::max()) {
+    return false;
+  }
+  ++numSeeders_;
+  bucketStart_.insert(std::begin(bucketStart_), 0);
+  return true;
+}
+
+bool PieceStatMan::subtractSeeder()
+{
+  // We can take a shortcut only if no count is 0, because counts are
+  // not decremented below 0.
+  if (numSeeders_ == 0 || getBucketStart(1) != 0) {
+    return false;
+  }
+  --numSeeders_;
+  bucketStart_.erase(std::begin(bucketStart_));
+  return true;
+}
+
 void PieceStatMan::addPieceStats(const unsigned char* bitfield,
                                  size_t bitfieldLength)
 {
-  for (size_t i = 0, nbits = counts_.size(); i < nbits; ++i) {
-    if (bitfield::test(bitfield, nbits, i)) {
-      inc(counts_[i]);
-    }
+  const size_t nbits = counts_.size();
+  if (isAllSet(bitfield, nbits) && addSeeder()) {
+    return;
   }
+  forEachSetBit(ByteLoader{bitfield}, nbits, [this](size_t i) { inc(i); });
 }
 
 void PieceStatMan::subtractPieceStats(const unsigned char* bitfield,
                                       size_t bitfieldLength)
 {
-  for (size_t i = 0, nbits = counts_.size(); i < nbits; ++i) {
-    if (bitfield::test(bitfield, nbits, i)) {
-      sub(counts_[i]);
+  const size_t nbits = counts_.size();
+  if (isAllSet(bitfield, nbits) && subtractSeeder()) {
+    return;
+  }
+  forEachSetBit(ByteLoader{bitfield}, nbits, [this](size_t i) { sub(i); });
+}
+
+void PieceStatMan::addPieceStats(const PeerBitfield& bitfield)
+{
+  if (bitfield.countBlock() != counts_.size() || bitfield.countSetBit() == 0) {
+    return;
+  }
+  if (bitfield.isAllBitSet() && addSeeder()) {
+    return;
+  }
+  if (bitfield.isSparse()) {
+    for (auto i : bitfield.getSparseIndexes()) {
+      inc(i);
     }
+    return;
   }
+  forEachSetBit(ByteLoader{bitfield.getBitfield()}, counts_.size(),
+                [this](size_t i) { inc(i); });
+}
+
+void PieceStatMan::subtractPieceStats(const PeerBitfield& bitfield)
+{
+  if (bitfield.countBlock() != counts_.size() || bitfield.countSetBit() == 0) {
+    return;
+  }
+  if (bitfield.isAllBitSet() && subtractSeeder()) {
+    return;
+  }
+  if (bitfield.isSparse()) {
+    for (auto i : bitfield.getSparseIndexes()) {
+      sub(i);
+    }
+    return;
+  }
+  forEachSetBit(ByteLoader{bitfield.getBitfield()}, counts_.size(),
+                [this](size_t i) { sub(i); });
 }
 
 void PieceStatMan::updatePieceStats(const unsigned char* newBitfield,
                                     size_t newBitfieldLength,
                                     const unsigned char* oldBitfield)
 {
-  for (size_t i = 0, nbits = counts_.size(); i < nbits; ++i) {
-    bool inNew = bitfield::test(newBitfield, nbits, i);
-    bool inOld = bitfield::test(oldBitfield, nbits, i);
-    if (inNew) {
-      if (!inOld) {
-        inc(counts_[i]);
-      }
-    }
-    else if (inOld) {
-      sub(counts_[i]);
-    }
-  }
+  const size_t nbits = counts_.size();
+  forEachSetBit(XorLoader{newBitfield, oldBitfield}, nbits,
+                [this, newBitfield, nbits](size_t i) {
+                  if (bitfield::test(newBitfield, nbits, i)) {
+                    inc(i);
+                  }
+                  else {
+                    sub(i);
+                  }
+                });
 }
 
-void PieceStatMan::addPieceStats(size_t index) { inc(counts_[index]); }
+void PieceStatMan::addPieceStats(size_t index) { inc(index); }
 
 } // namespace aria2
@@ -37,14 +37,44 @@
 
 #include "common.h"
 
+#include <cstdint>
 #include <vector>
 
 namespace aria2 {
 
+class PeerBitfield;
+
 class PieceStatMan {
 private:
   std::vector<size_t> order_;
+  // The count of piece i is counts_[i] + numSeeders_.  Peers which
+  // have all pieces are counted in numSeeders_ in O(1), so counts_[i]
+  // may be negative if such peer loses a piece.
   std::vector<int> counts_;
+  int numSeeders_;
+  // Piece indexes sorted by counts_ in ascending order.  Pieces which
+  // have the same count occupy a contiguous range, which we call a
+  // bucket.  Pieces in the same bucket are initially ordered as in
+  // order_.  The index is maintained incrementally when counts
+  // change, so that the rarest pieces are found without scanning all
+  // pieces.
+  std::vector<size_t> sorted_;
+  // pos_[i] is the position of piece i in sorted_.
+  std::vector<size_t> pos_;
+  // bucketStart_[c] is the position of the first piece whose count is
+  // at least c in sorted_.  The bucket of count c is [bucketStart_[c],
+  // bucketStart_[c + 1]).
+  std::vector<size_t> bucketStart_;
+
+  void inc(size_t index);
+
+  void sub(size_t index);
+
+  // Counts a peer which has all pieces in O(1).  Returns false if the
+  // shortcut is not applicable.
+  bool addSeeder();
+
+  bool subtractSeeder();
 
 public:
   PieceStatMan(size_t pieceNum, bool randomShuffle);
@@ -57,13 +87,33 @@ public:
 
   void subtractPieceStats(const unsigned char* bitfield, size_t bitfieldLength);
 
+  // Same as the above, but skips the scan of bitfield if it is known
+  // to be all set or sparse.
+  void addPieceStats(const PeerBitfield& bitfield);
+
+  void subtractPieceStats(const PeerBitfield& bitfield);
+
   void updatePieceStats(const unsigned char* newBitfield,
                         size_t newBitfieldLength,
                         const unsigned char* oldBitfield);
 
   const std::vector<size_t>& getOrder() const { return order_; }
 
-  const std::vector<int>& getCounts() const { return counts_; }
+  // Returns the number of peers which have each piece.
+  std::vector<int> getCounts() const;
+
+  int getCount(size_t index) const { return counts_[index] + numSeeders_; }
+
+  // Returns the number of peers counted as seeders.  Bitfields with
+  // all bits set are counted here instead of per piece.
+  int getNumSeeders() const { return numSeeders_; }
+
+  // Returns piece indexes sorted by count in ascending order.
+  const std::vector<size_t>& getSortedIndexes() const { return sorted_; }
+
+  // Returns the position in getSortedIndexes() of the first piece
+  // whose count is at least count.
+  size_t getBucketStart(int count) const;
 };
 
 } // namespace aria2
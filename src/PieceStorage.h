@@ -52,6 +52,7 @@ class Peer;
 #endif // ENABLE_BITTORRENT
 class DiskAdaptor;
 class WrDiskCache;
+class PeerBitfield;
 
 class PieceStorage {
 public:
@@ -278,6 +279,12 @@ public:
   virtual void subtractPieceStats(const unsigned char* bitfield,
                                   size_t bitfieldLength) = 0;
 
+  // Same as the above, but takes the bitfield of a peer in its
+  // compact form.
+  virtual void addPieceStats(const PeerBitfield& bitfield) = 0;
+
+  virtual void subtractPieceStats(const PeerBitfield& bitfield) = 0;
+
   virtual void updatePieceStats(const unsigned char* newBitfield,
                                 size_t newBitfieldLength,
                                 const unsigned char* oldBitfield) = 0;
@@ -34,9 +34,6 @@
 /* copyright --> */
 #include "RarestPieceSelector.h"
 
-#include <limits>
-#include <algorithm>
-
 #include "PieceStatMan.h"
 #include "bitfield.h"
 
@@ -51,24 +48,18 @@ RarestPieceSelector::RarestPieceSelector(
 bool RarestPieceSelector::select(size_t& index, const unsigned char* bitfield,
                                  size_t nbits) const
 {
-  const std::vector<size_t>& order = pieceStatMan_->getOrder();
-  const std::vector<int>& counts = pieceStatMan_->getCounts();
-  int min = std::numeric_limits<int>::max();
-  size_t bestIdx = nbits;
-  for (size_t i = 0; i < nbits; ++i) {
-    size_t idx = order[i];
-    if (bitfield::test(bitfield, nbits, idx) && counts[idx] < min) {
-      min = counts[idx];
-      bestIdx = idx;
+  // Pieces are sorted by count, so the buckets of pieces with the
+  // same count are visited from the rarest one.  The first piece
+  // found in bitfield is in the lowest bucket which has a piece in
+  // bitfield.  The cost is proportional to the number of pieces
+  // rarer than the selected one, not to the number of pieces.
+  for (auto idx : pieceStatMan_->getSortedIndexes()) {
+    if (bitfield::test(bitfield, nbits, idx)) {
+      index = idx;
+      return true;
     }
   }
-  if (bestIdx == nbits) {
-    return false;
-  }
-  else {
-    index = bestIdx;
-    return true;
-  }
+  return false;
 }
 
 } // namespace aria2
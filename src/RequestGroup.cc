@@ -325,6 +325,11 @@ void RequestGroup::createInitialCommand(
     auto peerStorage = std::make_shared<DefaultPeerStorage>();
     peerStorage->setBtRuntime(btRuntime);
     peerStorage->setPieceStorage(pieceStorage_);
+    peerStorage->setSeedChokingAlgorithm(
+        option_->get(PREF_BT_SEED_CHOKING_ALGORITHM));
+    peerStorage->setMaxUploadSpeedLimit(maxUploadSpeedLimit_);
+    peerStorage->setUploadSlotTarget(
+        option_->getAsInt(PREF_BT_UPLOAD_SLOT_TARGET));
     peerStorage_ = peerStorage.get();
     if (progressInfoFile) {
       progressInfoFile->setPeerStorage(peerStorage);
@@ -1167,14 +1172,17 @@ bool RequestGroup::needsFileAllocation() const
          !pieceStorage_->getDiskAdaptor()->fileAllocationIterator()->finished();
 }
 
-std::shared_ptr<DownloadResult> RequestGroup::createDownloadResult() const
+std::shared_ptr<DownloadResult>
+RequestGroup::createDownloadResult(bool withFileEntries) const
 {
   A2_LOG_DEBUG(fmt("GID#%s - Creating DownloadResult.", gid_->toHex().c_str()));
   TransferStat st = calculateStat();
   auto res = std::make_shared<DownloadResult>();
   res->gid = gid_;
   res->attrs = downloadContext_->getAttributes();
-  res->fileEntries = downloadContext_->getFileEntries();
+  if (withFileEntries) {
+    res->setFileEntries(downloadContext_->getFileEntries());
+  }
   res->inMemoryDownload = inMemoryDownload_;
   res->sessionDownloadLength = st.sessionDownloadLength;
   res->sessionTime = std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -1287,6 +1295,16 @@ bool RequestGroup::doesUploadSpeedExceed()
   return maxUploadSpeedLimit_ > 0 && maxUploadSpeedLimit_ < spd;
 }
 
+void RequestGroup::setMaxUploadSpeedLimit(int speed)
+{
+  maxUploadSpeedLimit_ = speed;
+#ifdef ENABLE_BITTORRENT
+  if (peerStorage_) {
+    peerStorage_->setMaxUploadSpeedLimit(speed);
+  }
+#endif // ENABLE_BITTORRENT
+}
+
 void RequestGroup::saveControlFile() const
 {
   if (saveControlFile_) {
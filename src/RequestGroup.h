@@ -72,7 +72,7 @@ class URIResult;
 class RequestGroupMan;
 #ifdef ENABLE_BITTORRENT
 class BtRuntime;
-class PeerStorage;
+class DefaultPeerStorage;
 #endif // ENABLE_BITTORRENT
 
 class RequestGroup {
@@ -120,7 +120,7 @@ private:
 #ifdef ENABLE_BITTORRENT
   BtRuntime* btRuntime_;
 
-  PeerStorage* peerStorage_;
+  DefaultPeerStorage* peerStorage_;
 #endif // ENABLE_BITTORRENT
 
   // If this download generates another downloads when completed(for
@@ -397,7 +397,11 @@ public:
 
   void adjustFilename(const std::shared_ptr<BtProgressInfoFile>& infoFile);
 
-  std::shared_ptr<DownloadResult> createDownloadResult() const;
+  // If |withFileEntries| is false, files are not stored in the
+  // result.  Use it when the result is discarded right away and its
+  // files are not needed.
+  std::shared_ptr<DownloadResult>
+  createDownloadResult(bool withFileEntries = true) const;
 
   const std::shared_ptr<Option>& getOption() const { return option_; }
 
@@ -442,7 +446,7 @@ public:
 
   int getMaxUploadSpeedLimit() const { return maxUploadSpeedLimit_; }
 
-  void setMaxUploadSpeedLimit(int speed) { maxUploadSpeedLimit_ = speed; }
+  void setMaxUploadSpeedLimit(int speed);
 
   void setLastErrorCode(error_code::Value code, const char* message = "")
   {
@@ -797,8 +797,7 @@ void RequestGroupMan::formatDownloadResultFull(
       reinterpret_cast<const unsigned char*>(downloadResult->bitfield.data()),
       downloadResult->bitfield.size());
   bool head = true;
-  const std::vector<std::shared_ptr<FileEntry>>& fileEntries =
-      downloadResult->fileEntries;
+  auto fileEntries = downloadResult->getFileEntries();
   for (auto& f : fileEntries) {
     if (!f->isRequested()) {
       continue;
@@ -837,8 +836,7 @@ std::string RequestGroupMan::formatDownloadResult(
 {
   std::stringstream o;
   formatDownloadResultCommon(o, status, downloadResult);
-  const std::vector<std::shared_ptr<FileEntry>>& fileEntries =
-      downloadResult->fileEntries;
+  auto fileEntries = downloadResult->getFileEntries();
   writeFilePath(fileEntries.begin(), fileEntries.end(), o,
                 downloadResult->inMemoryDownload);
   return o.str();
@@ -339,6 +339,13 @@ public:
 
   void setUriListParser(const std::shared_ptr<UriListParser>& uriListParser);
 
+  // Returns the parser of the input file which has not been read
+  // completely with --deferred-input, or nullptr.
+  const std::shared_ptr<UriListParser>& getUriListParser() const
+  {
+    return uriListParser_;
+  }
+
   NetStat& getNetStat() { return netStat_; }
 
   WrDiskCache* getWrDiskCache() const { return wrDiskCache_.get(); }
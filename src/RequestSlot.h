@@ -39,6 +39,7 @@
 #include "TimerA2.h"
 #include "Piece.h"
 #include "wallclock.h"
+#include "FreeList.h"
 
 namespace aria2 {
 
@@ -64,6 +65,16 @@ public:
   {
   }
 
+  static void* operator new(size_t size)
+  {
+    return FreeList<RequestSlot>::allocate(size);
+  }
+
+  static void operator delete(void* p, size_t size)
+  {
+    FreeList<RequestSlot>::deallocate(p, size);
+  }
+
   bool operator==(const RequestSlot& requestSlot) const
   {
     return index_ == requestSlot.index_ && begin_ == requestSlot.begin_ &&
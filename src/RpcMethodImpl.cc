@@ -74,6 +74,7 @@
 #include "BtRegistry.h"
 #include "PeerStorage.h"
 #include "Peer.h"
+#include "PeerBitfield.h"
 #include "BtRuntime.h"
 #include "BtAnnounce.h"
 #endif // ENABLE_BITTORRENT
@@ -119,6 +120,8 @@ const char KEY_PORT[] = "port";
 const char KEY_AM_CHOKING[] = "amChoking";
 const char KEY_PEER_CHOKING[] = "peerChoking";
 const char KEY_SEEDER[] = "seeder";
+const char KEY_SNUBBED[] = "snubbed";
+const char KEY_OPTIMISTIC_UNCHOKE[] = "optimisticUnchoke";
 const char KEY_INDEX[] = "index";
 const char KEY_PATH[] = "path";
 const char KEY_SELECTED[] = "selected";
@@ -131,6 +134,7 @@ const char KEY_METHOD_NAME[] = "methodName";
 const char KEY_PARAMS[] = "params";
 const char KEY_SESSION_ID[] = "sessionId";
 const char KEY_FILES[] = "files";
+const char KEY_FILE_MEMORY[] = "fileMemory";
 const char KEY_DIR[] = "dir";
 const char KEY_URIS[] = "uris";
 const char KEY_BITTORRENT[] = "bittorrent";
@@ -546,12 +550,12 @@ void createUriEntry(List* uriList, InputIterator first, InputIterator last,
 } // namespace
 
 namespace {
-void createUriEntry(List* uriList, const std::shared_ptr<FileEntry>& file)
+void createUriEntry(List* uriList, const FileEntry& file)
 {
-  createUriEntry(uriList, std::begin(file->getSpentUris()),
-                 std::end(file->getSpentUris()), VLB_USED);
-  createUriEntry(uriList, std::begin(file->getRemainingUris()),
-                 std::end(file->getRemainingUris()), VLB_WAITING);
+  createUriEntry(uriList, std::begin(file.getSpentUris()),
+                 std::end(file.getSpentUris()), VLB_USED);
+  createUriEntry(uriList, std::begin(file.getRemainingUris()),
+                 std::end(file.getRemainingUris()), VLB_WAITING);
 }
 } // namespace
 
@@ -572,7 +576,7 @@ void createFileEntry(List* files, InputIterator first, InputIterator last,
     entry->put(KEY_COMPLETED_LENGTH, util::itos(completedLength));
 
     auto uriList = List::g();
-    createUriEntry(uriList.get(), *first);
+    createUriEntry(uriList.get(), **first);
     entry->put(KEY_URIS, std::move(uriList));
     files->append(std::move(entry));
   }
@@ -613,6 +617,18 @@ bool requested_key(const std::vector<std::string>& keys, const std::string& k)
 }
 } // namespace
 
+namespace {
+template <typename InputIterator>
+std::string estimateMemoryUsage(InputIterator first, InputIterator last)
+{
+  size_t n = 0;
+  for (; first != last; ++first) {
+    n += (*first)->estimateMemoryUsage();
+  }
+  return util::uitos(n);
+}
+} // namespace
+
 void gatherProgressCommon(Dict* entryDict,
                           const std::shared_ptr<RequestGroup>& group,
                           const std::vector<std::string>& keys)
@@ -685,6 +701,11 @@ void gatherProgressCommon(Dict* entryDict,
                     dctx->getPieceLength(), ps);
     entryDict->put(KEY_FILES, std::move(files));
   }
+  if (requested_key(keys, KEY_FILE_MEMORY)) {
+    entryDict->put(KEY_FILE_MEMORY,
+                   estimateMemoryUsage(std::begin(dctx->getFileEntries()),
+                                       std::end(dctx->getFileEntries())));
+  }
   if (requested_key(keys, KEY_DIR)) {
     entryDict->put(KEY_DIR, group->getOption()->get(PREF_DIR));
   }
@@ -755,6 +776,7 @@ namespace {
 void gatherPeer(List* peers, const std::shared_ptr<PeerStorage>& ps)
 {
   auto& usedPeers = ps->getUsedPeers();
+  std::vector<unsigned char> bitfieldBuf;
   for (auto& peer : usedPeers) {
     if (!peer->isActive()) {
       continue;
@@ -769,8 +791,10 @@ void gatherPeer(List* peers, const std::shared_ptr<PeerStorage>& ps)
     else {
       peerEntry->put(KEY_PORT, util::uitos(peer->getPort()));
     }
+    const auto& bitfield = peer->getPeerBitfield();
     peerEntry->put(KEY_BITFIELD,
-                   util::toHex(peer->getBitfield(), peer->getBitfieldLength()));
+                   util::toHex(bitfield.getBitfield(bitfieldBuf),
+                               bitfield.getBitfieldLength()));
     peerEntry->put(KEY_AM_CHOKING, peer->amChoking() ? VLB_TRUE : VLB_FALSE);
     peerEntry->put(KEY_PEER_CHOKING,
                    peer->peerChoking() ? VLB_TRUE : VLB_FALSE);
@@ -778,6 +802,9 @@ void gatherPeer(List* peers, const std::shared_ptr<PeerStorage>& ps)
                    util::itos(peer->calculateDownloadSpeed()));
     peerEntry->put(KEY_UPLOAD_SPEED, util::itos(peer->calculateUploadSpeed()));
     peerEntry->put(KEY_SEEDER, peer->isSeeder() ? VLB_TRUE : VLB_FALSE);
+    peerEntry->put(KEY_SNUBBED, peer->snubbing() ? VLB_TRUE : VLB_FALSE);
+    peerEntry->put(KEY_OPTIMISTIC_UNCHOKE,
+                   peer->optUnchoking() ? VLB_TRUE : VLB_FALSE);
     peers->append(std::move(peerEntry));
   }
 }
@@ -863,11 +890,15 @@ void gatherStoppedDownload(Dict* entryDict,
   }
   if (requested_key(keys, KEY_FILES)) {
     auto files = List::g();
-    createFileEntry(files.get(), std::begin(ds->fileEntries),
-                    std::end(ds->fileEntries), ds->totalLength, ds->pieceLength,
-                    ds->bitfield);
+    auto fileEntries = ds->getFileEntries();
+    createFileEntry(files.get(), std::begin(fileEntries), std::end(fileEntries),
+                    ds->totalLength, ds->pieceLength, ds->bitfield);
     entryDict->put(KEY_FILES, std::move(files));
   }
+  if (requested_key(keys, KEY_FILE_MEMORY)) {
+    entryDict->put(KEY_FILE_MEMORY,
+                   util::uitos(ds->getFileEntryMemoryUsage()));
+  }
   if (requested_key(keys, KEY_TOTAL_LENGTH)) {
     entryDict->put(KEY_TOTAL_LENGTH, util::itos(ds->totalLength));
   }
@@ -937,9 +968,10 @@ std::unique_ptr<ValueBase> GetFilesRpcMethod::process(const RpcRequest& req,
                             GroupId::toHex(gid).c_str()));
     }
     else {
-      createFileEntry(files.get(), std::begin(dr->fileEntries),
-                      std::end(dr->fileEntries), dr->totalLength,
-                      dr->pieceLength, dr->bitfield);
+      auto fileEntries = dr->getFileEntries();
+      createFileEntry(files.get(), std::begin(fileEntries),
+                      std::end(fileEntries), dr->totalLength, dr->pieceLength,
+                      dr->bitfield);
     }
   }
   else {
@@ -968,7 +1000,7 @@ std::unique_ptr<ValueBase> GetUrisRpcMethod::process(const RpcRequest& req,
   // TODO Current implementation just returns first FileEntry's URIs.
   if (!group->getDownloadContext()->getFileEntries().empty()) {
     createUriEntry(uriList.get(),
-                   group->getDownloadContext()->getFirstFileEntry());
+                   *group->getDownloadContext()->getFirstFileEntry());
   }
   return std::move(uriList);
 }
@@ -1210,7 +1242,7 @@ std::unique_ptr<ValueBase>
 GetGlobalOptionRpcMethod::process(const RpcRequest& req, DownloadEngine* e)
 {
   auto result = Dict::g();
-  for (size_t i = 0, len = e->getOption()->getTable().size(); i < len; ++i) {
+  for (size_t i = 0, len = option::countOption(); i < len; ++i) {
     PrefPtr pref = option::i2p(i);
     if (pref == PREF_RPC_SECRET || !e->getOption()->defined(pref)) {
       continue;
@@ -56,24 +56,69 @@ ServerStatMan::ServerStatMan() {}
 
 ServerStatMan::~ServerStatMan() = default;
 
+namespace {
+struct HostKey {
+  const char* hostname;
+  size_t hostnameLength;
+  const char* protocol;
+  size_t protocolLength;
+};
+} // namespace
+
+namespace {
+// Compares like ServerStat::operator<.
+struct HostKeyLess {
+  bool operator()(const std::shared_ptr<ServerStat>& ss,
+                  const HostKey& key) const
+  {
+    int c = ss->getHostname().compare(0, std::string::npos, key.hostname,
+                                      key.hostnameLength);
+    return c < 0 ||
+           (c == 0 && ss->getProtocol().compare(0, std::string::npos,
+                                                key.protocol,
+                                                key.protocolLength) < 0);
+  }
+};
+} // namespace
+
 std::shared_ptr<ServerStat>
-ServerStatMan::find(const std::string& hostname,
-                    const std::string& protocol) const
+ServerStatMan::find(const char* hostname, size_t hostnameLength,
+                    const char* protocol, size_t protocolLength) const
 {
-  auto ss = std::make_shared<ServerStat>(hostname, protocol);
-  auto i = serverStats_.find(ss);
-  if (i == serverStats_.end()) {
+  HostKey key{hostname, hostnameLength, protocol, protocolLength};
+  auto i = std::lower_bound(std::begin(serverStats_), std::end(serverStats_),
+                            key, HostKeyLess());
+  if (i == std::end(serverStats_) ||
+      (*i)->getHostname().compare(0, std::string::npos, hostname,
+                                  hostnameLength) != 0 ||
+      (*i)->getProtocol().compare(0, std::string::npos, protocol,
+                                  protocolLength) != 0) {
     return nullptr;
   }
-  else {
-    return *i;
-  }
+  return *i;
+}
+
+std::shared_ptr<ServerStat>
+ServerStatMan::find(const std::string& hostname,
+                    const std::string& protocol) const
+{
+  return find(hostname.data(), hostname.size(), protocol.data(),
+              protocol.size());
+}
+
+std::shared_ptr<ServerStat>
+ServerStatMan::find(const char* uri, const uri_split_result& us) const
+{
+  // uri_split() always sets scheme and host on success.
+  return find(uri + us.fields[USR_HOST].off, us.fields[USR_HOST].len,
+              uri + us.fields[USR_SCHEME].off, us.fields[USR_SCHEME].len);
 }
 
 bool ServerStatMan::add(const std::shared_ptr<ServerStat>& serverStat)
 {
-  auto i = serverStats_.lower_bound(serverStat);
-  if (i != serverStats_.end() && *(*i) == *serverStat) {
+  auto i = std::lower_bound(std::begin(serverStats_), std::end(serverStats_),
+                            serverStat, DerefLess<std::shared_ptr<ServerStat>>());
+  if (i != std::end(serverStats_) && *(*i) == *serverStat) {
     return false;
   }
   else {
@@ -234,14 +279,12 @@ bool ServerStatMan::load(const std::string& filename)
 void ServerStatMan::removeStaleServerStat(const std::chrono::seconds& timeout)
 {
   auto now = Time();
-  for (auto i = std::begin(serverStats_); i != std::end(serverStats_);) {
-    if ((*i)->getLastUpdated().difference(now) >= timeout) {
-      serverStats_.erase(i++);
-    }
-    else {
-      ++i;
-    }
-  }
+  serverStats_.erase(
+      std::remove_if(std::begin(serverStats_), std::end(serverStats_),
+                     [&](const std::shared_ptr<ServerStat>& ss) {
+                       return ss->getLastUpdated().difference(now) >= timeout;
+                     }),
+      std::end(serverStats_));
 }
 
 } // namespace aria2
@@ -37,11 +37,11 @@
 #include "common.h"
 
 #include <string>
-#include <set>
+#include <vector>
 #include <memory>
 
 #include "a2time.h"
-#include "a2functional.h"
+#include "uri_split.h"
 
 namespace aria2 {
 
@@ -56,6 +56,12 @@ public:
   std::shared_ptr<ServerStat> find(const std::string& hostname,
                                    const std::string& protocol) const;
 
+  // Returns ServerStat of the host and scheme of |uri|, which has
+  // been split into |us| by uri_split().  Unlike the above function,
+  // this does not make copies of the host and scheme.
+  std::shared_ptr<ServerStat> find(const char* uri,
+                                   const uri_split_result& us) const;
+
   bool add(const std::shared_ptr<ServerStat>& serverStat);
 
   bool load(const std::string& filename);
@@ -65,10 +71,14 @@ public:
   void removeStaleServerStat(const std::chrono::seconds& timeout);
 
 private:
-  typedef std::set<std::shared_ptr<ServerStat>,
-                   DerefLess<std::shared_ptr<ServerStat>>>
-      ServerStatSet;
-  ServerStatSet serverStats_;
+  std::shared_ptr<ServerStat> find(const char* hostname, size_t hostnameLength,
+                                   const char* protocol,
+                                   size_t protocolLength) const;
+
+  // Sorted by ServerStat::operator<.  Lookups are much more frequent
+  // than insertions, and this can be searched without constructing a
+  // ServerStat as a key.
+  std::vector<std::shared_ptr<ServerStat>> serverStats_;
 };
 
 } // namespace aria2
@@ -40,6 +40,8 @@
 #include <set>
 
 #include "RequestGroupMan.h"
+#include "RequestGroup.h"
+#include "DownloadContext.h"
 #include "a2functional.h"
 #include "File.h"
 #include "A2STR.h"
@@ -54,6 +56,7 @@
 #include "OptionParser.h"
 #include "OptionHandler.h"
 #include "SHA1IOFile.h"
+#include "UriListParser.h"
 
 #if HAVE_ZLIB
 #include "GZipFile.h"
@@ -188,9 +191,11 @@ bool writeUri(IOFile& fp, InputIterator first, InputIterator last,
 //  No GID is persisted. GID is saved but it is just a random GID.
 
 namespace {
+// |file| is the first file of the download.  It may be nullptr if
+// the download has no file or dr->metadataInfo is not nullptr.
 bool writeDownloadResult(IOFile& fp, std::set<a2_gid_t>& metainfoCache,
                          const std::shared_ptr<DownloadResult>& dr,
-                         bool pauseRequested)
+                         const FileEntry* file, bool pauseRequested)
 {
   const std::shared_ptr<MetadataInfo>& mi = dr->metadataInfo;
   if (dr->belongsTo != 0 || (mi && mi->dataOnly()) || !dr->followedBy.empty()) {
@@ -208,10 +213,9 @@ bool writeDownloadResult(IOFile& fp, std::set<a2_gid_t>& metainfoCache,
       metainfoCache.insert(dr->gid->getNumericId());
     }
     // only save first file entry
-    if (dr->fileEntries.empty()) {
+    if (!file) {
       return true;
     }
-    const std::shared_ptr<FileEntry>& file = dr->fileEntries[0];
     // Don't save download if there are no URIs.
     const bool hasRemaining = !file->getRemainingUris().empty();
     const bool hasSpent = !file->getSpentUris().empty();
@@ -270,6 +274,17 @@ bool writeDownloadResult(IOFile& fp, std::set<a2_gid_t>& metainfoCache,
 }
 } // namespace
 
+namespace {
+const FileEntry* getFirstFileEntry(const std::shared_ptr<RequestGroup>& rg)
+{
+  const auto& fileEntries = rg->getDownloadContext()->getFileEntries();
+  if (fileEntries.empty()) {
+    return nullptr;
+  }
+  return fileEntries[0].get();
+}
+} // namespace
+
 namespace {
 template <typename InputIt>
 bool saveDownloadResult(IOFile& fp, std::set<a2_gid_t>& metainfoCache,
@@ -295,7 +310,14 @@ bool saveDownloadResult(IOFile& fp, std::set<a2_gid_t>& metainfoCache,
       save = saveError;
       break;
     }
-    if (save && !writeDownloadResult(fp, metainfoCache, dr, false)) {
+    if (!save) {
+      continue;
+    }
+    std::shared_ptr<FileEntry> file;
+    if (!dr->metadataInfo) {
+      file = dr->getFileEntry(0);
+    }
+    if (!writeDownloadResult(fp, metainfoCache, dr, file.get(), false)) {
       return false;
     }
   }
@@ -324,12 +346,12 @@ bool SessionSerializer::save(IOFile& fp) const
     // Save active downloads.
     const RequestGroupList& groups = rgman_->getRequestGroups();
     for (const auto& rg : groups) {
-      auto dr = rg->createDownloadResult();
+      auto dr = rg->createDownloadResult(false);
       bool stopped = dr->result == error_code::FINISHED ||
                      dr->result == error_code::REMOVED;
       if ((!stopped && saveInProgress_) ||
           (stopped && dr->option->getAsBool(PREF_FORCE_SAVE))) {
-        if (!writeDownloadResult(fp, metainfoCache, dr,
+        if (!writeDownloadResult(fp, metainfoCache, dr, getFirstFileEntry(rg),
                                  rg->isPauseRequested())) {
           return false;
         }
@@ -339,12 +361,19 @@ bool SessionSerializer::save(IOFile& fp) const
   if (saveWaiting_) {
     const auto& groups = rgman_->getReservedGroups();
     for (const auto& rg : groups) {
-      auto result = rg->createDownloadResult();
+      auto result = rg->createDownloadResult(false);
       if (!writeDownloadResult(fp, metainfoCache, result,
+                               getFirstFileEntry(rg),
                                rg->isPauseRequested())) {
         return false;
       }
     }
+    // Entries of input file which have not been read yet with
+    // --deferred-input.
+    const auto& uriListParser = rgman_->getUriListParser();
+    if (uriListParser && !uriListParser->writeUnparsed(fp)) {
+      return false;
+    }
   }
   return true;
 }
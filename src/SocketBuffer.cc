@@ -46,6 +46,14 @@
 
 namespace aria2 {
 
+namespace {
+// Data up to this length is copied into the last entry in queue
+// instead of making a new entry.
+constexpr size_t MAX_COALESCE_LENGTH = 1_k;
+// The last entry in queue grows up to this length by coalescing.
+constexpr size_t MAX_COALESCED_ENTRY_LENGTH = 16_k;
+} // namespace
+
 SocketBuffer::ByteArrayBufEntry::ByteArrayBufEntry(
     std::vector<unsigned char> bytes,
     std::unique_ptr<ProgressUpdate> progressUpdate)
@@ -77,6 +85,17 @@ const unsigned char* SocketBuffer::ByteArrayBufEntry::getData() const
   return bytes_.data();
 }
 
+bool SocketBuffer::ByteArrayBufEntry::append(const unsigned char* data,
+                                             size_t len)
+{
+  if (hasProgressUpdate() ||
+      bytes_.size() + len > MAX_COALESCED_ENTRY_LENGTH) {
+    return false;
+  }
+  bytes_.insert(std::end(bytes_), data, data + len);
+  return true;
+}
+
 SocketBuffer::StringBufEntry::StringBufEntry(
     std::string s, std::unique_ptr<ProgressUpdate> progressUpdate)
     : BufEntry(std::move(progressUpdate)), str_(std::move(s))
@@ -103,7 +122,7 @@ const unsigned char* SocketBuffer::StringBufEntry::getData() const
 }
 
 SocketBuffer::SocketBuffer(std::shared_ptr<SocketCore> socket)
-    : socket_(std::move(socket)), offset_(0)
+    : socket_(std::move(socket)), offset_(0), frontSent_(false)
 {
 }
 
@@ -112,10 +131,19 @@ SocketBuffer::~SocketBuffer() = default;
 void SocketBuffer::pushBytes(std::vector<unsigned char> bytes,
                              std::unique_ptr<ProgressUpdate> progressUpdate)
 {
-  if (!bytes.empty()) {
-    bufq_.push_back(make_unique<ByteArrayBufEntry>(std::move(bytes),
-                                                   std::move(progressUpdate)));
+  if (bytes.empty()) {
+    return;
+  }
+  // Don't touch the first entry once we tried to send it, because
+  // TLS implementation may require that the same buffer is given
+  // when retrying.
+  if (!progressUpdate && bytes.size() <= MAX_COALESCE_LENGTH &&
+      !bufq_.empty() && (bufq_.size() > 1 || !frontSent_) &&
+      bufq_.back()->append(bytes.data(), bytes.size())) {
+    return;
   }
+  bufq_.push_back(make_unique<ByteArrayBufEntry>(std::move(bytes),
+                                                 std::move(progressUpdate)));
 }
 
 void SocketBuffer::pushStr(std::string data,
@@ -193,6 +221,7 @@ ssize_t SocketBuffer::send()
     }
   }
 fin:
+  frontSent_ = !bufq_.empty();
   return totalslen;
 }
 
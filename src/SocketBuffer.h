@@ -65,6 +65,13 @@ private:
     virtual bool final(size_t offset) const = 0;
     virtual size_t getLength() const = 0;
     virtual const unsigned char* getData() const = 0;
+    // Appends |len| bytes pointed by |data| to the end of this entry
+    // if possible.  Returns true if data was appended.
+    virtual bool append(const unsigned char* data, size_t len)
+    {
+      return false;
+    }
+    bool hasProgressUpdate() const { return progressUpdate_.get(); }
     void progressUpdate(size_t length, bool complete)
     {
       if (progressUpdate_) {
@@ -86,6 +93,8 @@ private:
     virtual bool final(size_t offset) const CXX11_OVERRIDE;
     virtual size_t getLength() const CXX11_OVERRIDE;
     virtual const unsigned char* getData() const CXX11_OVERRIDE;
+    virtual bool append(const unsigned char* data,
+                        size_t len) CXX11_OVERRIDE;
 
   private:
     std::vector<unsigned char> bytes_;
@@ -114,6 +123,10 @@ private:
   // to the data to be sent in the next send() call.
   size_t offset_;
 
+  // true if we have tried to send bufq_[0] but it has not been sent
+  // completely yet.
+  bool frontSent_;
+
 public:
   SocketBuffer(std::shared_ptr<SocketCore> socket);
 
@@ -126,7 +139,9 @@ public:
   // Feeds |bytes| into queue. This function doesn't send data.  If
   // progressUpdate is not null, its update() function will be called
   // each time the data is sent. It will be deleted by this object. It
-  // can be null.
+  // can be null.  If progressUpdate is null and |bytes| is small, it
+  // is appended to the last entry in queue, so that a series of small
+  // messages is sent from one contiguous buffer.
   void pushBytes(std::vector<unsigned char> bytes,
                  std::unique_ptr<ProgressUpdate> progressUpdate = nullptr);
 
@@ -61,6 +61,7 @@
 #ifdef ENABLE_SSL
 #include "TLSContext.h"
 #include "TLSSession.h"
+#include "TLSSessionCache.h"
 #endif // ENABLE_SSL
 #ifdef HAVE_LIBSSH2
 #include "SSHSession.h"
@@ -140,10 +141,23 @@ int SocketCore::socketRecvBufferSize_ = 0;
 std::shared_ptr<TLSContext> SocketCore::clTlsContext_;
 std::shared_ptr<TLSContext> SocketCore::svTlsContext_;
 
+namespace {
+// Client side TLS sessions keyed by "hostname:port" of the origin
+// server.  Reusing them saves full handshake when new connection is
+// made to the same server, which happens a lot with split downloads.
+TLSSessionCache tlsSessionCache;
+} // namespace
+
 void SocketCore::setClientTLSContext(
     const std::shared_ptr<TLSContext>& tlsContext)
 {
   clTlsContext_ = tlsContext;
+  tlsSessionCache.clear();
+}
+
+TLSSessionCache& SocketCore::getClientTLSSessionCache()
+{
+  return tlsSessionCache;
 }
 
 void SocketCore::setServerTLSContext(
@@ -167,6 +181,7 @@ SocketCore::SocketCore(sock_t sockfd, int sockType)
 void SocketCore::init()
 {
   blocking_ = true;
+  reusePort_ = false;
   secure_ = A2_TLS_NONE;
 
   wantRead_ = false;
@@ -219,7 +234,7 @@ void SocketCore::create(int family, int protocol)
 
 static sock_t bindInternal(int family, int socktype, int protocol,
                            const struct sockaddr* addr, socklen_t addrlen,
-                           std::string& error)
+                           bool reusePort, std::string& error)
 {
   int errNum;
   sock_t fd = socket(family, socktype, protocol);
@@ -237,6 +252,19 @@ static sock_t bindInternal(int family, int socktype, int protocol,
     CLOSE(fd);
     return -1;
   }
+  if (reusePort) {
+#ifdef SO_REUSEPORT
+    if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, (a2_sockopt_t)&sockopt,
+                   sizeof(sockopt)) < 0) {
+      errNum = SOCKET_ERRNO;
+      error = errorMsg(errNum);
+      CLOSE(fd);
+      return -1;
+    }
+#else  // !SO_REUSEPORT
+    A2_LOG_WARN("SO_REUSEPORT is not supported on this platform.");
+#endif // !SO_REUSEPORT
+  }
 #ifdef IPV6_V6ONLY
   if (family == AF_INET6) {
     int sockopt = 1;
@@ -262,7 +290,7 @@ static sock_t bindInternal(int family, int socktype, int protocol,
 }
 
 static sock_t bindTo(const char* host, uint16_t port, int family, int sockType,
-                     int getaddrinfoFlags, std::string& error)
+                     int getaddrinfoFlags, bool reusePort, std::string& error)
 {
   struct addrinfo* res;
   int s = callGetaddrinfo(&res, host, util::uitos(port).c_str(), family,
@@ -276,7 +304,7 @@ static sock_t bindTo(const char* host, uint16_t port, int family, int sockType,
   struct addrinfo* rp;
   for (rp = res; rp; rp = rp->ai_next) {
     sock_t fd = bindInternal(rp->ai_family, rp->ai_socktype, rp->ai_protocol,
-                             rp->ai_addr, rp->ai_addrlen, error);
+                             rp->ai_addr, rp->ai_addrlen, reusePort, error);
     if (fd != (sock_t)-1) {
       return fd;
     }
@@ -288,7 +316,7 @@ void SocketCore::bindWithFamily(uint16_t port, int family, int flags)
 {
   closeConnection();
   std::string error;
-  sock_t fd = bindTo(nullptr, port, family, sockType_, flags, error);
+  sock_t fd = bindTo(nullptr, port, family, sockType_, flags, reusePort_, error);
   if (fd == (sock_t)-1) {
     throw DL_ABORT_EX(fmt(EX_SOCKET_BIND, error.c_str()));
   }
@@ -307,7 +335,8 @@ void SocketCore::bind(const char* addr, uint16_t port, int family, int flags)
     addrp = nullptr;
   }
   if (addrp || !(flags & AI_PASSIVE) || bindAddrsList_.empty()) {
-    sock_t fd = bindTo(addrp, port, family, sockType_, flags, error);
+    sock_t fd = bindTo(addrp, port, family, sockType_, flags, reusePort_,
+                       error);
     if (fd == (sock_t)-1) {
       throw DL_ABORT_EX(fmt(EX_SOCKET_BIND, error.c_str()));
     }
@@ -331,7 +360,8 @@ void SocketCore::bind(const char* addr, uint16_t port, int family, int flags)
         error = "Given address and resolved address do not match.";
         continue;
       }
-      auto fd = bindTo(host.data(), port, family, sockType_, flags, error);
+      auto fd = bindTo(host.data(), port, family, sockType_, flags,
+                       reusePort_, error);
       if (fd != (sock_t)-1) {
         sockfd_ = fd;
         return;
@@ -353,7 +383,8 @@ void SocketCore::bind(const struct sockaddr* addr, socklen_t addrlen)
 {
   closeConnection();
   std::string error;
-  sock_t fd = bindInternal(addr->sa_family, sockType_, 0, addr, addrlen, error);
+  sock_t fd = bindInternal(addr->sa_family, sockType_, 0, addr, addrlen,
+                           reusePort_, error);
   if (fd == (sock_t)-1) {
     throw DL_ABORT_EX(fmt(EX_SOCKET_BIND, error.c_str()));
   }
@@ -389,6 +420,43 @@ std::shared_ptr<SocketCore> SocketCore::acceptConnection() const
   return sock;
 }
 
+std::shared_ptr<SocketCore>
+SocketCore::acceptPendingConnection(Endpoint& endpoint) const
+{
+  sockaddr_union sockaddr;
+  socklen_t len = sizeof(sockaddr);
+  sock_t fd;
+#ifdef HAVE_ACCEPT4
+  // accept4 saves fcntl calls to make the socket non-blocking and
+  // close-on-exec.
+  while ((fd = accept4(sockfd_, &sockaddr.sa, &len,
+                       SOCK_NONBLOCK | SOCK_CLOEXEC)) == (sock_t)-1 &&
+         SOCKET_ERRNO == A2_EINTR)
+    ;
+#else  // !HAVE_ACCEPT4
+  while ((fd = accept(sockfd_, &sockaddr.sa, &len)) == (sock_t)-1 &&
+         SOCKET_ERRNO == A2_EINTR)
+    ;
+#endif // !HAVE_ACCEPT4
+  int errNum = SOCKET_ERRNO;
+  if (fd == (sock_t)-1) {
+    if (A2_WOULDBLOCK(errNum)) {
+      return nullptr;
+    }
+    throw DL_ABORT_EX(fmt(EX_SOCKET_ACCEPT, errorMsg(errNum).c_str()));
+  }
+
+  auto sock = std::make_shared<SocketCore>(fd, sockType_);
+#ifdef HAVE_ACCEPT4
+  sock->blocking_ = false;
+#else  // !HAVE_ACCEPT4
+  util::make_fd_cloexec(fd);
+  sock->setNonBlockingMode();
+#endif // !HAVE_ACCEPT4
+  endpoint = util::getNumericNameInfo(&sockaddr.sa, len);
+  return sock;
+}
+
 Endpoint SocketCore::getAddrInfo() const
 {
   sockaddr_union sockaddr;
@@ -635,8 +703,17 @@ void SocketCore::closeConnection()
 {
 #ifdef ENABLE_SSL
   if (tlsSession_) {
+    // With TLSv1.3, session ticket arrives after handshake.  Update
+    // the cache with the latest one.
+    if (secure_ == A2_TLS_CONNECTED && !tlsSessionKey_.empty()) {
+      auto data = tlsSession_->getSessionData();
+      if (!data.empty()) {
+        tlsSessionCache.put(tlsSessionKey_, std::move(data));
+      }
+    }
     tlsSession_->closeConnection();
     tlsSession_.reset();
+    tlsSessionKey_.clear();
   }
 #endif // ENABLE_SSL
 
@@ -903,15 +980,22 @@ void SocketCore::readData(void* data, size_t& len)
 
 bool SocketCore::tlsAccept()
 {
-  return tlsHandshake(svTlsContext_.get(), A2STR::NIL);
+  return tlsHandshake(svTlsContext_.get(), A2STR::NIL, 0);
+}
+
+bool SocketCore::tlsConnect(const std::string& hostname, uint16_t port)
+{
+  return tlsHandshake(clTlsContext_.get(), hostname, port);
 }
 
-bool SocketCore::tlsConnect(const std::string& hostname)
+bool SocketCore::isTLSSessionResumed() const
 {
-  return tlsHandshake(clTlsContext_.get(), hostname);
+  return tlsSession_ && secure_ == A2_TLS_CONNECTED &&
+         tlsSession_->isSessionResumed();
 }
 
-bool SocketCore::tlsHandshake(TLSContext* tlsctx, const std::string& hostname)
+bool SocketCore::tlsHandshake(TLSContext* tlsctx, const std::string& hostname,
+                              uint16_t port)
 {
   wantRead_ = false;
   wantWrite_ = false;
@@ -941,6 +1025,18 @@ bool SocketCore::tlsHandshake(TLSContext* tlsctx, const std::string& hostname)
                               tlsSession_->getLastErrorString().c_str()));
       }
     }
+    if (tlsctx->getSide() == TLS_CLIENT && !hostname.empty()) {
+      // Use the port of the origin server, not the one of the peer,
+      // which is a proxy when tunneling through it.
+      tlsSessionKey_ = fmt("%s:%u", hostname.c_str(), port);
+      auto& data = tlsSessionCache.get(tlsSessionKey_);
+      if (!data.empty() && tlsSession_->setSessionData(data) != TLS_ERR_OK) {
+        A2_LOG_DEBUG(fmt("Failed to set TLS session data for %s: %s",
+                         tlsSessionKey_.c_str(),
+                         tlsSession_->getLastErrorString().c_str()));
+        tlsSessionCache.remove(tlsSessionKey_);
+      }
+    }
     // Done with the setup, now let handshaking begin immediately.
     secure_ = A2_TLS_HANDSHAKING;
     A2_LOG_DEBUG("TLS Handshaking");
@@ -987,6 +1083,16 @@ bool SocketCore::tlsHandshake(TLSContext* tlsctx, const std::string& hostname)
         break;
       }
 
+      if (!tlsSessionKey_.empty()) {
+        if (tlsSession_->isSessionResumed()) {
+          A2_LOG_DEBUG(fmt("TLS session resumed for %s", peerInfo.c_str()));
+        }
+        auto data = tlsSession_->getSessionData();
+        if (!data.empty()) {
+          tlsSessionCache.put(tlsSessionKey_, std::move(data));
+        }
+      }
+
       // 3. We're connected now!
       secure_ = A2_TLS_CONNECTED;
       return true;
@@ -1008,6 +1114,9 @@ bool SocketCore::tlsHandshake(TLSContext* tlsctx, const std::string& hostname)
     }
 
     if (rv == TLS_ERR_ERROR) {
+      if (!tlsSessionKey_.empty()) {
+        tlsSessionCache.remove(tlsSessionKey_);
+      }
       // Damn those error.
       throw DL_ABORT_EX(fmt("SSL/TLS handshake failure: %s",
                             handshakeError.empty()
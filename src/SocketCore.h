@@ -53,6 +53,7 @@ namespace aria2 {
 #ifdef ENABLE_SSL
 class TLSContext;
 class TLSSession;
+class TLSSessionCache;
 #endif // ENABLE_SSL
 
 #ifdef HAVE_LIBSSH2
@@ -80,6 +81,8 @@ private:
   static int socketRecvBufferSize_;
 
   bool blocking_;
+  // true if SO_REUSEPORT is set on the socket when it is bound.
+  bool reusePort_;
   int secure_;
 
   bool wantRead_;
@@ -93,13 +96,18 @@ private:
 
   std::shared_ptr<TLSSession> tlsSession_;
 
+  // Key to look up TLSSessionCache.  Empty for server side session.
+  std::string tlsSessionKey_;
+
   /**
    * Makes this socket secure. The connection must be established
    * before calling this method.
    *
    * If you are going to verify peer's certificate, hostname must be supplied.
+   * port is the port of the server named by hostname.
    */
-  bool tlsHandshake(TLSContext* tlsctx, const std::string& hostname);
+  bool tlsHandshake(TLSContext* tlsctx, const std::string& hostname,
+                    uint16_t port);
 #endif // ENABLE_SSL
 
 #ifdef HAVE_LIBSSH2
@@ -147,6 +155,12 @@ public:
     ipDscp_ = ipDscp << 2;
   }
 
+  // If reusePort is true, SO_REUSEPORT is set on the socket in the
+  // subsequent bind call, so that several processes can share the
+  // listening port and the kernel distributes incoming connections
+  // among them.
+  void setReusePort(bool reusePort) { reusePort_ = reusePort; }
+
   void create(int family, int protocol = 0);
 
   void bindWithFamily(uint16_t port, int family, int flags = AI_PASSIVE);
@@ -199,6 +213,17 @@ public:
    */
   std::shared_ptr<SocketCore> acceptConnection() const;
 
+  /**
+   * Accepts pending connection on this non-blocking listening socket.
+   * The returned socket is already in non-blocking mode and the
+   * address of the remote endpoint is stored in endpoint.  Returns
+   * nullptr if there is no pending connection.  The socket buffer
+   * size is not set explicitly; the accepted socket inherits it from
+   * this listening socket.
+   */
+  std::shared_ptr<SocketCore>
+  acceptPendingConnection(Endpoint& endpoint) const;
+
   /**
    * Connects to the server named host and the destination port is port.
    * This method makes socket non-blocking mode.
@@ -294,8 +319,18 @@ public:
   // returns true. If handshake has not been done yet, returns false.
   //
   // If you are going to verify peer's certificate, hostname must be
-  // supplied.
-  bool tlsConnect(const std::string& hostname);
+  // supplied.  |port| is the port of the server named by |hostname|.
+  // It is used with |hostname| to look up TLS session cache, and
+  // differs from the port of the peer if the connection goes through
+  // a proxy.
+  bool tlsConnect(const std::string& hostname, uint16_t port);
+
+  // Returns the key of this connection in TLS session cache.  Empty
+  // if the session is not cached.
+  const std::string& getTLSSessionKey() const { return tlsSessionKey_; }
+
+  // Returns true if the TLS handshake resumed a previous session.
+  bool isTLSSessionResumed() const;
 #endif // ENABLE_SSL
 
 #ifdef HAVE_LIBSSH2
@@ -347,6 +382,9 @@ public:
   setClientTLSContext(const std::shared_ptr<TLSContext>& tlsContext);
   static void
   setServerTLSContext(const std::shared_ptr<TLSContext>& tlsContext);
+  // Returns the cache of client side TLS sessions.  It is cleared by
+  // setClientTLSContext().
+  static TLSSessionCache& getClientTLSSessionCache();
 #endif // ENABLE_SSL
 
   static void setProtocolFamily(int protocolFamily)
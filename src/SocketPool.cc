@@ -0,0 +1,189 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "SocketPool.h"
+
+#include <functional>
+
+#include "SocketCore.h"
+#include "LogFactory.h"
+#include "fmt.h"
+#include "util.h"
+#include "wallclock.h"
+
+namespace aria2 {
+
+SocketPool::Key::Key(std::string host, uint16_t port, std::string username,
+                     std::string proxyHost, uint16_t proxyPort)
+    : host(std::move(host)),
+      port(port),
+      username(std::move(username)),
+      proxyHost(std::move(proxyHost)),
+      proxyPort(proxyPort)
+{
+}
+
+bool SocketPool::Key::operator==(const Key& e) const
+{
+  return port == e.port && proxyPort == e.proxyPort && host == e.host &&
+         username == e.username && proxyHost == e.proxyHost;
+}
+
+std::string SocketPool::Key::toString() const
+{
+  std::string s;
+  if (!username.empty()) {
+    s += util::percentEncode(username);
+    s += "@";
+  }
+  s += fmt("%s(%u)", host.c_str(), port);
+  if (!proxyHost.empty()) {
+    s += fmt("/%s(%u)", proxyHost.c_str(), proxyPort);
+  }
+  return s;
+}
+
+size_t SocketPool::KeyHash::operator()(const Key& e) const
+{
+  std::hash<std::string> h;
+  size_t v = h(e.host);
+  v = v * 31 + e.port;
+  if (!e.username.empty()) {
+    v = v * 31 + h(e.username);
+  }
+  if (!e.proxyHost.empty()) {
+    v = v * 31 + h(e.proxyHost);
+    v = v * 31 + e.proxyPort;
+  }
+  return v;
+}
+
+SocketPool::SocketPool(size_t maxIdlePerEndpoint)
+    : maxIdlePerEndpoint_(maxIdlePerEndpoint),
+      numEntries_(0),
+      numHits_(0),
+      numMisses_(0),
+      numDropped_(0)
+{
+}
+
+SocketPool::~SocketPool() = default;
+
+void SocketPool::push(Key endpoint, std::shared_ptr<SocketCore> socket,
+                      std::string options, std::chrono::seconds timeout)
+{
+  A2_LOG_INFO(fmt("Pool socket for %s", endpoint.toString().c_str()));
+  auto& entries = pool_[std::move(endpoint)];
+  if (!entries.empty() && entries.size() >= maxIdlePerEndpoint_) {
+    entries.pop_front();
+    --numEntries_;
+    ++numDropped_;
+  }
+  auto deadline = global::wallclock();
+  deadline.advance(timeout);
+  entries.push_back(Entry{std::move(socket), std::move(options),
+                          std::move(deadline)});
+  ++numEntries_;
+}
+
+std::shared_ptr<SocketCore> SocketPool::pop(std::string& options,
+                                            const Key& endpoint)
+{
+  auto i = pool_.find(endpoint);
+  if (i == std::end(pool_)) {
+    ++numMisses_;
+    return nullptr;
+  }
+  auto& entries = (*i).second;
+  std::shared_ptr<SocketCore> socket;
+  while (!entries.empty()) {
+    auto& e = entries.back();
+    // We assume that if socket is readable it means peer shutdowns
+    // connection and the socket will receive EOF. So skip it.
+    if (global::wallclock() < e.deadline && !e.socket->isReadable(0)) {
+      socket = std::move(e.socket);
+      options = std::move(e.options);
+    }
+    else {
+      ++numDropped_;
+    }
+    entries.pop_back();
+    --numEntries_;
+    if (socket) {
+      break;
+    }
+  }
+  if (entries.empty()) {
+    pool_.erase(i);
+  }
+  if (socket) {
+    A2_LOG_INFO(fmt("Found socket for %s", endpoint.toString().c_str()));
+    ++numHits_;
+  }
+  else {
+    ++numMisses_;
+  }
+  return socket;
+}
+
+void SocketPool::evict()
+{
+  if (pool_.empty()) {
+    return;
+  }
+  A2_LOG_DEBUG("Scanning SocketPool and erasing timed out entry.");
+  const auto& now = global::wallclock();
+  size_t numRemoved = 0;
+  for (auto i = std::begin(pool_); i != std::end(pool_);) {
+    auto& entries = (*i).second;
+    // Entries of an endpoint usually share the same timeout, so they
+    // expire in the order they were pooled.
+    while (!entries.empty() && entries.front().deadline <= now) {
+      entries.pop_front();
+      ++numRemoved;
+    }
+    if (entries.empty()) {
+      i = pool_.erase(i);
+    }
+    else {
+      ++i;
+    }
+  }
+  numEntries_ -= numRemoved;
+  numDropped_ += numRemoved;
+  A2_LOG_DEBUG(fmt("%lu entries removed.",
+                   static_cast<unsigned long>(numRemoved)));
+}
+
+} // namespace aria2
@@ -0,0 +1,140 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_SOCKET_POOL_H
+#define D_SOCKET_POOL_H
+
+#include "common.h"
+
+#include <string>
+#include <deque>
+#include <unordered_map>
+#include <memory>
+#include <chrono>
+
+#include "TimerA2.h"
+
+namespace aria2 {
+
+class SocketCore;
+
+// Pool of idle connections which can be reused by later requests.
+// Connections are grouped by endpoint.  Each endpoint keeps its
+// connections in the order they were pooled: the most recently
+// pooled one is reused first, and the least recently pooled one is
+// dropped first when the endpoint exceeds its limit.
+class SocketPool {
+public:
+  // Identifies the connections which can be used for each other.  If
+  // a proxy is used, host is the hostname of the origin server.
+  // Otherwise, it is the numeric address of the peer.
+  struct Key {
+    std::string host;
+    uint16_t port;
+    std::string username;
+    std::string proxyHost;
+    uint16_t proxyPort;
+
+    Key(std::string host, uint16_t port, std::string username,
+        std::string proxyHost, uint16_t proxyPort);
+
+    bool operator==(const Key& e) const;
+
+    // Returns a string representation of this object for logging.
+    std::string toString() const;
+  };
+
+  // |maxIdlePerEndpoint| is the maximum number of connections pooled
+  // for an endpoint.
+  SocketPool(size_t maxIdlePerEndpoint);
+
+  ~SocketPool();
+
+  // Pools |socket| for |endpoint|.  |options| is the protocol
+  // specific state of the connection.  The connection is dropped
+  // after |timeout|.
+  void push(Key endpoint, std::shared_ptr<SocketCore> socket,
+            std::string options, std::chrono::seconds timeout);
+
+  // Removes the most recently pooled connection for |endpoint| and
+  // returns it.  Its options are assigned to |options|.  Connections
+  // which have timed out or which have been closed by the peer are
+  // dropped on the way.  Returns nullptr if no connection is
+  // available.
+  std::shared_ptr<SocketCore> pop(std::string& options, const Key& endpoint);
+
+  // Drops the connections which have timed out.
+  void evict();
+
+  size_t size() const { return numEntries_; }
+
+  bool empty() const { return numEntries_ == 0; }
+
+  // The number of pop() calls which returned a connection.
+  uint64_t getNumHits() const { return numHits_; }
+
+  // The number of pop() calls which returned nullptr.
+  uint64_t getNumMisses() const { return numMisses_; }
+
+  // The number of connections dropped because of timeout, peer
+  // shutdown or the limit of the endpoint.
+  uint64_t getNumDropped() const { return numDropped_; }
+
+private:
+  struct KeyHash {
+    size_t operator()(const Key& e) const;
+  };
+
+  struct Entry {
+    std::shared_ptr<SocketCore> socket;
+    std::string options;
+    Timer deadline;
+  };
+
+  std::unordered_map<Key, std::deque<Entry>, KeyHash> pool_;
+
+  size_t maxIdlePerEndpoint_;
+
+  size_t numEntries_;
+
+  uint64_t numHits_;
+
+  uint64_t numMisses_;
+
+  uint64_t numDropped_;
+};
+
+} // namespace aria2
+
+#endif // D_SOCKET_POOL_H
@@ -39,11 +39,26 @@
 
 #include "SocketCore.h"
 #include "LogFactory.h"
+#include "fmt.h"
 
 namespace aria2 {
 
+const size_t SocketRecvBuffer::MIN_CAPACITY;
+const size_t SocketRecvBuffer::MAX_CAPACITY;
+
+namespace {
+// Shrink the buffer after this number of consecutive small reads.
+constexpr size_t SHRINK_THRESHOLD = 32;
+} // namespace
+
 SocketRecvBuffer::SocketRecvBuffer(std::shared_ptr<SocketCore> socket)
-    : socket_(std::move(socket)), pos_(buf_.data()), last_(pos_)
+    : buf_(make_unique<unsigned char[]>(MIN_CAPACITY)),
+      bufLength_(MIN_CAPACITY),
+      capacity_(MIN_CAPACITY),
+      numSmallReads_(0),
+      socket_(std::move(socket)),
+      pos_(buf_.get()),
+      last_(pos_)
 {
 }
 
@@ -51,16 +66,53 @@ SocketRecvBuffer::~SocketRecvBuffer() = default;
 
 ssize_t SocketRecvBuffer::recv()
 {
-  size_t n = std::end(buf_) - last_;
+  if (bufferEmpty() && bufLength_ != capacity_) {
+    A2_LOG_DEBUG(fmt("Resizing receive buffer from %lu to %lu",
+                     static_cast<unsigned long>(bufLength_),
+                     static_cast<unsigned long>(capacity_)));
+    buf_ = make_unique<unsigned char[]>(capacity_);
+    bufLength_ = capacity_;
+    truncateBuffer();
+  }
+  size_t n = buf_.get() + bufLength_ - last_;
   if (n == 0) {
     A2_LOG_DEBUG("Buffer full");
     return 0;
   }
   socket_->readData(last_, n);
   last_ += n;
+  updateCapacity(n);
   return n;
 }
 
+ssize_t SocketRecvBuffer::recv(unsigned char* data, size_t len)
+{
+  assert(bufferEmpty());
+  socket_->readData(data, len);
+  updateCapacity(len);
+  return len;
+}
+
+void SocketRecvBuffer::updateCapacity(size_t nread)
+{
+  if (nread == 0) {
+    return;
+  }
+  if (nread >= capacity_) {
+    numSmallReads_ = 0;
+    capacity_ = std::min(capacity_ * 2, MAX_CAPACITY);
+  }
+  else if (nread < capacity_ / 8) {
+    if (++numSmallReads_ >= SHRINK_THRESHOLD) {
+      numSmallReads_ = 0;
+      capacity_ = std::max(capacity_ / 2, MIN_CAPACITY);
+    }
+  }
+  else {
+    numSmallReads_ = 0;
+  }
+}
+
 void SocketRecvBuffer::drain(size_t n)
 {
   assert(pos_ + n <= last_);
@@ -70,6 +122,6 @@ void SocketRecvBuffer::drain(size_t n)
   }
 }
 
-void SocketRecvBuffer::truncateBuffer() { pos_ = last_ = buf_.data(); }
+void SocketRecvBuffer::truncateBuffer() { pos_ = last_ = buf_.get(); }
 
 } // namespace aria2
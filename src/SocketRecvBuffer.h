@@ -38,7 +38,6 @@
 #include "common.h"
 
 #include <memory>
-#include <array>
 
 #include "a2functional.h"
 
@@ -53,6 +52,10 @@ public:
   // Reads data from socket as much as capacity allows. Returns the
   // number of bytes read.
   ssize_t recv();
+  // Reads data from socket into |data| of |len| bytes, bypassing the
+  // buffer.  The buffer must be empty.  Returns the number of bytes
+  // read.
+  ssize_t recv(unsigned char* data, size_t len);
   // Truncates the contents of buffer to 0.
   void truncateBuffer();
   // Drains first n bytes of data from buffer.  It is an programmer's
@@ -68,8 +71,25 @@ public:
 
   bool bufferEmpty() const { return pos_ == last_; }
 
+  // Returns the preferred read size.  It grows while reads fill the
+  // whole buffer, and shrinks back while reads are small, so that
+  // fast connections need fewer read calls and slow ones do not hold
+  // large memory.  The buffer is resized when it gets empty.
+  size_t getCapacity() const { return capacity_; }
+
+  static const size_t MIN_CAPACITY = 16_k;
+  static const size_t MAX_CAPACITY = 1_m;
+
 private:
-  std::array<unsigned char, 16_k> buf_;
+  void updateCapacity(size_t nread);
+
+  std::unique_ptr<unsigned char[]> buf_;
+  // Allocated size of buf_
+  size_t bufLength_;
+  size_t capacity_;
+  // The number of consecutive reads which used small part of
+  // capacity_.
+  size_t numSmallReads_;
   std::shared_ptr<SocketCore> socket_;
   unsigned char* pos_;
   unsigned char* last_;
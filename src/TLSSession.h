@@ -111,6 +111,22 @@ public:
   // contacting network.
   virtual size_t getRecvBufferedLength() = 0;
 
+  // Returns serialized session data which can be passed to
+  // setSessionData() of another client side session to resume this
+  // session.  Returns empty string if the backend does not support
+  // session resumption or the data is not available.
+  virtual std::string getSessionData() { return std::string(); }
+
+  // Sets serialized session data obtained by getSessionData() to
+  // resume the previous session.  This function must be called
+  // before tlsConnect().  This function returns TLS_ERR_OK if it
+  // succeeds, or TLS_ERR_ERROR.
+  virtual int setSessionData(const std::string& data) { return TLS_ERR_OK; }
+
+  // Returns true if the previous session was resumed in the
+  // handshake.
+  virtual bool isSessionResumed() { return false; }
+
 protected:
   TLSSession() = default;
 
@@ -0,0 +1,81 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "TLSSessionCache.h"
+
+#include <algorithm>
+
+#include "A2STR.h"
+
+namespace aria2 {
+
+TLSSessionCache::TLSSessionCache(size_t capacity)
+    : capacity_(capacity), serial_(0)
+{
+}
+
+void TLSSessionCache::put(const std::string& key, std::string data)
+{
+  if (capacity_ == 0) {
+    return;
+  }
+  auto i = entries_.find(key);
+  if (i == std::end(entries_) && entries_.size() >= capacity_) {
+    auto oldest = std::min_element(
+        std::begin(entries_), std::end(entries_),
+        [](const std::pair<const std::string, Entry>& lhs,
+           const std::pair<const std::string, Entry>& rhs) {
+          return lhs.second.serial < rhs.second.serial;
+        });
+    entries_.erase(oldest);
+  }
+  auto& entry = entries_[key];
+  entry.data = std::move(data);
+  entry.serial = ++serial_;
+}
+
+const std::string& TLSSessionCache::get(const std::string& key) const
+{
+  auto i = entries_.find(key);
+  if (i == std::end(entries_)) {
+    return A2STR::NIL;
+  }
+  return (*i).second.data;
+}
+
+void TLSSessionCache::remove(const std::string& key) { entries_.erase(key); }
+
+void TLSSessionCache::clear() { entries_.clear(); }
+
+} // namespace aria2
@@ -0,0 +1,89 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "UploadSlotTuner.h"
+
+#include <algorithm>
+
+namespace aria2 {
+
+namespace {
+constexpr int MIN_NUM_SLOTS = 1;
+// Shrink the number of slots if upload speed exceeds the target by
+// this percentage points, since fewer peers can saturate the link.
+constexpr int SHRINK_MARGIN_PERCENT = 10;
+// Upload speed never exceeds the estimated capacity, so the shrink
+// threshold must be reachable even if the target is close to 100.
+constexpr int MAX_SHRINK_PERCENT = 99;
+} // namespace
+
+UploadSlotTuner::UploadSlotTuner(int targetPercent)
+    : targetPercent_(targetPercent),
+      numSlots_(DEFAULT_NUM_SLOTS),
+      peak_(0),
+      maxUploadSpeed_(0)
+{
+}
+
+void UploadSlotTuner::update(int uploadSpeed, size_t numCandidates)
+{
+  if (maxUploadSpeed_ <= 0 && peak_ == 0) {
+    // The first sample only tells us the peak.
+    peak_ = uploadSpeed;
+    return;
+  }
+  peak_ = std::max(peak_, uploadSpeed);
+  auto capacity = getCapacity();
+  if (capacity == 0) {
+    return;
+  }
+  // Upload speed may exceed the configured maximum a little.
+  auto percent = std::min<int64_t>(
+      100, static_cast<int64_t>(uploadSpeed) * 100 / capacity);
+  // Change the number of slots by 25% at a time, so that it reacts
+  // within a few rounds.
+  auto step = std::max(1, numSlots_ / 4);
+  if (percent < targetPercent_) {
+    // More slots than candidates do not increase upload speed.
+    if (static_cast<size_t>(numSlots_) < numCandidates) {
+      numSlots_ = std::min(numSlots_ + step, static_cast<int>(numCandidates));
+    }
+  }
+  else if (percent >= std::min(MAX_SHRINK_PERCENT,
+                               targetPercent_ + SHRINK_MARGIN_PERCENT)) {
+    numSlots_ = std::max(numSlots_ - step, MIN_NUM_SLOTS);
+  }
+}
+
+} // namespace aria2
@@ -0,0 +1,84 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_UPLOAD_SLOT_TUNER_H
+#define D_UPLOAD_SLOT_TUNER_H
+
+#include "common.h"
+
+namespace aria2 {
+
+// Adjusts the number of regular unchoke slots so that the upload
+// speed stays around the target percentage of the upload capacity.
+// The capacity is the maximum upload speed if it is configured.
+// Otherwise, it is the peak upload speed observed.  The peak only
+// moves up, so that a steady upload speed below the link capacity is
+// not mistaken for a saturated link.
+class UploadSlotTuner {
+private:
+  // Target upload speed in percentage of capacity.
+  int targetPercent_;
+  int numSlots_;
+  // Peak upload speed observed in bytes/sec.
+  int peak_;
+  // Maximum upload speed in bytes/sec.  0 means unlimited.
+  int maxUploadSpeed_;
+
+public:
+  UploadSlotTuner(int targetPercent);
+
+  // Sets the maximum upload speed in bytes/sec.  If it is positive,
+  // it is used as the capacity instead of the observed peak.
+  void setMaxUploadSpeed(int speed) { maxUploadSpeed_ = speed; }
+
+  // Updates the number of slots.  uploadSpeed is the current upload
+  // speed in bytes/sec.  numCandidates is the number of peers which
+  // can be unchoked.  This function is called once per choke round.
+  void update(int uploadSpeed, size_t numCandidates);
+
+  int getNumSlots() const { return numSlots_; }
+
+  // Returns the estimated upload capacity in bytes/sec.
+  int getCapacity() const
+  {
+    return maxUploadSpeed_ > 0 ? maxUploadSpeed_ : peak_;
+  }
+
+  // The number of regular unchoke slots used without tuning.
+  static const int DEFAULT_NUM_SLOTS = 3;
+};
+
+} // namespace aria2
+
+#endif // D_UPLOAD_SLOT_TUNER_H
@@ -35,6 +35,7 @@
 #include "UriListParser.h"
 
 #include <cstring>
+#include <algorithm>
 #include <sstream>
 
 #include "util.h"
@@ -51,17 +52,49 @@
 
 namespace aria2 {
 
-UriListParser::UriListParser(const std::string& filename)
+UriListParser::UriListParser(const std::string& filename) : bufPos_(0)
+{
 #if HAVE_ZLIB
-    : fp_(make_unique<GZipFile>(filename.c_str(), IOFile::READ))
+  fp_ = make_unique<GZipFile>(filename.c_str(), IOFile::READ);
 #else
-    : fp_(make_unique<BufferedFile>(filename.c_str(), IOFile::READ))
+  fp_ = make_unique<BufferedFile>(filename.c_str(), IOFile::READ);
 #endif
-{
 }
 
 UriListParser::~UriListParser() = default;
 
+bool UriListParser::readLine()
+{
+  if (bufPos_ < buf_.size()) {
+    auto eol = buf_.find('\n', bufPos_);
+    if (eol == std::string::npos) {
+      eol = buf_.size();
+    }
+    line_.assign(buf_, bufPos_, eol - bufPos_);
+    bufPos_ = std::min(eol + 1, buf_.size());
+    return true;
+  }
+  if (!buf_.empty()) {
+    buf_.clear();
+    buf_.shrink_to_fit();
+    bufPos_ = 0;
+  }
+  if (!fp_) {
+    line_.clear();
+    return false;
+  }
+  line_ = fp_->getLine();
+  if (line_.empty()) {
+    if (fp_->eof()) {
+      return false;
+    }
+    else if (!*fp_) {
+      throw DL_ABORT_EX("UriListParser:I/O error.");
+    }
+  }
+  return true;
+}
+
 void UriListParser::parseNext(std::vector<std::string>& uris, Option& op)
 {
   const std::shared_ptr<OptionParser>& optparser = OptionParser::getInstance();
@@ -72,17 +105,11 @@ void UriListParser::parseNext(std::vector<std::string>& uris, Option& op)
       // Read options
       std::stringstream ss;
       while (1) {
-        line_ = fp_->getLine();
+        if (!readLine()) {
+          break;
+        }
         if (line_.empty()) {
-          if (fp_->eof()) {
-            break;
-          }
-          else if (!fp_) {
-            throw DL_ABORT_EX("UriListParser:I/O error.");
-          }
-          else {
-            continue;
-          }
+          continue;
         }
         if (line_[0] == ' ' || line_[0] == '\t') {
           ss << line_ << "\n";
@@ -97,25 +124,47 @@ void UriListParser::parseNext(std::vector<std::string>& uris, Option& op)
       optparser->parse(op, ss);
       return;
     }
-    line_ = fp_->getLine();
-    if (line_.empty()) {
-      if (fp_->eof()) {
-        return;
-      }
-      else if (!fp_) {
-        throw DL_ABORT_EX("UriListParser:I/O error.");
-      }
+    if (!readLine()) {
+      return;
     }
   }
 }
 
 bool UriListParser::hasNext()
 {
-  bool rv = !line_.empty() || (fp_ && *fp_ && !fp_->eof());
-  if (!rv) {
+  bool rv = !line_.empty() || bufPos_ < buf_.size() ||
+            (fp_ && *fp_ && !fp_->eof());
+  if (!rv && fp_) {
     fp_->close();
   }
   return rv;
 }
 
+bool UriListParser::writeUnparsed(IOFile& fp)
+{
+  if (fp_ && *fp_) {
+    // buf_ is only used after fp_ is released, so it is empty here.
+    char data[4_k];
+    while (1) {
+      size_t nread = fp_->read(data, sizeof(data));
+      buf_.append(data, nread);
+      if (nread < sizeof(data)) {
+        if (!*fp_) {
+          return false;
+        }
+        break;
+      }
+    }
+    fp_.reset();
+  }
+  if (!line_.empty() && line_[0] != '#') {
+    if (fp.write(line_.data(), line_.size()) != line_.size() ||
+        fp.write("\n", 1) != 1) {
+      return false;
+    }
+  }
+  size_t len = buf_.size() - bufPos_;
+  return fp.write(buf_.data() + bufPos_, len) == len;
+}
+
 } // namespace aria2
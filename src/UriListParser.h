@@ -53,6 +53,16 @@ private:
 
   std::string line_;
 
+  // The rest of the file read by writeUnparsed().  Lines are read
+  // from here after fp_ is exhausted.
+  std::string buf_;
+
+  size_t bufPos_;
+
+  // Reads next line into line_.  Returns false if there is no more
+  // line.
+  bool readLine();
+
 public:
   UriListParser(const std::string& filename);
 
@@ -61,6 +71,13 @@ public:
   void parseNext(std::vector<std::string>& uris, Option& op);
 
   bool hasNext();
+
+  // Writes the lines which have not been parsed yet to |fp| as they
+  // are, so that they are not lost when the session is saved.  This
+  // function reads the rest of the file into memory, and subsequent
+  // parseNext() calls read it from there.  Returns true if it
+  // succeeds.
+  bool writeUnparsed(IOFile& fp);
 };
 
 } // namespace aria2
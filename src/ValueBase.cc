@@ -54,7 +54,7 @@ String::String() {}
 
 const String::ValueType& String::s() const { return str_; }
 
-String::ValueType String::popValue() const { return std::move(str_); }
+String::ValueType String::popValue() { return std::move(str_); }
 
 const unsigned char* String::uc() const
 {
@@ -116,7 +116,7 @@ void List::set(size_t index, std::unique_ptr<ValueBase> v)
   list_[index] = std::move(v);
 }
 
-void List::pop_front() { list_.pop_front(); }
+void List::pop_front() { list_.erase(list_.begin()); }
 
 void List::pop_back() { list_.pop_back(); }
 
@@ -38,7 +38,7 @@
 #include "common.h"
 
 #include <string>
-#include <deque>
+#include <vector>
 #include <map>
 #include <memory>
 
@@ -99,7 +99,8 @@ public:
 
   const ValueType& s() const;
 
-  ValueType popValue() const;
+  // Moves the string out of this object, leaving it empty.
+  ValueType popValue();
 
   // Returns std::string.data() cast to unsigned char*.
   // Use s().size() to get length.
@@ -174,7 +175,7 @@ private:
 
 class List : public ValueBase {
 public:
-  typedef std::deque<std::unique_ptr<ValueBase>> ValueType;
+  typedef std::vector<std::unique_ptr<ValueBase>> ValueType;
 
   List();
 
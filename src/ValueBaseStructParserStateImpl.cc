@@ -91,7 +91,7 @@ void DictValueBaseStructParserState::beginElement(
 void DictKeyValueBaseStructParserState::endElement(
     ValueBaseStructParserStateMachine* psm, int elementType)
 {
-  psm->setCurrentFrameName(psm->getCharacters());
+  psm->setCurrentFrameName(psm->popCharacters());
 }
 
 void DictDataValueBaseStructParserState::endElement(
@@ -117,7 +117,7 @@ void ArrayDataValueBaseStructParserState::endElement(
 void StringValueBaseStructParserState::endElement(
     ValueBaseStructParserStateMachine* psm, int elementType)
 {
-  psm->setCurrentFrameValue(String::g(psm->getCharacters()));
+  psm->setCurrentFrameValue(String::g(psm->popCharacters()));
 }
 
 void NumberValueBaseStructParserState::endElement(
@@ -118,6 +118,11 @@ const std::string& ValueBaseStructParserStateMachine::getCharacters() const
   return sessionData_.str;
 }
 
+std::string ValueBaseStructParserStateMachine::popCharacters()
+{
+  return std::move(sessionData_.str);
+}
+
 const ValueBaseStructParserStateMachine::NumberData&
 ValueBaseStructParserStateMachine::getNumber() const
 {
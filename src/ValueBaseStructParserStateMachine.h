@@ -85,6 +85,8 @@ public:
   virtual void reset() CXX11_OVERRIDE;
 
   const std::string& getCharacters() const;
+  // Moves out the characters collected so far.
+  std::string popCharacters();
   const NumberData& getNumber() const;
   bool getBool() const;
 
@@ -35,6 +35,7 @@
 #include "WrDiskCacheEntry.h"
 
 #include <cstring>
+#include <cassert>
 
 #include "DiskAdaptor.h"
 #include "RecoverableException.h"
@@ -44,6 +45,8 @@
 
 namespace aria2 {
 
+const size_t WrDiskCacheEntry::MAX_CELL_SLACK;
+
 WrDiskCacheEntry::WrDiskCacheEntry(
     const std::shared_ptr<DiskAdaptor>& diskAdaptor)
     : sizeKey_(0),
@@ -67,6 +70,7 @@ WrDiskCacheEntry::~WrDiskCacheEntry()
 void WrDiskCacheEntry::deleteDataCells()
 {
   for (auto& e : set_) {
+    diskAdaptor_->removePendingCacheData(e->goff, e->len);
     delete[] e->data;
     delete e;
   }
@@ -93,8 +97,10 @@ bool WrDiskCacheEntry::cacheData(DataCell* dataCell)
 {
   A2_LOG_DEBUG(fmt("WrDiskCacheEntry cache goff=%" PRId64 ", len=%lu",
                    dataCell->goff, static_cast<unsigned long>(dataCell->len)));
+  assert(dataCell->capacity - dataCell->len <= MAX_CELL_SLACK);
   if (set_.insert(dataCell).second) {
     size_ += dataCell->len;
+    diskAdaptor_->addPendingCacheData(dataCell->goff, dataCell->len);
     return true;
   }
   else {
@@ -105,21 +111,42 @@ bool WrDiskCacheEntry::cacheData(DataCell* dataCell)
 size_t WrDiskCacheEntry::append(int64_t goff, const unsigned char* data,
                                 size_t len)
 {
-  if (set_.empty()) {
+  size_t avail;
+  auto buf = getAppendBuffer(goff, avail);
+  if (!buf) {
     return 0;
   }
+  size_t wlen = std::min(avail, len);
+  memcpy(buf, data, wlen);
+  commitAppend(wlen);
+  return wlen;
+}
+
+unsigned char* WrDiskCacheEntry::getAppendBuffer(int64_t goff, size_t& len)
+{
+  if (set_.empty()) {
+    return nullptr;
+  }
   auto i = set_.end();
   --i;
   if (static_cast<int64_t>((*i)->goff + (*i)->len) == goff) {
-    size_t wlen = std::min((*i)->capacity - (*i)->len, len);
-    memcpy((*i)->data + (*i)->offset + (*i)->len, data, wlen);
-    (*i)->len += wlen;
-    size_ += wlen;
-    return wlen;
+    len = (*i)->capacity - (*i)->len;
+    return (*i)->data + (*i)->offset + (*i)->len;
   }
   else {
-    return 0;
+    return nullptr;
   }
 }
 
+void WrDiskCacheEntry::commitAppend(size_t len)
+{
+  assert(!set_.empty());
+  auto i = set_.end();
+  --i;
+  assert((*i)->len + len <= (*i)->capacity);
+  diskAdaptor_->addPendingCacheData((*i)->goff + (*i)->len, len);
+  (*i)->len += len;
+  size_ += len;
+}
+
 } // namespace aria2
@@ -73,13 +73,25 @@ public:
   // Deletes cached data without flushing to the disk.
   void clear();
 
-  // Caches |dataCell|
+  // Caches |dataCell| and takes ownership of its data.  The cache
+  // only counts the cached bytes, so the unused space of |dataCell|
+  // must not be larger than MAX_CELL_SLACK.
   bool cacheData(DataCell* dataCell);
 
   // Appends into last dataCell in set_ if the region is
   // contagious. Returns the number of copied bytes.
   size_t append(int64_t goff, const unsigned char* data, size_t len);
 
+  // Returns the pointer to the unused space of last dataCell in set_
+  // if the region is contagious to |goff|, and stores its length in
+  // |len|.  Otherwise returns nullptr.  The data written there must
+  // be committed by commitAppend().
+  unsigned char* getAppendBuffer(int64_t goff, size_t& len);
+
+  // Adds |len| bytes written into the space returned by
+  // getAppendBuffer() to last dataCell.
+  void commitAppend(size_t len);
+
   size_t getSize() const { return size_; }
   void setSizeKey(size_t sizeKey) { sizeKey_ = sizeKey; }
   size_t getSizeKey() const { return sizeKey_; }
@@ -98,6 +110,9 @@ public:
 
   const DataCellSet& getDataSet() const { return set_; }
 
+  // The maximum unused space of a cell.
+  static const size_t MAX_CELL_SLACK = 16_k;
+
 private:
   void deleteDataCells();
 
@@ -549,12 +549,12 @@ void createUriEntry(OutputIterator out, InputIterator first, InputIterator last,
 
 namespace {
 template <typename OutputIterator>
-void createUriEntry(OutputIterator out, const std::shared_ptr<FileEntry>& file)
+void createUriEntry(OutputIterator out, const FileEntry& file)
 {
-  createUriEntry(out, file->getSpentUris().begin(), file->getSpentUris().end(),
+  createUriEntry(out, file.getSpentUris().begin(), file.getSpentUris().end(),
                  URI_USED);
-  createUriEntry(out, file->getRemainingUris().begin(),
-                 file->getRemainingUris().end(), URI_WAITING);
+  createUriEntry(out, file.getRemainingUris().begin(),
+                 file.getRemainingUris().end(), URI_WAITING);
 }
 } // namespace
 
@@ -569,7 +569,7 @@ FileData createFileData(const std::shared_ptr<FileEntry>& fe, int index,
   file.completedLength =
       bf->getOffsetCompletedLength(fe->getOffset(), fe->getLength());
   file.selected = fe->isRequested();
-  createUriEntry(std::back_inserter(file.uris), fe);
+  createUriEntry(std::back_inserter(file.uris), *fe);
   return file;
 }
 } // namespace
@@ -838,18 +838,19 @@ struct DownloadResultDH : public DownloadHandle {
   virtual std::vector<FileData> getFiles() CXX11_OVERRIDE
   {
     std::vector<FileData> res;
-    createFileEntry(std::back_inserter(res), dr->fileEntries.begin(),
-                    dr->fileEntries.end(), dr->totalLength, dr->pieceLength,
+    const auto& fileEntries = getFileEntries();
+    createFileEntry(std::back_inserter(res), fileEntries.begin(),
+                    fileEntries.end(), dr->totalLength, dr->pieceLength,
                     dr->bitfield);
     return res;
   }
-  virtual int getNumFiles() CXX11_OVERRIDE { return dr->fileEntries.size(); }
+  virtual int getNumFiles() CXX11_OVERRIDE { return dr->countFileEntry(); }
   virtual FileData getFile(int index) CXX11_OVERRIDE
   {
     BitfieldMan bf(dr->pieceLength, dr->totalLength);
     bf.setBitfield(reinterpret_cast<const unsigned char*>(dr->bitfield.data()),
                    dr->bitfield.size());
-    return createFileData(dr->fileEntries[index - 1], index, &bf);
+    return createFileData(getFileEntries()[index - 1], index, &bf);
   }
   virtual BtMetaInfoData getBtMetaInfo() CXX11_OVERRIDE
   {
@@ -863,7 +864,17 @@ struct DownloadResultDH : public DownloadHandle {
   {
     return getRequestOptions(dr->option);
   }
+  // Decodes the files of dr on first use, so that calling getFile()
+  // for each file does not decode all of them every time.
+  const std::vector<std::shared_ptr<FileEntry>>& getFileEntries()
+  {
+    if (fileEntries.empty()) {
+      fileEntries = dr->getFileEntries();
+    }
+    return fileEntries;
+  }
   std::shared_ptr<DownloadResult> dr;
+  std::vector<std::shared_ptr<FileEntry>> fileEntries;
 };
 } // namespace
 
@@ -34,7 +34,10 @@
 /* copyright --> */
 #include "bencode2.h"
 
+#include <cstring>
 #include <sstream>
+#include <vector>
+#include <algorithm>
 
 #include "fmt.h"
 #include "DlAbortEx.h"
@@ -125,6 +128,192 @@ std::string encode(const ValueBase* vlb)
   return visitor.getResult();
 }
 
+namespace {
+// Returns the offset just past the bencoded value starting at
+// data[i], or -1 if the value is malformed or truncated.
+ssize_t skipValue(const unsigned char* data, size_t len, size_t i)
+{
+  size_t depth = 0;
+  while (i < len) {
+    auto c = data[i];
+    if (c == 'd' || c == 'l') {
+      ++depth;
+      ++i;
+    }
+    else if (c == 'e') {
+      if (depth == 0) {
+        return -1;
+      }
+      --depth;
+      ++i;
+    }
+    else if (c == 'i') {
+      auto end = static_cast<const unsigned char*>(
+          memchr(data + i, 'e', len - i));
+      if (!end) {
+        return -1;
+      }
+      i = end - data + 1;
+    }
+    else if (util::isDigit(c)) {
+      size_t slen = 0;
+      for (; i < len && util::isDigit(data[i]); ++i) {
+        slen = slen * 10 + (data[i] - '0');
+        if (slen > len) {
+          return -1;
+        }
+      }
+      if (i == len || data[i] != ':' || len - i - 1 < slen) {
+        return -1;
+      }
+      i += 1 + slen;
+    }
+    else {
+      return -1;
+    }
+    if (depth == 0) {
+      return i;
+    }
+  }
+  return -1;
+}
+} // namespace
+
+bool findDictValue(const unsigned char* data, size_t len,
+                   const std::string& key, size_t& first, size_t& last)
+{
+  if (len == 0 || data[0] != 'd') {
+    return false;
+  }
+  bool found = false;
+  size_t i = 1;
+  while (i < len && data[i] != 'e') {
+    if (!util::isDigit(data[i])) {
+      return false;
+    }
+    auto keyLast = skipValue(data, len, i);
+    if (keyLast == -1) {
+      return false;
+    }
+    auto keyFirst = static_cast<const unsigned char*>(
+                        memchr(data + i, ':', keyLast - i)) -
+                    data + 1;
+    auto valueLast = skipValue(data, len, keyLast);
+    if (valueLast == -1) {
+      return false;
+    }
+    if (static_cast<size_t>(keyLast - keyFirst) == key.size() &&
+        memcmp(data + keyFirst, key.data(), key.size()) == 0) {
+      first = keyLast;
+      last = valueLast;
+      found = true;
+    }
+    i = valueLast;
+  }
+  return i < len && found;
+}
+
+namespace {
+// Parses the digits at data[i] up to the terminator term in the
+// canonical form, and stores the value in n. Returns the offset just
+// past term, or -1 if they are not canonical.
+ssize_t parseCanonicalNumber(int64_t& n, const unsigned char* data,
+                             size_t len, size_t i, unsigned char term)
+{
+  size_t first = i;
+  n = 0;
+  for (; i < len && util::isDigit(data[i]); ++i) {
+    if ((INT64_MAX - (data[i] - '0')) / 10 < n) {
+      return -1;
+    }
+    n = n * 10 + (data[i] - '0');
+  }
+  if (i == first || i == len || data[i] != term ||
+      (data[first] == '0' && i - first > 1)) {
+    return -1;
+  }
+  return i + 1;
+}
+} // namespace
+
+bool isCanonical(const unsigned char* data, size_t len)
+{
+  struct Frame {
+    bool dict;
+    bool expectKey;
+    const unsigned char* key;
+    size_t keylen;
+  };
+  std::vector<Frame> stack;
+  size_t i = 0;
+  while (i < len) {
+    auto c = data[i];
+    bool isKey = !stack.empty() && stack.back().dict && stack.back().expectKey;
+    if (c == 'e') {
+      if (stack.empty() || (stack.back().dict && !stack.back().expectKey)) {
+        return false;
+      }
+      stack.pop_back();
+      ++i;
+    }
+    else if (isKey && !util::isDigit(c)) {
+      return false;
+    }
+    else if (c == 'd' || c == 'l') {
+      stack.push_back(Frame{c == 'd', true, nullptr, 0});
+      ++i;
+      continue;
+    }
+    else if (c == 'i') {
+      ++i;
+      bool negative = i < len && data[i] == '-';
+      if (negative) {
+        ++i;
+      }
+      int64_t n;
+      auto last = parseCanonicalNumber(n, data, len, i, 'e');
+      if (last == -1 || (negative && n == 0)) {
+        return false;
+      }
+      i = last;
+    }
+    else if (util::isDigit(c)) {
+      int64_t slen;
+      auto first = parseCanonicalNumber(slen, data, len, i, ':');
+      if (first == -1 || static_cast<uint64_t>(slen) > len - first) {
+        return false;
+      }
+      i = first + slen;
+      if (isKey) {
+        auto& frame = stack.back();
+        if (frame.key) {
+          size_t keylen = slen;
+          auto rv = memcmp(frame.key, data + first,
+                           std::min(frame.keylen, keylen));
+          if (rv > 0 || (rv == 0 && frame.keylen >= keylen)) {
+            return false;
+          }
+        }
+        frame.key = data + first;
+        frame.keylen = slen;
+        frame.expectKey = false;
+        continue;
+      }
+    }
+    else {
+      return false;
+    }
+    // A value is complete.
+    if (stack.empty()) {
+      return i == len;
+    }
+    if (stack.back().dict) {
+      stack.back().expectKey = true;
+    }
+  }
+  return false;
+}
+
 } // namespace bencode2
 
 } // namespace aria2
@@ -59,6 +59,21 @@ std::unique_ptr<ValueBase> decodeFromFile(const std::string& filename);
 
 std::string encode(const ValueBase* vlb);
 
+// Finds the value associated with key in the bencoded dictionary data
+// whose length is len, without decoding it. If it is found, stores
+// the byte range of the raw value in [first, last) and returns true.
+// If key appears more than once, the last one is used, just like
+// decode() does.
+bool findDictValue(const unsigned char* data, size_t len,
+                   const std::string& key, size_t& first, size_t& last);
+
+// Returns true if data, whose length is len, is a single bencoded
+// value exactly in the form encode() produces from its decoded value:
+// dictionary keys are unique and sorted, and integers and string
+// lengths have no sign, leading zeros or fractions encode() would
+// drop.
+bool isCanonical(const unsigned char* data, size_t len);
+
 } // namespace bencode2
 
 } // namespace aria2
@@ -97,16 +97,11 @@ const std::string SINGLE("single");
 
 namespace {
 void extractPieceHash(const std::shared_ptr<DownloadContext>& ctx,
-                      const std::string& hashData, size_t hashLength,
+                      std::string hashData, size_t hashLength,
                       size_t numPieces)
 {
-  std::vector<std::string> pieceHashes;
-  pieceHashes.reserve(numPieces);
-  for (size_t i = 0; i < numPieces; ++i) {
-    const char* p = hashData.data() + i * hashLength;
-    pieceHashes.push_back(std::string(p, p + hashLength));
-  }
-  ctx->setPieceHashes("sha-1", pieceHashes.begin(), pieceHashes.end());
+  hashData.resize(numPieces * hashLength);
+  ctx->setPieceHashes("sha-1", PieceHashes(std::move(hashData), hashLength));
 }
 } // namespace
 
@@ -210,6 +205,7 @@ void extractFileEntries(const std::shared_ptr<DownloadContext>& ctx,
   }
   torrent->name = utf8Name;
   int maxConn = option->getAsInt(PREF_MAX_CONNECTION_PER_SERVER);
+  const auto& dir = option->get(PREF_DIR);
   std::vector<std::shared_ptr<FileEntry>> fileEntries;
   const List* filesList = downcast<List>(infoDict->get(C_FILES));
   if (filesList) {
@@ -287,10 +283,9 @@ void extractFileEntries(const std::shared_ptr<DownloadContext>& ctx,
       auto suffixPath = util::escapePath(utf8Path);
 
       auto fileEntry = std::make_shared<FileEntry>(
-          util::applyDir(option->get(PREF_DIR), suffixPath),
-          fileLengthData->i(), offset, uris);
-      fileEntry->setOriginalName(utf8Path);
+          util::applyDir(dir, suffixPath), fileLengthData->i(), offset, uris);
       fileEntry->setSuffixPath(suffixPath);
+      fileEntry->setOriginalName(utf8Path);
       fileEntry->setMaxConnectionPerServer(maxConn);
       fileEntries.push_back(fileEntry);
       offset += fileEntry->getLength();
@@ -330,17 +325,15 @@ void extractFileEntries(const std::shared_ptr<DownloadContext>& ctx,
     auto suffixPath = util::escapePath(utf8Name);
 
     auto fileEntry = std::make_shared<FileEntry>(
-        util::applyDir(option->get(PREF_DIR), suffixPath), totalLength, 0,
-        uris);
-    fileEntry->setOriginalName(utf8Name);
+        util::applyDir(dir, suffixPath), totalLength, 0, uris);
     fileEntry->setSuffixPath(suffixPath);
+    fileEntry->setOriginalName(utf8Name);
     fileEntry->setMaxConnectionPerServer(maxConn);
     fileEntries.push_back(fileEntry);
   }
   ctx->setFileEntries(fileEntries.begin(), fileEntries.end());
   if (torrent->mode == BT_FILE_MODE_MULTI) {
-    ctx->setBasePath(
-        util::applyDir(option->get(PREF_DIR), util::escapePath(utf8Name)));
+    ctx->setBasePath(util::applyDir(dir, util::escapePath(utf8Name)));
   }
 }
 } // namespace
@@ -408,12 +401,20 @@ void extractNodes(TorrentAttribute* torrent, const ValueBase* nodesListSrc)
 } // namespace
 
 namespace {
+// If torrentData is not null, root must be decoded from torrentData,
+// whose length is torrentLength, and must not be used by the caller
+// afterwards. In this case, piece hashes are moved out of root, and
+// the info hash and metadata are taken from the raw bytes of info
+// dictionary instead of encoding it again, as long as they are in
+// the canonical form and encoding would yield the same bytes.
 void processRootDictionary(const std::shared_ptr<DownloadContext>& ctx,
                            const ValueBase* root,
                            const std::shared_ptr<Option>& option,
                            const std::string& defaultName,
                            const std::string& overrideName,
-                           const std::vector<std::string>& uris)
+                           const std::vector<std::string>& uris,
+                           const unsigned char* torrentData = nullptr,
+                           size_t torrentLength = 0)
 {
   const Dict* rootDict = downcast<Dict>(root);
   if (!rootDict) {
@@ -428,17 +429,27 @@ void processRootDictionary(const std::shared_ptr<DownloadContext>& ctx,
   auto torrent = std::make_shared<TorrentAttribute>();
 
   // retrieve infoHash
-  std::string encodedInfoDict = bencode2::encode(infoDict);
+  size_t infoFirst, infoLast;
+  if (torrentData &&
+      bencode2::findDictValue(torrentData, torrentLength, C_INFO, infoFirst,
+                              infoLast) &&
+      bencode2::isCanonical(torrentData + infoFirst, infoLast - infoFirst)) {
+    torrent->metadata.assign(torrentData + infoFirst, torrentData + infoLast);
+  }
+  else {
+    torrent->metadata = bencode2::encode(infoDict);
+  }
   unsigned char infoHash[INFO_HASH_LENGTH];
   message_digest::digest(infoHash, INFO_HASH_LENGTH,
-                         MessageDigest::sha1().get(), encodedInfoDict.data(),
-                         encodedInfoDict.size());
+                         MessageDigest::sha1().get(), torrent->metadata.data(),
+                         torrent->metadata.size());
   torrent->infoHash.assign(&infoHash[0], &infoHash[INFO_HASH_LENGTH]);
-  torrent->metadata = encodedInfoDict;
-  torrent->metadataSize = encodedInfoDict.size();
+  torrent->metadataSize = torrent->metadata.size();
 
   // calculate the number of pieces
-  const String* piecesData = downcast<String>(infoDict->get(C_PIECES));
+  // Not const, so that the piece hashes can be moved out if root is
+  // owned by the caller.
+  String* piecesData = downcast<String>(infoDict->get(C_PIECES));
   if (!piecesData) {
     throw DL_ABORT_EX2(fmt(MSG_MISSING_BT_INFO, C_PIECES),
                        error_code::BITTORRENT_PARSE_ERROR);
@@ -469,7 +480,8 @@ void processRootDictionary(const std::shared_ptr<DownloadContext>& ctx,
   size_t pieceLength = pieceLengthData->i();
   ctx->setPieceLength(pieceLength);
   // retrieve piece hashes
-  extractPieceHash(ctx, piecesData->s(), PIECE_HASH_LENGTH, numPieces);
+  extractPieceHash(ctx, torrentData ? piecesData->popValue() : piecesData->s(),
+                   PIECE_HASH_LENGTH, numPieces);
   // private flag
   const Integer* privateData = downcast<Integer>(infoDict->get(C_PRIVATE));
   int privatefg = 0;
@@ -526,14 +538,34 @@ void processRootDictionary(const std::shared_ptr<DownloadContext>& ctx,
 }
 } // namespace
 
+namespace {
+void loadFromFile(const std::string& torrentFile,
+                  const std::shared_ptr<DownloadContext>& ctx,
+                  const std::shared_ptr<Option>& option,
+                  const std::vector<std::string>& uris,
+                  const std::string& overrideName)
+{
+  std::string data;
+  std::unique_ptr<ValueBase> root;
+  if (util::readFile(data, torrentFile)) {
+    ValueBaseBencodeParser parser;
+    ssize_t error;
+    root = parser.parseFinal(data.c_str(), data.size(), error);
+  }
+  processRootDictionary(ctx, root.get(), option, torrentFile, overrideName,
+                        uris,
+                        reinterpret_cast<const unsigned char*>(data.c_str()),
+                        data.size());
+}
+} // namespace
+
 void load(const std::string& torrentFile,
           const std::shared_ptr<DownloadContext>& ctx,
           const std::shared_ptr<Option>& option,
           const std::string& overrideName)
 {
-  ValueBaseBencodeParser parser;
-  processRootDictionary(ctx, parseFile(parser, torrentFile).get(), option,
-                        torrentFile, overrideName, std::vector<std::string>());
+  loadFromFile(torrentFile, ctx, option, std::vector<std::string>(),
+               overrideName);
 }
 
 void load(const std::string& torrentFile,
@@ -541,9 +573,7 @@ void load(const std::string& torrentFile,
           const std::shared_ptr<Option>& option,
           const std::vector<std::string>& uris, const std::string& overrideName)
 {
-  ValueBaseBencodeParser parser;
-  processRootDictionary(ctx, parseFile(parser, torrentFile).get(), option,
-                        torrentFile, overrideName, uris);
+  loadFromFile(torrentFile, ctx, option, uris, overrideName);
 }
 
 void loadFromMemory(const unsigned char* content, size_t length,
@@ -553,7 +583,8 @@ void loadFromMemory(const unsigned char* content, size_t length,
                     const std::string& overrideName)
 {
   processRootDictionary(ctx, bencode2::decode(content, length).get(), option,
-                        defaultName, overrideName, std::vector<std::string>());
+                        defaultName, overrideName, std::vector<std::string>(),
+                        content, length);
 }
 
 void loadFromMemory(const unsigned char* content, size_t length,
@@ -564,7 +595,7 @@ void loadFromMemory(const unsigned char* content, size_t length,
                     const std::string& overrideName)
 {
   processRootDictionary(ctx, bencode2::decode(content, length).get(), option,
-                        defaultName, overrideName, uris);
+                        defaultName, overrideName, uris, content, length);
 }
 
 void loadFromMemory(const std::string& context,
@@ -573,8 +604,8 @@ void loadFromMemory(const std::string& context,
                     const std::string& defaultName,
                     const std::string& overrideName)
 {
-  processRootDictionary(ctx, bencode2::decode(context).get(), option,
-                        defaultName, overrideName, std::vector<std::string>());
+  loadFromMemory(reinterpret_cast<const unsigned char*>(context.c_str()),
+                 context.size(), ctx, option, defaultName, overrideName);
 }
 
 void loadFromMemory(const std::string& context,
@@ -584,8 +615,8 @@ void loadFromMemory(const std::string& context,
                     const std::string& defaultName,
                     const std::string& overrideName)
 {
-  processRootDictionary(ctx, bencode2::decode(context).get(), option,
-                        defaultName, overrideName, uris);
+  loadFromMemory(reinterpret_cast<const unsigned char*>(context.c_str()),
+                 context.size(), ctx, option, uris, defaultName, overrideName);
 }
 
 void loadFromMemory(const ValueBase* torrent,
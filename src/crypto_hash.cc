@@ -70,6 +70,206 @@ template <typename T> static forceinline T par(T b, T c, T d)
   w03 = endian(buffer[3]), w02 = endian(buffer[2]);                            \
   w01 = endian(buffer[1]), w00 = endian(buffer[0])
 
+// SHA-1 and SHA-256 using the x86 SHA extensions.  The compiler is
+// allowed to emit these instructions for the functions below only,
+// and they are called only if the CPU reports that it supports them.
+#if (defined(__x86_64__) || defined(__i386__)) &&                              \
+    (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5))
+#define CRYPTO_HASH_X86_SHA 1
+#endif // (__x86_64__ || __i386__) && (__clang__ || __GNUC__ >= 5)
+
+#ifdef CRYPTO_HASH_X86_SHA
+
+#include <cpuid.h>
+#include <immintrin.h>
+
+#define __hash_x86_sha __attribute__((target("sha,sse4.1")))
+
+static bool hasX86SHA()
+{
+  static const bool supported = []() {
+    unsigned int a, b, c, d;
+    // SSSE3 and SSE4.1 are needed for byte shuffling and blending.
+    if (!__get_cpuid(1, &a, &b, &c, &d) || !(c & (1 << 9)) ||
+        !(c & (1 << 19)) || __get_cpuid_max(0, nullptr) < 7) {
+      return false;
+    }
+    __cpuid_count(7, 0, a, b, c, d);
+    return (b & (1 << 29)) != 0;
+  }();
+  return supported;
+}
+
+// Rounds 4*i to 4*i+3 of SHA-1, for i >= 3.  m0 holds the message
+// words of these rounds.  It also advances the message schedule.
+#define __hash_sha1_rounds(i, e0, e1, m0, m1, m2, m3)                          \
+  e0 = _mm_sha1nexte_epu32(e0, m0);                                            \
+  e1 = abcd;                                                                   \
+  m1 = _mm_sha1msg2_epu32(m1, m0);                                             \
+  abcd = _mm_sha1rnds4_epu32(abcd, e0, (i) / 5);                               \
+  m3 = _mm_sha1msg1_epu32(m3, m0);                                             \
+  m2 = _mm_xor_si128(m2, m0)
+
+__hash_x86_sha static void sha1Blocks(uint32_t* state, const uint8_t* bytes,
+                                      size_t n)
+{
+  const __m128i mask =
+      _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+  __m128i abcd = _mm_shuffle_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0x1b);
+  __m128i e0 = _mm_set_epi32(state[4], 0, 0, 0);
+  __m128i e1, m0, m1, m2, m3;
+
+  for (; n; --n, bytes += 64) {
+    const __m128i abcdSave = abcd;
+    const __m128i e0Save = e0;
+
+    m0 = _mm_shuffle_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes)), mask);
+    e0 = _mm_add_epi32(e0, m0);
+    e1 = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+
+    m1 = _mm_shuffle_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + 16)), mask);
+    e1 = _mm_sha1nexte_epu32(e1, m1);
+    e0 = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, e1, 0);
+    m0 = _mm_sha1msg1_epu32(m0, m1);
+
+    m2 = _mm_shuffle_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + 32)), mask);
+    e0 = _mm_sha1nexte_epu32(e0, m2);
+    e1 = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+    m1 = _mm_sha1msg1_epu32(m1, m2);
+    m0 = _mm_xor_si128(m0, m2);
+
+    m3 = _mm_shuffle_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + 48)), mask);
+    __hash_sha1_rounds(3, e1, e0, m3, m0, m1, m2);
+    __hash_sha1_rounds(4, e0, e1, m0, m1, m2, m3);
+    __hash_sha1_rounds(5, e1, e0, m1, m2, m3, m0);
+    __hash_sha1_rounds(6, e0, e1, m2, m3, m0, m1);
+    __hash_sha1_rounds(7, e1, e0, m3, m0, m1, m2);
+    __hash_sha1_rounds(8, e0, e1, m0, m1, m2, m3);
+    __hash_sha1_rounds(9, e1, e0, m1, m2, m3, m0);
+    __hash_sha1_rounds(10, e0, e1, m2, m3, m0, m1);
+    __hash_sha1_rounds(11, e1, e0, m3, m0, m1, m2);
+    __hash_sha1_rounds(12, e0, e1, m0, m1, m2, m3);
+    __hash_sha1_rounds(13, e1, e0, m1, m2, m3, m0);
+    __hash_sha1_rounds(14, e0, e1, m2, m3, m0, m1);
+    __hash_sha1_rounds(15, e1, e0, m3, m0, m1, m2);
+    __hash_sha1_rounds(16, e0, e1, m0, m1, m2, m3);
+    __hash_sha1_rounds(17, e1, e0, m1, m2, m3, m0);
+    __hash_sha1_rounds(18, e0, e1, m2, m3, m0, m1);
+    __hash_sha1_rounds(19, e1, e0, m3, m0, m1, m2);
+
+    e0 = _mm_sha1nexte_epu32(e0, e0Save);
+    abcd = _mm_add_epi32(abcd, abcdSave);
+  }
+
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(state),
+                   _mm_shuffle_epi32(abcd, 0x1b));
+  state[4] = _mm_extract_epi32(e0, 3);
+}
+
+#undef __hash_sha1_rounds
+
+static const uint32_t sha256K[] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+    0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+// Rounds 4*i to 4*i+3 of SHA-256.  m0 holds the message words of
+// these rounds.
+#define __hash_sha256_rounds(i, m0)                                            \
+  msg = _mm_add_epi32(                                                         \
+      m0, _mm_loadu_si128(reinterpret_cast<const __m128i*>(sha256K + 4 * i))); \
+  cdgh = _mm_sha256rnds2_epu32(cdgh, abef, msg);                               \
+  abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(msg, 0x0e))
+
+// Same as above, for i >= 3.  It also advances the message schedule.
+#define __hash_sha256_rounds_msg(i, m0, m1, m2, m3)                            \
+  __hash_sha256_rounds(i, m0);                                                 \
+  m1 = _mm_sha256msg2_epu32(_mm_add_epi32(m1, _mm_alignr_epi8(m0, m3, 4)),     \
+                            m0);                                               \
+  m3 = _mm_sha256msg1_epu32(m3, m0)
+
+__hash_x86_sha static void sha256Blocks(uint32_t* state, const uint8_t* bytes,
+                                        size_t n)
+{
+  const __m128i mask =
+      _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+  // The instructions take the state as ABEF and CDGH.
+  __m128i tmp = _mm_shuffle_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0xb1);
+  __m128i cdgh = _mm_shuffle_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4)), 0x1b);
+  __m128i abef = _mm_alignr_epi8(tmp, cdgh, 8);
+  cdgh = _mm_blend_epi16(cdgh, tmp, 0xf0);
+  __m128i msg, m0, m1, m2, m3;
+
+  for (; n; --n, bytes += 64) {
+    const __m128i abefSave = abef;
+    const __m128i cdghSave = cdgh;
+
+    m0 = _mm_shuffle_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes)), mask);
+    __hash_sha256_rounds(0, m0);
+
+    m1 = _mm_shuffle_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + 16)), mask);
+    __hash_sha256_rounds(1, m1);
+    m0 = _mm_sha256msg1_epu32(m0, m1);
+
+    m2 = _mm_shuffle_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + 32)), mask);
+    __hash_sha256_rounds(2, m2);
+    m1 = _mm_sha256msg1_epu32(m1, m2);
+
+    m3 = _mm_shuffle_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + 48)), mask);
+    __hash_sha256_rounds_msg(3, m3, m0, m1, m2);
+    __hash_sha256_rounds_msg(4, m0, m1, m2, m3);
+    __hash_sha256_rounds_msg(5, m1, m2, m3, m0);
+    __hash_sha256_rounds_msg(6, m2, m3, m0, m1);
+    __hash_sha256_rounds_msg(7, m3, m0, m1, m2);
+    __hash_sha256_rounds_msg(8, m0, m1, m2, m3);
+    __hash_sha256_rounds_msg(9, m1, m2, m3, m0);
+    __hash_sha256_rounds_msg(10, m2, m3, m0, m1);
+    __hash_sha256_rounds_msg(11, m3, m0, m1, m2);
+    __hash_sha256_rounds_msg(12, m0, m1, m2, m3);
+    __hash_sha256_rounds_msg(13, m1, m2, m3, m0);
+    __hash_sha256_rounds_msg(14, m2, m3, m0, m1);
+    __hash_sha256_rounds(15, m3);
+
+    abef = _mm_add_epi32(abef, abefSave);
+    cdgh = _mm_add_epi32(cdgh, cdghSave);
+  }
+
+  tmp = _mm_shuffle_epi32(abef, 0x1b);
+  cdgh = _mm_shuffle_epi32(cdgh, 0xb1);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(state),
+                   _mm_blend_epi16(tmp, cdgh, 0xf0));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4),
+                   _mm_alignr_epi8(cdgh, tmp, 8));
+}
+
+#undef __hash_sha256_rounds_msg
+#undef __hash_sha256_rounds
+#undef __hash_x86_sha
+
+#endif // CRYPTO_HASH_X86_SHA
+
 using namespace crypto;
 using namespace crypto::hash;
 
@@ -93,6 +293,15 @@ protected:
 
   virtual void transform(const word_t* buffer) = 0;
 
+  // Transforms |n| consecutive blocks starting at |bytes|.  Subclasses
+  // may override this to process the blocks at once.
+  virtual void transformBlocks(const uint8_t* bytes, size_t n)
+  {
+    for (; n; --n, bytes += sizeof(buffer_)) {
+      transform(reinterpret_cast<const word_t*>(bytes));
+    }
+  }
+
   virtual std::string digest()
   {
     return std::string((const char*)state_.bytes, sizeof(state_.bytes));
@@ -119,19 +328,20 @@ public:
       bytes += turn;
       offset_ += turn;
       if (likely(offset_ == sizeof(buffer_))) {
-        transform(buffer_.words);
+        transformBlocks(buffer_.bytes, 1);
         offset_ = 0;
       }
     }
 
     // |transform| as many blocks as possible.
-    while (len >= sizeof(buffer_)) {
+    if (len >= sizeof(buffer_)) {
       // |offset_| has to be 0 at this point!
       // Which is guaranteed by the block above.
 
-      transform(reinterpret_cast<const word_t*>(bytes));
-      bytes += sizeof(buffer_);
-      len -= sizeof(buffer_);
+      const auto n = len / sizeof(buffer_);
+      transformBlocks(bytes, n);
+      bytes += n * sizeof(buffer_);
+      len -= n * sizeof(buffer_);
     }
 
     // Buffer remaining bytes, if any.
@@ -149,12 +359,12 @@ public:
     const uint_fast16_t cutoff = sizeof(buffer_) - sizeof(word_t) * 2;
     buffer_.bytes[offset_] = 0x80;
     if (unlikely(++offset_ == sizeof(buffer_))) {
-      transform(buffer_.words);
+      transformBlocks(buffer_.bytes, 1);
       memset(buffer_.bytes, 0x00, cutoff);
     }
     else if (offset_ > cutoff) {
       memset(buffer_.bytes + offset_, 0x00, sizeof(buffer_) - offset_);
-      transform(buffer_.words);
+      transformBlocks(buffer_.bytes, 1);
       memset(buffer_.bytes, 0x00, cutoff);
     }
     else if (likely(offset_ != cutoff)) {
@@ -178,7 +388,7 @@ public:
     }
 
     // Last transform:
-    transform(buffer_.words);
+    transformBlocks(buffer_.bytes, 1);
 
 #if LITTLE_ENDIAN == BYTE_ORDER
     // On little endian, we still need to swap the bytes.
@@ -513,6 +723,17 @@ protected:
     state_.words[4] += e;
   }
 
+#ifdef CRYPTO_HASH_X86_SHA
+  virtual void transformBlocks(const uint8_t* bytes, size_t n)
+  {
+    if (hasX86SHA()) {
+      sha1Blocks(state_.words, bytes, n);
+      return;
+    }
+    AlgorithmImpl::transformBlocks(bytes, n);
+  }
+#endif // CRYPTO_HASH_X86_SHA
+
 public:
   SHA1() { reset(); }
 
@@ -709,6 +930,17 @@ protected:
     state_.words[7] += h;
   }
 
+#ifdef CRYPTO_HASH_X86_SHA
+  virtual void transformBlocks(const uint8_t* bytes, size_t n)
+  {
+    if (hasX86SHA()) {
+      sha256Blocks(state_.words, bytes, n);
+      return;
+    }
+    AlgorithmImpl::transformBlocks(bytes, n);
+  }
+#endif // CRYPTO_HASH_X86_SHA
+
 public:
   SHA256() { reset(); }
 
@@ -182,20 +182,34 @@ std::shared_ptr<MetadataInfo> createMetadataInfoDataOnly()
 #ifdef ENABLE_BITTORRENT
 
 namespace {
+// Creates RequestGroup from the decoded torrent if it is not null,
+// or from the bencoded torrentData otherwise. The latter saves
+// encoding info dictionary again to compute the info hash.
 std::shared_ptr<RequestGroup>
 createBtRequestGroup(const std::string& metaInfoUri,
                      const std::shared_ptr<Option>& optionTemplate,
                      const std::vector<std::string>& auxUris,
-                     const ValueBase* torrent, bool adjustAnnounceUri = true)
+                     const ValueBase* torrent, const std::string& torrentData,
+                     bool adjustAnnounceUri = true)
 {
   auto option = util::copy(optionTemplate);
   auto gid = getGID(option);
   auto rg = std::make_shared<RequestGroup>(gid, option);
   auto dctx = std::make_shared<DownloadContext>();
+  const auto& defaultName = metaInfoUri.empty() ? "default" : metaInfoUri;
   // may throw exception
-  bittorrent::loadFromMemory(torrent, dctx, option, auxUris,
-                             metaInfoUri.empty() ? "default" : metaInfoUri);
+  if (torrent) {
+    bittorrent::loadFromMemory(torrent, dctx, option, auxUris, defaultName);
+  }
+  else {
+    bittorrent::loadFromMemory(torrentData, dctx, option, auxUris,
+                               defaultName);
+  }
   for (auto& fe : dctx->getFileEntries()) {
+    // Don't let files without web-seeding allocate URI state.
+    if (fe->emptyRequestUri()) {
+      continue;
+    }
     auto& uris = fe->getRemainingUris();
     std::shuffle(std::begin(uris), std::end(uris),
                  *SimpleRandomizer::getInstance());
@@ -256,7 +270,7 @@ createBtMagnetRequestGroup(const std::string& magnetLink,
     auto torrent = parseFile(parser, torrentFilename);
     if (torrent) {
       auto rg = createBtRequestGroup(torrentFilename, optionTemplate, {},
-                                     torrent.get());
+                                     torrent.get(), A2STR::NIL);
       const auto& actualInfoHash =
           bittorrent::getTorrentAttrs(rg->getDownloadContext())->infoHash;
 
@@ -302,27 +316,43 @@ createBtMagnetRequestGroup(const std::string& magnetLink,
 }
 } // namespace
 
+namespace {
 void createRequestGroupForBitTorrent(
     std::vector<std::shared_ptr<RequestGroup>>& result,
     const std::shared_ptr<Option>& option, const std::vector<std::string>& uris,
-    const std::string& metaInfoUri, const std::string& torrentData,
-    bool adjustAnnounceUri)
+    const std::string& metaInfoUri, const ValueBase* torrent,
+    const std::string& torrentData, bool adjustAnnounceUri)
 {
-  std::unique_ptr<ValueBase> torrent;
-  bittorrent::ValueBaseBencodeParser parser;
-  if (torrentData.empty()) {
-    torrent = parseFile(parser, metaInfoUri);
+  std::vector<std::string> nargs;
+  if (option->get(PREF_PARAMETERIZED_URI) == A2_V_TRUE) {
+    unfoldURI(nargs, uris);
   }
   else {
-    ssize_t error;
-    torrent = parser.parseFinal(torrentData.c_str(), torrentData.size(), error);
+    nargs = uris;
   }
-  if (!torrent) {
+  // we ignore -Z option here
+  size_t numSplit = option->getAsInt(PREF_SPLIT);
+  auto rg = createBtRequestGroup(metaInfoUri, option, nargs, torrent,
+                                 torrentData, adjustAnnounceUri);
+  rg->setNumConcurrentCommand(numSplit);
+  result.push_back(rg);
+}
+} // namespace
+
+void createRequestGroupForBitTorrent(
+    std::vector<std::shared_ptr<RequestGroup>>& result,
+    const std::shared_ptr<Option>& option, const std::vector<std::string>& uris,
+    const std::string& metaInfoUri, const std::string& torrentData,
+    bool adjustAnnounceUri)
+{
+  std::string data;
+  if (torrentData.empty() && !util::readFile(data, metaInfoUri)) {
     throw DL_ABORT_EX2("Bencode decoding failed",
                        error_code::BENCODE_PARSE_ERROR);
   }
-  createRequestGroupForBitTorrent(result, option, uris, metaInfoUri,
-                                  torrent.get(), adjustAnnounceUri);
+  createRequestGroupForBitTorrent(result, option, uris, metaInfoUri, nullptr,
+                                  torrentData.empty() ? data : torrentData,
+                                  adjustAnnounceUri);
 }
 
 void createRequestGroupForBitTorrent(
@@ -331,19 +361,8 @@ void createRequestGroupForBitTorrent(
     const std::string& metaInfoUri, const ValueBase* torrent,
     bool adjustAnnounceUri)
 {
-  std::vector<std::string> nargs;
-  if (option->get(PREF_PARAMETERIZED_URI) == A2_V_TRUE) {
-    unfoldURI(nargs, uris);
-  }
-  else {
-    nargs = uris;
-  }
-  // we ignore -Z option here
-  size_t numSplit = option->getAsInt(PREF_SPLIT);
-  auto rg = createBtRequestGroup(metaInfoUri, option, nargs, torrent,
-                                 adjustAnnounceUri);
-  rg->setNumConcurrentCommand(numSplit);
-  result.push_back(rg);
+  createRequestGroupForBitTorrent(result, option, uris, metaInfoUri, torrent,
+                                  A2STR::NIL, adjustAnnounceUri);
 }
 
 #endif // ENABLE_BITTORRENT
@@ -407,14 +426,13 @@ public:
     }
     else if (!ignoreLocalPath_ && detector_.guessTorrentFile(uri)) {
       try {
-        bittorrent::ValueBaseBencodeParser parser;
-        auto torrent = parseFile(parser, uri);
-        if (!torrent) {
+        std::string torrentData;
+        if (!util::readFile(torrentData, uri)) {
           throw DL_ABORT_EX2("Bencode decoding failed",
                              error_code::BENCODE_PARSE_ERROR);
         }
         requestGroups_.push_back(
-            createBtRequestGroup(uri, option_, {}, torrent.get()));
+            createBtRequestGroup(uri, option_, {}, nullptr, torrentData));
       }
       catch (RecoverableException& e) {
         if (throwOnError_) {
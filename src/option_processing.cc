@@ -335,12 +335,6 @@ error_code::Value option_processing(Option& op, bool standalone,
       return error_code::UNKNOWN_ERROR;
     }
   }
-  if (op.getAsBool(PREF_DEFERRED_INPUT) && op.defined(PREF_SAVE_SESSION)) {
-    A2_LOG_WARN("--deferred-input is disabled because of the presence of "
-                "--save-session");
-    op.remove(PREF_DEFERRED_INPUT);
-  }
-
   return error_code::FINISHED;
 }
 
@@ -154,6 +154,9 @@ const std::string A2_V_SSL3("SSLv3");
 const std::string A2_V_TLS10("TLSv1");
 const std::string A2_V_TLS11("TLSv1.1");
 const std::string A2_V_TLS12("TLSv1.2");
+const std::string V_ROUND_ROBIN("round-robin");
+const std::string V_FASTEST_UPLOAD("fastest-upload");
+const std::string V_ANTI_LEECH("anti-leech");
 
 PrefPtr PREF_VERSION = makePref("version");
 PrefPtr PREF_HELP = makePref("help");
@@ -523,6 +526,10 @@ PrefPtr PREF_BT_REQUEST_PEER_SPEED_LIMIT =
 PrefPtr PREF_BT_MAX_OPEN_FILES = makePref("bt-max-open-files");
 // values: true | false
 PrefPtr PREF_BT_SEED_UNVERIFIED = makePref("bt-seed-unverified");
+// values: round-robin | fastest-upload | anti-leech
+PrefPtr PREF_BT_SEED_CHOKING_ALGORITHM = makePref("bt-seed-choking-algorithm");
+// values: 1*digit
+PrefPtr PREF_BT_UPLOAD_SLOT_TARGET = makePref("bt-upload-slot-target");
 // values: true | false
 PrefPtr PREF_BT_HASH_CHECK_SEED = makePref("bt-hash-check-seed");
 // values: 1*digit
@@ -567,6 +574,8 @@ PrefPtr PREF_BT_ENABLE_HOOK_AFTER_HASH_CHECK =
     makePref("bt-enable-hook-after-hash-check");
 // values: true | false
 PrefPtr PREF_BT_LOAD_SAVED_METADATA = makePref("bt-load-saved-metadata");
+// values: true | false
+PrefPtr PREF_BT_REUSE_PORT = makePref("bt-reuse-port");
 
 /**
  * Metalink related preferences
@@ -111,6 +111,9 @@ extern const std::string A2_V_SSL3;
 extern const std::string A2_V_TLS10;
 extern const std::string A2_V_TLS11;
 extern const std::string A2_V_TLS12;
+extern const std::string V_ROUND_ROBIN;
+extern const std::string V_FASTEST_UPLOAD;
+extern const std::string V_ANTI_LEECH;
 
 extern PrefPtr PREF_VERSION;
 extern PrefPtr PREF_HELP;
@@ -474,6 +477,10 @@ extern PrefPtr PREF_BT_REQUEST_PEER_SPEED_LIMIT;
 extern PrefPtr PREF_BT_MAX_OPEN_FILES;
 // values: true | false
 extern PrefPtr PREF_BT_SEED_UNVERIFIED;
+// values: round-robin | fastest-upload | anti-leech
+extern PrefPtr PREF_BT_SEED_CHOKING_ALGORITHM;
+// values: 1*digit
+extern PrefPtr PREF_BT_UPLOAD_SLOT_TARGET;
 // values: true | false
 extern PrefPtr PREF_BT_HASH_CHECK_SEED;
 // values: 1*digit
@@ -518,6 +525,8 @@ extern PrefPtr PREF_BT_FORCE_ENCRYPTION;
 extern PrefPtr PREF_BT_ENABLE_HOOK_AFTER_HASH_CHECK;
 // values: true | false
 extern PrefPtr PREF_BT_LOAD_SAVED_METADATA;
+// values: true | false
+extern PrefPtr PREF_BT_REUSE_PORT;
 
 /**
  * Metalink related preferences
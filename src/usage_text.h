@@ -373,6 +373,25 @@
   _(" --bt-max-open-files=NUM      Specify maximum number of files to open in\n" \
     "                              multi-file BitTorrent/Metalink downloads\n" \
     "                              globally.")
+#define TEXT_BT_SEED_CHOKING_ALGORITHM                                  \
+  _(" --bt-seed-choking-algorithm=ALGORITHM Specify the algorithm to choose\n" \
+    "                              peers to unchoke while seeding. If\n" \
+    "                              'round-robin' is given, aria2 prefers peers\n" \
+    "                              which it is uploading to and which it unchoked\n" \
+    "                              recently, so that upload slots rotate among\n" \
+    "                              peers. If 'fastest-upload' is given, aria2\n" \
+    "                              prefers peers which it uploads to fastest. If\n" \
+    "                              'anti-leech' is given, aria2 prefers peers\n" \
+    "                              which have just started or almost finished\n" \
+    "                              downloading.")
+#define TEXT_BT_UPLOAD_SLOT_TARGET                                      \
+  _(" --bt-upload-slot-target=PERCENT Adjust the number of unchoked peers\n" \
+    "                              automatically so that upload speed stays\n" \
+    "                              around PERCENT of the upload capacity. The\n" \
+    "                              capacity is --max-upload-limit if it is\n" \
+    "                              given, or the peak upload speed observed\n" \
+    "                              otherwise. If 0 is given, the number of\n" \
+    "                              unchoked peers is fixed.")
 #define TEXT_BT_SEED_UNVERIFIED                                         \
   _(" --bt-seed-unverified[=true|false] Seed previously downloaded files without\n" \
     "                              verifying piece hashes.")
@@ -1126,5 +1145,13 @@
     "                              file saved by --bt-save-metadata option. If it is\n" \
     "                              successful, then skip downloading metadata from\n" \
     "                              DHT.")
+#define TEXT_BT_REUSE_PORT                                              \
+  _(" --bt-reuse-port[=true|false] Set SO_REUSEPORT on BitTorrent listening\n" \
+    "                              sockets so that several aria2 processes can\n" \
+    "                              listen on the same port specified by\n" \
+    "                              --listen-port. The kernel distributes incoming\n" \
+    "                              connections among them. This option is only\n" \
+    "                              available on platforms which support\n" \
+    "                              SO_REUSEPORT.")
 
 // clang-format on
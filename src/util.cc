@@ -2095,6 +2095,21 @@ bool saveAs(const std::string& filename, const std::string& data,
   return File(tempFilename).renameTo(filename);
 }
 
+bool readFile(std::string& data, const std::string& filename)
+{
+  BufferedFile fp(filename.c_str(), BufferedFile::READ);
+  if (!fp) {
+    return false;
+  }
+  data.reserve(data.size() + File(filename).size());
+  std::array<char, 16_k> buf;
+  size_t nread;
+  while ((nread = fp.read(buf.data(), buf.size())) > 0) {
+    data.append(buf.data(), nread);
+  }
+  return fp.eof();
+}
+
 std::string applyDir(const std::string& dir, const std::string& relPath)
 {
   std::string s;
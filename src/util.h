@@ -722,6 +722,11 @@ void generateRandomData(unsigned char* data, size_t length);
 bool saveAs(const std::string& filename, const std::string& data,
             bool overwrite = false);
 
+// Reads the whole content of file whose name is filename and appends
+// it to data. Returns true if the file is read successfully.
+// Otherwise returns false.
+bool readFile(std::string& data, const std::string& filename);
+
 // Prepend dir to relPath. If dir is empty, it prepends "." to relPath.
 //
 // dir = "/dir", relPath = "foo" => "/dir/foo"
@@ -1,6 +1,7 @@
 #include "ARC4Encryptor.h"
 
 #include <cstring>
+#include <vector>
 #include <cppunit/extensions/HelperMacros.h>
 
 #include "Exception.h"
@@ -12,6 +13,8 @@ class ARC4Test : public CppUnit::TestFixture {
 
   CPPUNIT_TEST_SUITE(ARC4Test);
   CPPUNIT_TEST(testEncrypt);
+  CPPUNIT_TEST(testEncrypt_rfc6229);
+  CPPUNIT_TEST(testEncrypt_length);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -20,6 +23,8 @@ public:
   void tearDown() {}
 
   void testEncrypt();
+  void testEncrypt_rfc6229();
+  void testEncrypt_length();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(ARC4Test);
@@ -50,4 +55,106 @@ void ARC4Test::testEncrypt()
   CPPUNIT_ASSERT(memcmp(key, decrypted, LEN) == 0);
 }
 
+namespace {
+// Returns the first len bytes of the keystream for key.
+std::vector<unsigned char> keystream(const unsigned char* key,
+                                     size_t keylen, size_t len)
+{
+  ARC4Encryptor enc;
+  enc.init(key, keylen);
+  std::vector<unsigned char> zero(len), out(len);
+  enc.encrypt(len, out.data(), zero.data());
+  return out;
+}
+} // namespace
+
+void ARC4Test::testEncrypt_rfc6229()
+{
+  // Test vectors from RFC 6229, section 2.
+  struct {
+    size_t offset;
+    const char* key40;
+    const char* key128;
+  } vectors[] = {
+      {0, "b2396305f03dc027ccc3524a0a1118a8",
+       "9ac7cc9a609d1ef7b2932899cde41b97"},
+      {16, "6982944f18fc82d589c403a47a0d0919",
+       "5248c4959014126a6e8a84f11d1a9e1c"},
+      {240, "28cb1132c96ce286421dcaadb8b69eae",
+       "065902e4b620f6cc36c8589f66432f2b"},
+      {256, "1cfcf62b03eddb641d77dfcf7f8d8c93",
+       "d39d566bc6bce3010768151549f3873f"},
+      {496, "42b7d0cdd918a8a33dd51781c81f4041",
+       "b6d1e6c4a5e4771cad79538df295fb11"},
+      {512, "6459844432a7da923cfb3eb4980661f6",
+       "c68c1d5c559a974123df1dbc52a43b89"},
+      {752, "ec10327bde2beefd18f9277680457e22",
+       "c5ecf88de897fd57fed301701b82a259"},
+      {768, "eb62638d4f0ba1fe9fca20e05bf8ff2b",
+       "eccbe13de1fcc91c11a0b26c0bc8fa4d"},
+      {1008, "45129048e6a0ed0b56b490338f078da5",
+       "e7a72574f8782ae26aabcf9ebcd66065"},
+      {1024, "30abbcc7c20b01609f23ee2d5f6bb7df",
+       "bdf0324e6083dcc6d3cedd3ca8c53c16"},
+      {1520, "3294f744d8f9790507e70f62e5bbceea",
+       "b40110c4190b5622a96116b0017ed297"},
+      {1536, "d8729db41882259bee4f825325f5a130",
+       "ffa0b514647ec04f6306b892ae661181"},
+      {2032, "1eb14a0c13b3bf47fa2a0ba93ad45b8b",
+       "d03d1bc03cd33d70dff9fa5d71963ebd"},
+      {2048, "cc582f8ba9f265e2b1be9112e975d2d7",
+       "8a44126411eaa78bd51e8d87a8879bf5"},
+      {3056, "f2e30f9bd102ecbf75aaade9bc35c43c",
+       "fabeb76028ade2d0e48722e46c4615a3"},
+      {3072, "ec0e11c479dc329dc8da7968fe965681",
+       "c05d88abd50357f935a63c59ee537623"},
+      {4080, "068326a2118416d21f9d04b2cd1ca050",
+       "ff38265c1642c1abe8d3c2fe5e572bf8"},
+      {4096, "ff25b58995996707e51fbdf08b34d875",
+       "a36a4c301ae8ac13610ccbc12256cacc"},
+  };
+  const unsigned char key40[] = {0x01, 0x02, 0x03, 0x04, 0x05};
+  const unsigned char key128[] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06,
+                                  0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c,
+                                  0x0d, 0x0e, 0x0f, 0x10};
+  auto ks40 = keystream(key40, sizeof(key40), 4112);
+  auto ks128 = keystream(key128, sizeof(key128), 4112);
+  for (const auto& v : vectors) {
+    CPPUNIT_ASSERT_EQUAL(std::string(v.key40),
+                         util::toHex(ks40.data() + v.offset, 16));
+    CPPUNIT_ASSERT_EQUAL(std::string(v.key128),
+                         util::toHex(ks128.data() + v.offset, 16));
+  }
+}
+
+void ARC4Test::testEncrypt_length()
+{
+  // Buffers whose length is not a multiple of the word size must give
+  // the same result as encrypting one byte at a time.
+  const unsigned char key[] = "aria2 ARC4 test key";
+  const size_t lens[] = {1, 7, 15, 17, 4097};
+  for (auto len : lens) {
+    std::vector<unsigned char> in(len);
+    for (size_t i = 0; i < len; ++i) {
+      in[i] = i * 31 + 7;
+    }
+    ARC4Encryptor enc;
+    ARC4Encryptor ref;
+    enc.init(key, sizeof(key));
+    ref.init(key, sizeof(key));
+    std::vector<unsigned char> out(len), expected(len);
+    enc.encrypt(len, out.data(), in.data());
+    for (size_t i = 0; i < len; ++i) {
+      ref.encrypt(1, &expected[i], &in[i]);
+    }
+    CPPUNIT_ASSERT_EQUAL(util::toHex(expected.data(), len),
+                         util::toHex(out.data(), len));
+    // The keystream continues where the last buffer left off.
+    unsigned char a, b;
+    enc.encrypt(1, &a, in.data());
+    ref.encrypt(1, &b, in.data());
+    CPPUNIT_ASSERT_EQUAL((int)b, (int)a);
+  }
+}
+
 } // namespace aria2
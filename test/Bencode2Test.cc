@@ -10,11 +10,15 @@ class Bencode2Test : public CppUnit::TestFixture {
 
   CPPUNIT_TEST_SUITE(Bencode2Test);
   CPPUNIT_TEST(testEncode);
+  CPPUNIT_TEST(testFindDictValue);
+  CPPUNIT_TEST(testIsCanonical);
   CPPUNIT_TEST_SUITE_END();
 
 private:
 public:
   void testEncode();
+  void testFindDictValue();
+  void testIsCanonical();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(Bencode2Test);
@@ -42,4 +46,64 @@ void Bencode2Test::testEncode()
   }
 }
 
+namespace {
+bool isCanonical(const std::string& s)
+{
+  return bencode2::isCanonical(
+      reinterpret_cast<const unsigned char*>(s.data()), s.size());
+}
+} // namespace
+
+void Bencode2Test::testFindDictValue()
+{
+  std::string s = "d5:filesld6:lengthi1eee4:infod4:name5:aria2e"
+                  "3:loci-1.5E+3e4:info3:GPLe";
+  auto data = reinterpret_cast<const unsigned char*>(s.data());
+  size_t first, last;
+  // The last one wins, just like decode() does.
+  CPPUNIT_ASSERT(bencode2::findDictValue(data, s.size(), "info", first, last));
+  CPPUNIT_ASSERT_EQUAL(std::string("3:GPL"), s.substr(first, last - first));
+  CPPUNIT_ASSERT(bencode2::findDictValue(data, s.size(), "files", first, last));
+  CPPUNIT_ASSERT_EQUAL(std::string("ld6:lengthi1eee"),
+                       s.substr(first, last - first));
+  CPPUNIT_ASSERT(bencode2::findDictValue(data, s.size(), "loc", first, last));
+  CPPUNIT_ASSERT_EQUAL(std::string("i-1.5E+3e"), s.substr(first, last - first));
+  // A string value must not be taken as a key.
+  CPPUNIT_ASSERT(!bencode2::findDictValue(data, s.size(), "name", first, last));
+  // Truncated
+  CPPUNIT_ASSERT(
+      !bencode2::findDictValue(data, s.size() - 1, "info", first, last));
+  CPPUNIT_ASSERT(!bencode2::findDictValue(data, 1, "info", first, last));
+  // Not a dictionary
+  s = "l4:infoe";
+  CPPUNIT_ASSERT(!bencode2::findDictValue(
+      reinterpret_cast<const unsigned char*>(s.data()), s.size(), "info",
+      first, last));
+}
+
+void Bencode2Test::testIsCanonical()
+{
+  CPPUNIT_ASSERT(isCanonical("d5:filesld6:lengthi1eee4:name5:aria2e"));
+  CPPUNIT_ASSERT(isCanonical("li0ei-1e0:dee"));
+  CPPUNIT_ASSERT(isCanonical("d1:a0:2:aai1ee"));
+  // Unsorted or duplicate keys
+  CPPUNIT_ASSERT(!isCanonical("d4:name5:aria25:filesi1ee"));
+  CPPUNIT_ASSERT(!isCanonical("d1:ai1e1:ai2ee"));
+  CPPUNIT_ASSERT(!isCanonical("d2:aai1e1:ai2ee"));
+  // Redundant characters in numbers
+  CPPUNIT_ASSERT(!isCanonical("i01e"));
+  CPPUNIT_ASSERT(!isCanonical("i-0e"));
+  CPPUNIT_ASSERT(!isCanonical("ie"));
+  CPPUNIT_ASSERT(!isCanonical("i-1.5E+3e"));
+  CPPUNIT_ASSERT(!isCanonical("03:foo"));
+  // Malformed
+  CPPUNIT_ASSERT(!isCanonical(""));
+  CPPUNIT_ASSERT(!isCanonical("i1ei2e"));
+  CPPUNIT_ASSERT(!isCanonical("d1:ae"));
+  CPPUNIT_ASSERT(!isCanonical("di1ei2ee"));
+  CPPUNIT_ASSERT(!isCanonical("4:foo"));
+  CPPUNIT_ASSERT(!isCanonical("l"));
+  CPPUNIT_ASSERT(!isCanonical("e"));
+}
+
 } // namespace aria2
@@ -507,6 +507,30 @@ void BittorrentHelperTest::testLoadFromMemory()
   std::string correctHash = "248d0a1cd08284299de78d5c1ed359bb46717d8c";
 
   CPPUNIT_ASSERT_EQUAL(correctHash, getInfoHashString(dctx));
+  auto attrs = getTorrentAttrs(dctx);
+  auto infoFirst = memory.find("4:info") + 6;
+  CPPUNIT_ASSERT_EQUAL(memory.substr(infoFirst, memory.size() - infoFirst - 1),
+                       attrs->metadata);
+  CPPUNIT_ASSERT_EQUAL(attrs->metadata.size(), attrs->metadataSize);
+  CPPUNIT_ASSERT_EQUAL((size_t)3, dctx->getNumPieces());
+  CPPUNIT_ASSERT_EQUAL(std::string("CCCCCCCCCCCCCCCCCCCC"),
+                       dctx->getPieceHash(2));
+
+  // Info dictionary with unsorted keys is hashed in the canonical
+  // form, just like the decoded one passed to loadFromMemory().
+  memory = "d4:infod4:name10:aria2-test6:lengthi384e12:piece lengthi128e"
+           "6:pieces60:"
+           "AAAAAAAAAAAAAAAAAAAABBBBBBBBBBBBBBBBBBBBCCCCCCCCCCCCCCCCCCCC"
+           "ee";
+  dctx = std::make_shared<DownloadContext>();
+  loadFromMemory(memory, dctx, option_, "default");
+  auto canonicalDctx = std::make_shared<DownloadContext>();
+  loadFromMemory(bencode2::decode(memory).get(), canonicalDctx, option_,
+                 std::vector<std::string>(), "default");
+  CPPUNIT_ASSERT_EQUAL(getInfoHashString(canonicalDctx),
+                       getInfoHashString(dctx));
+  CPPUNIT_ASSERT_EQUAL(getTorrentAttrs(canonicalDctx)->metadata,
+                       getTorrentAttrs(dctx)->metadata);
 }
 
 void BittorrentHelperTest::testLoadFromMemory_somethingMissing()
@@ -0,0 +1,39 @@
+#include "BtHaveBatchMessage.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "util.h"
+
+namespace aria2 {
+
+class BtHaveBatchMessageTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(BtHaveBatchMessageTest);
+  CPPUNIT_TEST(testCreateMessage);
+  CPPUNIT_TEST(testToString);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void testCreateMessage();
+  void testToString();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(BtHaveBatchMessageTest);
+
+void BtHaveBatchMessageTest::testCreateMessage()
+{
+  BtHaveBatchMessage msg({1, 258});
+  CPPUNIT_ASSERT_EQUAL((uint8_t)4, msg.getId());
+  auto rawmsg = msg.createMessage();
+  CPPUNIT_ASSERT_EQUAL(std::string("000000050400000001"
+                                   "000000050400000102"),
+                       util::toHex(rawmsg.data(), rawmsg.size()));
+}
+
+void BtHaveBatchMessageTest::testToString()
+{
+  BtHaveBatchMessage msg({1, 2, 3});
+  CPPUNIT_ASSERT_EQUAL(std::string("have count=3"), msg.toString());
+}
+
+} // namespace aria2
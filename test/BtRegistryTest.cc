@@ -5,6 +5,7 @@
 #include "Exception.h"
 #include "DownloadContext.h"
 #include "MockPeerStorage.h"
+#include "DefaultPeerStorage.h"
 #include "MockPieceStorage.h"
 #include "MockBtAnnounce.h"
 #include "MockBtProgressInfoFile.h"
@@ -23,6 +24,7 @@ class BtRegistryTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testGetAllDownloadContext);
   CPPUNIT_TEST(testRemove);
   CPPUNIT_TEST(testRemoveAll);
+  CPPUNIT_TEST(testIsBadPeer);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -32,6 +34,7 @@ public:
   void testGetAllDownloadContext();
   void testRemove();
   void testRemoveAll();
+  void testIsBadPeer();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(BtRegistryTest);
@@ -109,4 +112,25 @@ void BtRegistryTest::testRemoveAll()
   CPPUNIT_ASSERT(!btRegistry.get(2));
 }
 
+void BtRegistryTest::testIsBadPeer()
+{
+  BtRegistry btRegistry;
+  CPPUNIT_ASSERT(!btRegistry.isBadPeer("192.168.0.1"));
+
+  auto ps1 = std::make_shared<DefaultPeerStorage>();
+  auto ps2 = std::make_shared<DefaultPeerStorage>();
+  auto btObject1 = make_unique<BtObject>();
+  btObject1->peerStorage = ps1;
+  auto btObject2 = make_unique<BtObject>();
+  btObject2->peerStorage = ps2;
+  btRegistry.put(1, std::move(btObject1));
+  btRegistry.put(2, std::move(btObject2));
+
+  ps1->addBadPeer("192.168.0.1");
+  CPPUNIT_ASSERT(!btRegistry.isBadPeer("192.168.0.1"));
+  ps2->addBadPeer("192.168.0.1");
+  CPPUNIT_ASSERT(btRegistry.isBadPeer("192.168.0.1"));
+  CPPUNIT_ASSERT(!btRegistry.isBadPeer("192.168.0.2"));
+}
+
 } // namespace aria2
@@ -0,0 +1,83 @@
+#include "BtSeederStateChoke.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "Peer.h"
+#include "MockBtMessageDispatcher.h"
+#include "a2functional.h"
+
+namespace aria2 {
+
+class BtSeederStateChokeTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(BtSeederStateChokeTest);
+  CPPUNIT_TEST(testExecuteChoke_antiLeech);
+  CPPUNIT_TEST(testExecuteChoke_notInterested);
+  CPPUNIT_TEST_SUITE_END();
+
+  MockBtMessageDispatcher dispatcher_;
+
+  // Creates interested peer which has first numPieces pieces out of
+  // 10 pieces.
+  std::shared_ptr<Peer> createPeer(uint16_t port, size_t numPieces)
+  {
+    auto peer = std::make_shared<Peer>("192.168.0.1", port);
+    peer->allocateSessionResource(1_k, 10_k);
+    peer->setBtMessageDispatcher(&dispatcher_);
+    peer->peerInterested(true);
+    for (size_t i = 0; i < numPieces; ++i) {
+      peer->updateBitfield(i, 1);
+    }
+    return peer;
+  }
+
+public:
+  void testExecuteChoke_antiLeech();
+  void testExecuteChoke_notInterested();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(BtSeederStateChokeTest);
+
+void BtSeederStateChokeTest::testExecuteChoke_antiLeech()
+{
+  auto peer0 = createPeer(6881, 5);
+  auto peer1 = createPeer(6882, 0);
+  auto peer2 = createPeer(6883, 4);
+  auto peer3 = createPeer(6884, 9);
+  auto peer4 = createPeer(6885, 6);
+  auto peer5 = createPeer(6886, 2);
+  PeerSet peerSet{peer0, peer1, peer2, peer3, peer4, peer5};
+
+  BtSeederStateChoke choke;
+  choke.setAlgorithm(BtSeederStateChoke::ANTI_LEECH);
+  choke.executeChoke(peerSet);
+
+  // Peers farthest from the half way are unchoked.
+  CPPUNIT_ASSERT(!peer1->chokingRequired());
+  CPPUNIT_ASSERT(!peer3->chokingRequired());
+  CPPUNIT_ASSERT(!peer5->chokingRequired());
+  CPPUNIT_ASSERT(peer0->chokingRequired());
+  CPPUNIT_ASSERT(peer2->chokingRequired());
+  CPPUNIT_ASSERT(peer4->chokingRequired());
+  // One of the rest is unchoked optimistically.
+  CPPUNIT_ASSERT_EQUAL(1, peer0->optUnchoking() + peer2->optUnchoking() +
+                              peer4->optUnchoking());
+}
+
+void BtSeederStateChokeTest::testExecuteChoke_notInterested()
+{
+  auto peer0 = createPeer(6881, 0);
+  auto peer1 = createPeer(6882, 0);
+  peer1->peerInterested(false);
+  peer1->optUnchoking(true);
+  PeerSet peerSet{peer0, peer1};
+
+  BtSeederStateChoke choke;
+  choke.executeChoke(peerSet);
+
+  CPPUNIT_ASSERT(!peer0->chokingRequired());
+  CPPUNIT_ASSERT(peer1->chokingRequired());
+  CPPUNIT_ASSERT(!peer1->optUnchoking());
+}
+
+} // namespace aria2
@@ -1,5 +1,7 @@
 #include "DefaultPieceStorage.h"
 
+#include <algorithm>
+
 #include <cppunit/extensions/HelperMacros.h>
 
 #include "util.h"
@@ -27,12 +29,14 @@ class DefaultPieceStorageTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testGetMissingPiece_many);
   CPPUNIT_TEST(testGetMissingPiece_excludedIndexes);
   CPPUNIT_TEST(testGetMissingPiece_manyWithExcludedIndexes);
+  CPPUNIT_TEST(testGetMissingPiece_endGame);
   CPPUNIT_TEST(testGetMissingFastPiece);
   CPPUNIT_TEST(testGetMissingFastPiece_excludedIndexes);
   CPPUNIT_TEST(testHasMissingPiece);
   CPPUNIT_TEST(testCompletePiece);
   CPPUNIT_TEST(testGetPiece);
   CPPUNIT_TEST(testGetPieceInUsedPieces);
+  CPPUNIT_TEST(testGetInFlightPieces);
   CPPUNIT_TEST(testGetPieceCompletedPiece);
   CPPUNIT_TEST(testCancelPiece);
   CPPUNIT_TEST(testMarkPiecesDone);
@@ -66,12 +70,14 @@ public:
   void testGetMissingPiece_many();
   void testGetMissingPiece_excludedIndexes();
   void testGetMissingPiece_manyWithExcludedIndexes();
+  void testGetMissingPiece_endGame();
   void testGetMissingFastPiece();
   void testGetMissingFastPiece_excludedIndexes();
   void testHasMissingPiece();
   void testCompletePiece();
   void testGetPiece();
   void testGetPieceInUsedPieces();
+  void testGetInFlightPieces();
   void testGetPieceCompletedPiece();
   void testCancelPiece();
   void testMarkPiecesDone();
@@ -172,6 +178,45 @@ void DefaultPieceStorageTest::testGetMissingPiece_manyWithExcludedIndexes()
   CPPUNIT_ASSERT(pieces.empty());
 }
 
+void DefaultPieceStorageTest::testGetMissingPiece_endGame()
+{
+  DefaultPieceStorage pss(dctx_, option_.get());
+  pss.setPieceSelector(std::move(pieceSelector_));
+  peer->setAllBitfield();
+  std::vector<std::shared_ptr<Piece>> pieces;
+  pss.getMissingPiece(pieces, 1, peer, 1);
+  CPPUNIT_ASSERT_EQUAL((size_t)1, pieces.size());
+  pss.completePiece(pieces[0]);
+  pieces.clear();
+  pss.enterEndGame();
+
+  // In end game, pieces are shared by peers.
+  pss.getMissingPiece(pieces, 10, peer, 1);
+  CPPUNIT_ASSERT_EQUAL((size_t)2, pieces.size());
+  std::sort(std::begin(pieces), std::end(pieces),
+            DerefLess<std::shared_ptr<Piece>>());
+  CPPUNIT_ASSERT_EQUAL((size_t)1, pieces[0]->getIndex());
+  CPPUNIT_ASSERT_EQUAL((size_t)2, pieces[1]->getIndex());
+
+  std::vector<std::shared_ptr<Piece>> pieces2;
+  std::vector<size_t> excludedIndexes{1};
+  pss.getMissingPiece(pieces2, 10, peer, excludedIndexes, 2);
+  CPPUNIT_ASSERT_EQUAL((size_t)1, pieces2.size());
+  CPPUNIT_ASSERT(pieces[1] == pieces2[0]);
+
+  pss.completePiece(pieces[1]);
+  pieces2.clear();
+  pss.getMissingPiece(pieces2, 10, peer, 2);
+  CPPUNIT_ASSERT_EQUAL((size_t)1, pieces2.size());
+  CPPUNIT_ASSERT(pieces[0] == pieces2[0]);
+
+  // Pieces which become missing again are found.
+  pss.markPieceMissing(2);
+  pieces2.clear();
+  pss.getMissingPiece(pieces2, 10, peer, 3);
+  CPPUNIT_ASSERT_EQUAL((size_t)2, pieces2.size());
+}
+
 void DefaultPieceStorageTest::testGetMissingFastPiece()
 {
   DefaultPieceStorage pss(dctx_, option_.get());
@@ -266,6 +311,33 @@ void DefaultPieceStorageTest::testGetPieceInUsedPieces()
   CPPUNIT_ASSERT_EQUAL((size_t)1, pieceGot->countCompleteBlock());
 }
 
+void DefaultPieceStorageTest::testGetInFlightPieces()
+{
+  DefaultPieceStorage pss(dctx_, option_.get());
+  auto piece2 = std::make_shared<Piece>(2, 128);
+  pss.addUsedPiece(piece2);
+  pss.addUsedPiece(std::make_shared<Piece>(0, 128));
+  pss.addInFlightPiece({std::make_shared<Piece>(1, 128),
+                        std::make_shared<Piece>(2, 128)});
+  CPPUNIT_ASSERT_EQUAL((size_t)3, pss.countInFlightPiece());
+  // Existing piece is not replaced.
+  CPPUNIT_ASSERT(piece2 == pss.getPiece(2));
+
+  std::vector<std::shared_ptr<Piece>> pieces;
+  pss.getInFlightPieces(pieces);
+  CPPUNIT_ASSERT_EQUAL((size_t)3, pieces.size());
+  for (size_t i = 0; i < pieces.size(); ++i) {
+    CPPUNIT_ASSERT_EQUAL(i, pieces[i]->getIndex());
+  }
+
+  pss.cancelPiece(pieces[1], 1);
+  pieces.clear();
+  pss.getInFlightPieces(pieces);
+  CPPUNIT_ASSERT_EQUAL((size_t)2, pieces.size());
+  CPPUNIT_ASSERT_EQUAL((size_t)0, pieces[0]->getIndex());
+  CPPUNIT_ASSERT_EQUAL((size_t)2, pieces[1]->getIndex());
+}
+
 void DefaultPieceStorageTest::testGetPieceCompletedPiece()
 {
   DefaultPieceStorage pss(dctx_, option_.get());
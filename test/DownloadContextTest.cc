@@ -44,6 +44,9 @@ void DownloadContextTest::testFindFileEntryByOffset()
 
   CPPUNIT_ASSERT_EQUAL(std::string("file1"),
                        ctx.findFileEntryByOffset(0)->getPath());
+  // Zero length files file2 and file3 share the offset with file4.
+  CPPUNIT_ASSERT_EQUAL(std::string("file4"),
+                       ctx.findFileEntryByOffset(1000)->getPath());
   CPPUNIT_ASSERT_EQUAL(std::string("file4"),
                        ctx.findFileEntryByOffset(1500)->getPath());
   CPPUNIT_ASSERT_EQUAL(std::string("file5"),
@@ -54,10 +57,22 @@ void DownloadContextTest::testFindFileEntryByOffset()
 void DownloadContextTest::testGetPieceHash()
 {
   DownloadContext ctx;
-  const std::string pieceHashes[] = {"hash1", "hash2", "shash3"};
+  const std::string pieceHashes[] = {"hash1", "hash2", "hash3"};
   ctx.setPieceHashes("sha-1", &pieceHashes[0], &pieceHashes[3]);
+  CPPUNIT_ASSERT_EQUAL((size_t)3, ctx.countPieceHash());
   CPPUNIT_ASSERT_EQUAL(std::string("hash1"), ctx.getPieceHash(0));
+  CPPUNIT_ASSERT_EQUAL(std::string("hash3"), ctx.getPieceHash(2));
   CPPUNIT_ASSERT_EQUAL(std::string(""), ctx.getPieceHash(3));
+  CPPUNIT_ASSERT(ctx.pieceHashEquals(1, "hash2"));
+  CPPUNIT_ASSERT(!ctx.pieceHashEquals(1, "hash3"));
+  CPPUNIT_ASSERT(!ctx.pieceHashEquals(1, "hash"));
+  CPPUNIT_ASSERT(!ctx.pieceHashEquals(3, "hash3"));
+
+  // Hashes of different lengths are not accepted.
+  const std::string badHashes[] = {"hash1", "shash2"};
+  ctx.setPieceHashes("sha-1", &badHashes[0], &badHashes[2]);
+  CPPUNIT_ASSERT_EQUAL((size_t)0, ctx.countPieceHash());
+  CPPUNIT_ASSERT_EQUAL(std::string(""), ctx.getPieceHash(0));
 }
 
 void DownloadContextTest::testGetNumPieces()
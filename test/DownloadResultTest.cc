@@ -0,0 +1,125 @@
+#include "DownloadResult.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "FileEntry.h"
+#include "a2functional.h"
+
+namespace aria2 {
+
+class DownloadResultTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(DownloadResultTest);
+  CPPUNIT_TEST(testFileEntries);
+  CPPUNIT_TEST(testFileEntries_empty);
+  CPPUNIT_TEST(testFileEntries_withoutUris);
+  CPPUNIT_TEST(testGetFileEntry);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void testFileEntries();
+  void testFileEntries_empty();
+  void testFileEntries_withoutUris();
+  void testGetFileEntry();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DownloadResultTest);
+
+void DownloadResultTest::testFileEntries()
+{
+  std::vector<std::shared_ptr<FileEntry>> fileEntries{
+      std::make_shared<FileEntry>("/tmp/dir/file1", 1000, 0),
+      std::make_shared<FileEntry>("/tmp/dir/file2", 0, 1000),
+      std::make_shared<FileEntry>("/tmp/dir/file3", 3000, 1000),
+      // Not adjacent to the previous file
+      std::make_shared<FileEntry>("", 1_g, 5000)};
+  fileEntries[0]->getSpentUris().push_back("http://example.org/dir/file1");
+  fileEntries[0]->getRemainingUris().push_back("http://example.net/dir/file1");
+  fileEntries[0]->getRemainingUris().push_back("http://example.org/dir/file1");
+  fileEntries[1]->setRequested(false);
+  fileEntries[2]->getSpentUris().push_back("http://example.org/dir/file3");
+  DownloadResult dr;
+  dr.setFileEntries(fileEntries);
+  CPPUNIT_ASSERT_EQUAL((size_t)4, dr.countFileEntry());
+  CPPUNIT_ASSERT(dr.getFileEntryMemoryUsage() > 0);
+
+  auto res = dr.getFileEntries();
+  CPPUNIT_ASSERT_EQUAL((size_t)4, res.size());
+  for (size_t i = 0; i < res.size(); ++i) {
+    CPPUNIT_ASSERT_EQUAL(fileEntries[i]->getPath(), res[i]->getPath());
+    CPPUNIT_ASSERT_EQUAL(fileEntries[i]->getLength(), res[i]->getLength());
+    CPPUNIT_ASSERT_EQUAL(fileEntries[i]->getOffset(), res[i]->getOffset());
+    CPPUNIT_ASSERT_EQUAL(fileEntries[i]->isRequested(),
+                         res[i]->isRequested());
+    CPPUNIT_ASSERT(fileEntries[i]->getSpentUris() == res[i]->getSpentUris());
+    CPPUNIT_ASSERT(fileEntries[i]->getRemainingUris() ==
+                   res[i]->getRemainingUris());
+  }
+  CPPUNIT_ASSERT(!res[1]->isRequested());
+  CPPUNIT_ASSERT_EQUAL((size_t)2, res[0]->getRemainingUris().size());
+  CPPUNIT_ASSERT_EQUAL((int64_t)5000, res[3]->getOffset());
+}
+
+void DownloadResultTest::testFileEntries_empty()
+{
+  DownloadResult dr;
+  CPPUNIT_ASSERT_EQUAL((size_t)0, dr.countFileEntry());
+  CPPUNIT_ASSERT(dr.getFileEntries().empty());
+  dr.setFileEntries({});
+  CPPUNIT_ASSERT_EQUAL((size_t)0, dr.countFileEntry());
+  CPPUNIT_ASSERT_EQUAL((size_t)0, dr.getFileEntryMemoryUsage());
+  CPPUNIT_ASSERT(!dr.getFileEntry(0));
+}
+
+void DownloadResultTest::testFileEntries_withoutUris()
+{
+  std::vector<std::shared_ptr<FileEntry>> fileEntries{
+      std::make_shared<FileEntry>("/tmp/dir/file1", 1000, 0),
+      std::make_shared<FileEntry>("/tmp/dir/file2", 2000, 1000)};
+  std::vector<size_t> usage;
+  for (auto& fe : fileEntries) {
+    usage.push_back(fe->estimateMemoryUsage());
+  }
+  DownloadResult dr;
+  dr.setFileEntries(fileEntries);
+  // Encoding does not allocate URI state of the files.
+  for (size_t i = 0; i < fileEntries.size(); ++i) {
+    CPPUNIT_ASSERT_EQUAL(usage[i], fileEntries[i]->estimateMemoryUsage());
+  }
+  // Neither does decoding.
+  auto res = dr.getFileEntries();
+  CPPUNIT_ASSERT_EQUAL((size_t)2, res.size());
+  for (size_t i = 0; i < res.size(); ++i) {
+    CPPUNIT_ASSERT_EQUAL(usage[i], res[i]->estimateMemoryUsage());
+  }
+  CPPUNIT_ASSERT_EQUAL(usage[1], dr.getFileEntry(1)->estimateMemoryUsage());
+}
+
+void DownloadResultTest::testGetFileEntry()
+{
+  std::vector<std::shared_ptr<FileEntry>> fileEntries{
+      std::make_shared<FileEntry>("/tmp/dir/file1", 1000, 0),
+      std::make_shared<FileEntry>("/tmp/dir/file2", 2000, 1000),
+      std::make_shared<FileEntry>("/tmp/dir/file3", 3000, 5000)};
+  fileEntries[0]->getSpentUris().push_back("http://example.org/dir/file1");
+  fileEntries[1]->setRequested(false);
+  fileEntries[2]->getSpentUris().push_back("http://example.org/dir/file3");
+  fileEntries[2]->getRemainingUris().push_back("http://example.org/dir/file1");
+  fileEntries[2]->getRemainingUris().push_back("http://example.net/dir/file3");
+  DownloadResult dr;
+  dr.setFileEntries(fileEntries);
+  for (size_t i = 0; i < fileEntries.size(); ++i) {
+    auto fe = dr.getFileEntry(i);
+    CPPUNIT_ASSERT(fe);
+    CPPUNIT_ASSERT_EQUAL(fileEntries[i]->getPath(), fe->getPath());
+    CPPUNIT_ASSERT_EQUAL(fileEntries[i]->getLength(), fe->getLength());
+    CPPUNIT_ASSERT_EQUAL(fileEntries[i]->getOffset(), fe->getOffset());
+    CPPUNIT_ASSERT_EQUAL(fileEntries[i]->isRequested(), fe->isRequested());
+    CPPUNIT_ASSERT(fileEntries[i]->getSpentUris() == fe->getSpentUris());
+    CPPUNIT_ASSERT(fileEntries[i]->getRemainingUris() ==
+                   fe->getRemainingUris());
+  }
+  CPPUNIT_ASSERT(!dr.getFileEntry(3));
+}
+
+} // namespace aria2
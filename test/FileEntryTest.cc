@@ -22,6 +22,8 @@ class FileEntryTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testInsertUri);
   CPPUNIT_TEST(testRemoveUri);
   CPPUNIT_TEST(testPutBackRequest);
+  CPPUNIT_TEST(testWithoutUris);
+  CPPUNIT_TEST(testSuffixPath);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -39,6 +41,8 @@ public:
   void testInsertUri();
   void testRemoveUri();
   void testPutBackRequest();
+  void testWithoutUris();
+  void testSuffixPath();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(FileEntryTest);
@@ -311,4 +315,67 @@ void FileEntryTest::testPutBackRequest()
   CPPUNIT_ASSERT_EQUAL(std::string("ftp://localhost/aria2.zip"), uris[2]);
 }
 
+void FileEntryTest::testWithoutUris()
+{
+  FileEntry file("/tmp/aria2/file", 1024, 0);
+  auto bare = file.estimateMemoryUsage();
+  const FileEntry& cfile = file;
+  CPPUNIT_ASSERT(cfile.getRemainingUris().empty());
+  CPPUNIT_ASSERT(cfile.getSpentUris().empty());
+  CPPUNIT_ASSERT(cfile.getURIResults().empty());
+  CPPUNIT_ASSERT(cfile.getInFlightRequests().empty());
+  CPPUNIT_ASSERT_EQUAL(std::string(), cfile.getContentType());
+  CPPUNIT_ASSERT(file.emptyRequestUri());
+  CPPUNIT_ASSERT(!file.removeUri("http://example.org/"));
+  file.removeIdenticalURI("http://example.org/");
+  file.reuseUri(std::vector<std::string>());
+  file.putBackRequest();
+  file.releaseRuntimeResource();
+  CPPUNIT_ASSERT_EQUAL((size_t)0, file.countInFlightRequest());
+  CPPUNIT_ASSERT_EQUAL((size_t)0, file.countPooledRequest());
+  CPPUNIT_ASSERT(file.getUris().empty());
+  auto sfile = std::make_shared<FileEntry>("/tmp/aria2/file", 1024, 0);
+  std::vector<std::shared_ptr<FileEntry>> files{sfile};
+  CPPUNIT_ASSERT(
+      !isUriSuppliedForRequsetFileEntry(std::begin(files), std::end(files)));
+  // None of the above allocates URI state.
+  CPPUNIT_ASSERT_EQUAL(bare, file.estimateMemoryUsage());
+  CPPUNIT_ASSERT_EQUAL(bare, sfile->estimateMemoryUsage());
+
+  CPPUNIT_ASSERT(file.addUri("http://example.org/"));
+  CPPUNIT_ASSERT(!file.emptyRequestUri());
+  CPPUNIT_ASSERT(bare < file.estimateMemoryUsage());
+}
+
+void FileEntryTest::testSuffixPath()
+{
+  FileEntry file("/tmp/aria2/dir/file", 1024, 0);
+  file.setSuffixPath("dir/file");
+  file.setOriginalName("dir/file");
+  CPPUNIT_ASSERT_EQUAL(std::string("dir/file"), file.getSuffixPath());
+  CPPUNIT_ASSERT_EQUAL(std::string("dir/file"), file.getOriginalName());
+
+  // Changing path keeps the names.
+  file.setPath("/var/dir/file2");
+  CPPUNIT_ASSERT_EQUAL(std::string("dir/file"), file.getSuffixPath());
+  CPPUNIT_ASSERT_EQUAL(std::string("dir/file"), file.getOriginalName());
+
+  file.setSuffixPath("dir/file2");
+  CPPUNIT_ASSERT_EQUAL(std::string("dir/file2"), file.getSuffixPath());
+  CPPUNIT_ASSERT_EQUAL(std::string("dir/file"), file.getOriginalName());
+
+  // Original name differs from suffix path, for example, after
+  // escaping.
+  FileEntry file2("/tmp/aria2/dir/%1B", 1024, 0);
+  file2.setSuffixPath("dir/%1B");
+  file2.setOriginalName("dir/\x1b");
+  CPPUNIT_ASSERT_EQUAL(std::string("dir/%1B"), file2.getSuffixPath());
+  CPPUNIT_ASSERT_EQUAL(std::string("dir/\x1b"), file2.getOriginalName());
+
+  // Suffix path is not always the tail of path.
+  FileEntry file3("/tmp/aria2/file", 1024, 0);
+  file3.setSuffixPath("other");
+  CPPUNIT_ASSERT_EQUAL(std::string("other"), file3.getSuffixPath());
+}
+
 } // namespace aria2
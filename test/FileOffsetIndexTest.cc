@@ -0,0 +1,69 @@
+#include "FileOffsetIndex.h"
+
+#include <memory>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "FileEntry.h"
+
+namespace aria2 {
+
+class FileOffsetIndexTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(FileOffsetIndexTest);
+  CPPUNIT_TEST(testFind);
+  CPPUNIT_TEST(testFind_empty);
+  CPPUNIT_TEST(testFind_many);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void testFind();
+  void testFind_empty();
+  void testFind_many();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FileOffsetIndexTest);
+
+void FileOffsetIndexTest::testFind()
+{
+  const std::shared_ptr<FileEntry> fileEntries[] = {
+      std::make_shared<FileEntry>("file1", 1000, 0),
+      std::make_shared<FileEntry>("file2", 0, 1000),
+      std::make_shared<FileEntry>("file3", 0, 1000),
+      std::make_shared<FileEntry>("file4", 2000, 1000),
+      std::make_shared<FileEntry>("file5", 3000, 3000)};
+  FileOffsetIndex index;
+  index.reset(std::begin(fileEntries), std::end(fileEntries));
+  CPPUNIT_ASSERT_EQUAL((size_t)5, index.size());
+  CPPUNIT_ASSERT_EQUAL(FileOffsetIndex::npos, index.find(-1));
+  CPPUNIT_ASSERT_EQUAL((size_t)0, index.find(0));
+  CPPUNIT_ASSERT_EQUAL((size_t)0, index.find(999));
+  CPPUNIT_ASSERT_EQUAL((size_t)3, index.find(1000));
+  CPPUNIT_ASSERT_EQUAL((size_t)3, index.find(2999));
+  CPPUNIT_ASSERT_EQUAL((size_t)4, index.find(3000));
+  // The index does not know the length of the last file.
+  CPPUNIT_ASSERT_EQUAL((size_t)4, index.find(6000));
+}
+
+void FileOffsetIndexTest::testFind_empty()
+{
+  FileOffsetIndex index;
+  CPPUNIT_ASSERT(index.empty());
+  CPPUNIT_ASSERT_EQUAL(FileOffsetIndex::npos, index.find(0));
+}
+
+void FileOffsetIndexTest::testFind_many()
+{
+  std::vector<std::shared_ptr<FileEntry>> fileEntries;
+  for (int i = 0; i < 1000; ++i) {
+    fileEntries.push_back(
+        std::make_shared<FileEntry>("file", 10, static_cast<int64_t>(i) * 10));
+  }
+  FileOffsetIndex index;
+  index.reset(std::begin(fileEntries), std::end(fileEntries));
+  for (int64_t offset = 0; offset < 10000; ++offset) {
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(offset / 10), index.find(offset));
+  }
+}
+
+} // namespace aria2
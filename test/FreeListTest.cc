@@ -0,0 +1,83 @@
+#include "FreeList.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace aria2 {
+
+class FreeListTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(FreeListTest);
+  CPPUNIT_TEST(testAllocate);
+  CPPUNIT_TEST(testAllocate_otherSize);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void testAllocate();
+  void testAllocate_otherSize();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FreeListTest);
+
+namespace {
+struct Block {
+  char data[24];
+};
+
+struct Counted {
+  static void* operator new(size_t size)
+  {
+    return FreeList<Counted, 2>::allocate(size);
+  }
+
+  static void operator delete(void* p, size_t size)
+  {
+    FreeList<Counted, 2>::deallocate(p, size);
+  }
+
+  virtual ~Counted() = default;
+
+  int value;
+};
+
+struct Derived : Counted {
+  char extra[64];
+};
+} // namespace
+
+void FreeListTest::testAllocate()
+{
+  typedef FreeList<Block, 2> List;
+  CPPUNIT_ASSERT_EQUAL((size_t)0, List::size());
+  auto p1 = List::allocate(sizeof(Block));
+  auto p2 = List::allocate(sizeof(Block));
+  auto p3 = List::allocate(sizeof(Block));
+  List::deallocate(p1, sizeof(Block));
+  List::deallocate(p2, sizeof(Block));
+  // The list is full.
+  List::deallocate(p3, sizeof(Block));
+  CPPUNIT_ASSERT_EQUAL((size_t)2, List::size());
+  CPPUNIT_ASSERT(p2 == List::allocate(sizeof(Block)));
+  CPPUNIT_ASSERT(p1 == List::allocate(sizeof(Block)));
+  CPPUNIT_ASSERT_EQUAL((size_t)0, List::size());
+  List::deallocate(p1, sizeof(Block));
+  List::deallocate(p2, sizeof(Block));
+}
+
+void FreeListTest::testAllocate_otherSize()
+{
+  typedef FreeList<Counted, 2> List;
+  auto base = new Counted();
+  delete base;
+  CPPUNIT_ASSERT_EQUAL((size_t)1, List::size());
+  // Derived class has different size, and goes to the global
+  // allocator.
+  Counted* derived = new Derived();
+  CPPUNIT_ASSERT_EQUAL((size_t)1, List::size());
+  delete derived;
+  CPPUNIT_ASSERT_EQUAL((size_t)1, List::size());
+  auto reused = new Counted();
+  CPPUNIT_ASSERT(base == reused);
+  delete reused;
+}
+
+} // namespace aria2
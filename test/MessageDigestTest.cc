@@ -10,6 +10,7 @@ class MessageDigestTest : public CppUnit::TestFixture {
 
   CPPUNIT_TEST_SUITE(MessageDigestTest);
   CPPUNIT_TEST(testDigest);
+  CPPUNIT_TEST(testDigest_multiBlock);
   CPPUNIT_TEST(testSupports);
   CPPUNIT_TEST(testGetDigestLength);
   CPPUNIT_TEST(testIsStronger);
@@ -32,6 +33,7 @@ public:
   }
 
   void testDigest();
+  void testDigest_multiBlock();
   void testSupports();
   void testGetDigestLength();
   void testIsStronger();
@@ -72,6 +74,24 @@ void MessageDigestTest::testDigest()
 #endif // HAVE_ZLIB
 }
 
+void MessageDigestTest::testDigest_multiBlock()
+{
+  // One million repetitions of "a", fed in pieces which are not
+  // aligned to the block size.
+  std::string data(1000000, 'a');
+  auto sha256 = MessageDigest::create("sha-256");
+  for (size_t i = 0, n = 1; i < data.size(); i += n, n = n * 3 % 1021) {
+    n = std::min(n, data.size() - i);
+    sha1_->update(data.data() + i, n);
+    sha256->update(data.data() + i, n);
+  }
+  CPPUNIT_ASSERT_EQUAL(std::string("34aa973cd4c4daa4f61eeb2bdbad27316534016f"),
+                       util::toHex(sha1_->digest()));
+  CPPUNIT_ASSERT_EQUAL(std::string("cdc76e5c9914fb9281a1c7e284d73e67"
+                                   "f1809a48a497200e046d39ccc7112cd0"),
+                       util::toHex(sha256->digest()));
+}
+
 void MessageDigestTest::testSupports()
 {
   CPPUNIT_ASSERT(MessageDigest::supports("md5"));
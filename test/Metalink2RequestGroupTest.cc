@@ -77,7 +77,7 @@ void Metalink2RequestGroupTest::testGenerate()
 
     CPPUNIT_ASSERT(dctx);
     CPPUNIT_ASSERT_EQUAL(std::string("sha-1"), dctx->getPieceHashType());
-    CPPUNIT_ASSERT_EQUAL((size_t)2, dctx->getPieceHashes().size());
+    CPPUNIT_ASSERT_EQUAL((size_t)2, dctx->countPieceHash());
     CPPUNIT_ASSERT_EQUAL(262144, dctx->getPieceLength());
     CPPUNIT_ASSERT_EQUAL(std::string("sha-1"), dctx->getHashType());
     CPPUNIT_ASSERT_EQUAL(
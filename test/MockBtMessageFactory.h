@@ -8,6 +8,7 @@
 #include "BtCancelMessage.h"
 #include "BtPieceMessage.h"
 #include "BtHaveMessage.h"
+#include "BtHaveBatchMessage.h"
 #include "BtChokeMessage.h"
 #include "BtUnchokeMessage.h"
 #include "BtInterestedMessage.h"
@@ -78,6 +79,12 @@ public:
     return nullptr;
   }
 
+  virtual std::unique_ptr<BtHaveBatchMessage>
+  createHaveBatchMessage(std::vector<size_t> indexes) CXX11_OVERRIDE
+  {
+    return nullptr;
+  }
+
   virtual std::unique_ptr<BtChokeMessage> createChokeMessage() CXX11_OVERRIDE
   {
     return nullptr;
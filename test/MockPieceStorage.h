@@ -287,6 +287,12 @@ public:
   {
   }
 
+  virtual void addPieceStats(const PeerBitfield& bitfield) CXX11_OVERRIDE {}
+
+  virtual void subtractPieceStats(const PeerBitfield& bitfield) CXX11_OVERRIDE
+  {
+  }
+
   virtual void updatePieceStats(const unsigned char* newBitfield,
                                 size_t newBitfieldLength,
                                 const unsigned char* oldBitfield) CXX11_OVERRIDE
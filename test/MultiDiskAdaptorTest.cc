@@ -13,6 +13,10 @@
 #include "TestUtil.h"
 #include "DiskWriter.h"
 #include "WrDiskCacheEntry.h"
+#include "OpenedFileCounter.h"
+#include "RequestGroupMan.h"
+#include "RequestGroup.h"
+#include "Option.h"
 
 namespace aria2 {
 
@@ -26,6 +30,7 @@ class MultiDiskAdaptorTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testUtime);
   CPPUNIT_TEST(testResetDiskWriterEntries);
   CPPUNIT_TEST(testWriteCache);
+  CPPUNIT_TEST(testOpenedFileCounter);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -45,6 +50,7 @@ public:
   void testUtime();
   void testResetDiskWriterEntries();
   void testWriteCache();
+  void testOpenedFileCounter();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(MultiDiskAdaptorTest);
@@ -483,4 +489,60 @@ void MultiDiskAdaptorTest::testWriteCache()
   CPPUNIT_ASSERT_EQUAL(data2, readFile(entries[0]->getPath()).substr(123));
 }
 
+void MultiDiskAdaptorTest::testOpenedFileCounter()
+{
+  std::string storeDir =
+      A2_TEST_OUT_DIR "/aria2_MultiDiskAdaptorTest_testOpenedFileCounter";
+  auto entries = std::vector<std::shared_ptr<FileEntry>>{
+      std::make_shared<FileEntry>(storeDir + "/file1", 10, 0),
+      std::make_shared<FileEntry>(storeDir + "/file2", 10, 10),
+      std::make_shared<FileEntry>(storeDir + "/file3", 10, 20)};
+  for (const auto& i : entries) {
+    File(i->getPath()).remove();
+  }
+  auto option = std::make_shared<Option>();
+  RequestGroupMan rgman{std::vector<std::shared_ptr<RequestGroup>>{}, 1,
+                        option.get()};
+  auto counter = std::make_shared<OpenedFileCounter>(&rgman, 2);
+  auto adaptor = std::make_shared<MultiDiskAdaptor>();
+  adaptor->setFileEntries(std::begin(entries), std::end(entries));
+  adaptor->setOpenedFileCounter(counter);
+  adaptor->openFile();
+
+  auto& dwents = adaptor->getDiskWriterEntries();
+  // file1 is the least recently used one.
+  CPPUNIT_ASSERT(!dwents[0]->isOpen());
+  CPPUNIT_ASSERT(dwents[1]->isOpen());
+  CPPUNIT_ASSERT(dwents[2]->isOpen());
+  CPPUNIT_ASSERT_EQUAL((size_t)2, counter->getNumOpenFiles());
+  CPPUNIT_ASSERT_EQUAL((uint64_t)3, counter->getNumMisses());
+  CPPUNIT_ASSERT_EQUAL((uint64_t)1, counter->getNumEvictions());
+
+  // file2 becomes the most recently used one, so file3 is evicted.
+  adaptor->writeData(reinterpret_cast<const unsigned char*>("a"), 1, 10);
+  CPPUNIT_ASSERT_EQUAL((uint64_t)1, counter->getNumHits());
+  adaptor->writeData(reinterpret_cast<const unsigned char*>("a"), 1, 0);
+  CPPUNIT_ASSERT(dwents[0]->isOpen());
+  CPPUNIT_ASSERT(dwents[1]->isOpen());
+  CPPUNIT_ASSERT(!dwents[2]->isOpen());
+  CPPUNIT_ASSERT_EQUAL((uint64_t)2, counter->getNumEvictions());
+
+  // file2 is the least recently used one, but it has data in the
+  // write cache.  file1 is evicted instead.
+  WrDiskCacheEntry cache{adaptor};
+  cache.cacheData(createDataCell(12, "bb"));
+  CPPUNIT_ASSERT(dwents[1]->hasPendingCacheData());
+  adaptor->writeData(reinterpret_cast<const unsigned char*>("a"), 1, 20);
+  CPPUNIT_ASSERT(!dwents[0]->isOpen());
+  CPPUNIT_ASSERT(dwents[1]->isOpen());
+  CPPUNIT_ASSERT(dwents[2]->isOpen());
+  CPPUNIT_ASSERT_EQUAL((uint64_t)3, counter->getNumEvictions());
+
+  cache.writeToDisk();
+  CPPUNIT_ASSERT(!dwents[1]->hasPendingCacheData());
+
+  adaptor->closeFile();
+  CPPUNIT_ASSERT_EQUAL((size_t)0, counter->getNumOpenFiles());
+}
+
 } // namespace aria2
@@ -19,6 +19,7 @@ class OptionTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testMerge);
   CPPUNIT_TEST(testParent);
   CPPUNIT_TEST(testRemove);
+  CPPUNIT_TEST(testCopy);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -33,6 +34,7 @@ public:
   void testMerge();
   void testParent();
   void testRemove();
+  void testCopy();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(OptionTest);
@@ -148,4 +150,32 @@ void OptionTest::testRemove()
   CPPUNIT_ASSERT(parent->defined(PREF_TIMEOUT));
 }
 
+void OptionTest::testCopy()
+{
+  Option op;
+  op.put(PREF_DIR, "foo");
+  op.put(PREF_TIMEOUT, "100");
+  const auto& dir = op.get(PREF_DIR);
+
+  Option copy(op);
+  CPPUNIT_ASSERT_EQUAL(std::string("foo"), copy.get(PREF_DIR));
+  copy.put(PREF_DIR, "bar");
+  copy.put(PREF_DAEMON, "true");
+  copy.removeLocal(PREF_TIMEOUT);
+  CPPUNIT_ASSERT_EQUAL(std::string("bar"), copy.get(PREF_DIR));
+  CPPUNIT_ASSERT(!copy.defined(PREF_TIMEOUT));
+  // Modifying copy does not affect the original.
+  CPPUNIT_ASSERT_EQUAL(std::string("foo"), op.get(PREF_DIR));
+  CPPUNIT_ASSERT_EQUAL(100, op.getAsInt(PREF_TIMEOUT));
+  CPPUNIT_ASSERT(!op.defined(PREF_DAEMON));
+  // Putting other values does not invalidate the reference.
+  op.put(PREF_OUT, "out");
+  op.put(PREF_ALL_PROXY, "proxy");
+  CPPUNIT_ASSERT_EQUAL(std::string("foo"), dir);
+
+  op.clear();
+  CPPUNIT_ASSERT(op.emptyLocal());
+  CPPUNIT_ASSERT(!copy.emptyLocal());
+}
+
 } // namespace aria2
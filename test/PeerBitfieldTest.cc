@@ -0,0 +1,133 @@
+#include "PeerBitfield.h"
+
+#include <cstring>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "util.h"
+
+namespace aria2 {
+
+class PeerBitfieldTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(PeerBitfieldTest);
+  CPPUNIT_TEST(testSetBit);
+  CPPUNIT_TEST(testSetBit_allSet);
+  CPPUNIT_TEST(testUnsetBit);
+  CPPUNIT_TEST(testSetBitfield);
+  CPPUNIT_TEST(testGetBitfield);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void testSetBit();
+  void testSetBit_allSet();
+  void testUnsetBit();
+  void testSetBitfield();
+  void testGetBitfield();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(PeerBitfieldTest);
+
+void PeerBitfieldTest::testSetBit()
+{
+  // 128 bits, 16 bytes.  Up to 2 indexes are held in the sparse form.
+  PeerBitfield bf(128);
+  CPPUNIT_ASSERT(bf.isSparse());
+  CPPUNIT_ASSERT(!bf.isAllBitSet());
+  CPPUNIT_ASSERT(bf.setBit(100));
+  CPPUNIT_ASSERT(bf.setBit(3));
+  CPPUNIT_ASSERT(bf.setBit(3));
+  CPPUNIT_ASSERT(!bf.setBit(128));
+  CPPUNIT_ASSERT(bf.isSparse());
+  CPPUNIT_ASSERT_EQUAL((size_t)2, bf.getSparseIndexes().size());
+  CPPUNIT_ASSERT_EQUAL((uint32_t)3, bf.getSparseIndexes()[0]);
+  CPPUNIT_ASSERT_EQUAL((uint32_t)100, bf.getSparseIndexes()[1]);
+
+  CPPUNIT_ASSERT(bf.setBit(64));
+  CPPUNIT_ASSERT(!bf.isSparse());
+  CPPUNIT_ASSERT_EQUAL((size_t)3, bf.countSetBit());
+  CPPUNIT_ASSERT(bf.isBitSet(3));
+  CPPUNIT_ASSERT(bf.isBitSet(64));
+  CPPUNIT_ASSERT(bf.isBitSet(100));
+  CPPUNIT_ASSERT(!bf.isBitSet(4));
+}
+
+void PeerBitfieldTest::testSetBit_allSet()
+{
+  PeerBitfield bf1(10);
+  PeerBitfield bf2(10);
+  for (size_t i = 0; i < 10; ++i) {
+    bf1.setBit(i);
+  }
+  bf2.setAllBit();
+  CPPUNIT_ASSERT(bf1.isAllBitSet());
+  CPPUNIT_ASSERT(bf2.isAllBitSet());
+  CPPUNIT_ASSERT(!bf1.isSparse());
+  // Seeders share the same bitfield.
+  CPPUNIT_ASSERT(bf1.getBitfield() == bf2.getBitfield());
+  CPPUNIT_ASSERT_EQUAL(std::string("ffc0"), util::toHex(bf1.getBitfield(), 2));
+}
+
+void PeerBitfieldTest::testUnsetBit()
+{
+  PeerBitfield bf(10);
+  bf.setAllBit();
+  CPPUNIT_ASSERT(bf.unsetBit(9));
+  CPPUNIT_ASSERT(!bf.isAllBitSet());
+  CPPUNIT_ASSERT_EQUAL((size_t)9, bf.countSetBit());
+  CPPUNIT_ASSERT_EQUAL(std::string("ff80"), util::toHex(bf.getBitfield(), 2));
+
+  PeerBitfield other(10);
+  other.setAllBit();
+  // Modifying bf must not affect the shared bitfield.
+  CPPUNIT_ASSERT_EQUAL(std::string("ffc0"),
+                       util::toHex(other.getBitfield(), 2));
+
+  PeerBitfield sparse(128);
+  sparse.setBit(7);
+  CPPUNIT_ASSERT(sparse.unsetBit(7));
+  CPPUNIT_ASSERT(sparse.unsetBit(7));
+  CPPUNIT_ASSERT_EQUAL((size_t)0, sparse.countSetBit());
+  CPPUNIT_ASSERT(!sparse.unsetBit(128));
+}
+
+void PeerBitfieldTest::testSetBitfield()
+{
+  PeerBitfield bf(128);
+  unsigned char data[16] = {0x80, 0, 0, 0, 0, 0, 0, 0,
+                            0,    0, 0, 0, 0, 0, 0, 0x01};
+  bf.setBitfield(data, sizeof(data));
+  CPPUNIT_ASSERT(bf.isSparse());
+  CPPUNIT_ASSERT_EQUAL((size_t)2, bf.countSetBit());
+  CPPUNIT_ASSERT(bf.isBitSet(0));
+  CPPUNIT_ASSERT(bf.isBitSet(127));
+
+  data[1] = 0xff;
+  bf.setBitfield(data, sizeof(data));
+  CPPUNIT_ASSERT(!bf.isSparse());
+  CPPUNIT_ASSERT_EQUAL((size_t)10, bf.countSetBit());
+
+  memset(data, 0xff, sizeof(data));
+  bf.setBitfield(data, sizeof(data));
+  CPPUNIT_ASSERT(bf.isAllBitSet());
+
+  // Length mismatch is ignored.
+  bf.setBitfield(data, 15);
+  CPPUNIT_ASSERT(bf.isAllBitSet());
+}
+
+void PeerBitfieldTest::testGetBitfield()
+{
+  PeerBitfield bf(128);
+  bf.setBit(8);
+  std::vector<unsigned char> buf;
+  CPPUNIT_ASSERT_EQUAL(std::string("00800000000000000000000000000000"),
+                       util::toHex(bf.getBitfield(buf), 16));
+  CPPUNIT_ASSERT(bf.isSparse());
+
+  CPPUNIT_ASSERT_EQUAL(std::string("00800000000000000000000000000000"),
+                       util::toHex(bf.getBitfield(), 16));
+  CPPUNIT_ASSERT(!bf.isSparse());
+}
+
+} // namespace aria2
@@ -0,0 +1,57 @@
+#include "PieceHashes.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace aria2 {
+
+class PieceHashesTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(PieceHashesTest);
+  CPPUNIT_TEST(testGet);
+  CPPUNIT_TEST(testEquals);
+  CPPUNIT_TEST(testConstruct_range);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void testGet();
+  void testEquals();
+  void testConstruct_range();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(PieceHashesTest);
+
+void PieceHashesTest::testGet()
+{
+  PieceHashes hashes("aaabbbccc", 3);
+  CPPUNIT_ASSERT_EQUAL((size_t)3, hashes.size());
+  CPPUNIT_ASSERT_EQUAL(std::string("aaa"), hashes.get(0));
+  CPPUNIT_ASSERT_EQUAL(std::string("ccc"), hashes.get(2));
+  CPPUNIT_ASSERT_EQUAL(std::string(), hashes.get(3));
+
+  PieceHashes empty;
+  CPPUNIT_ASSERT_EQUAL((size_t)0, empty.size());
+  CPPUNIT_ASSERT_EQUAL(std::string(), empty.get(0));
+}
+
+void PieceHashesTest::testEquals()
+{
+  PieceHashes hashes("aaabbbccc", 3);
+  CPPUNIT_ASSERT(hashes.equals(1, "bbb"));
+  CPPUNIT_ASSERT(!hashes.equals(1, "aaa"));
+  CPPUNIT_ASSERT(!hashes.equals(1, "bb"));
+  CPPUNIT_ASSERT(!hashes.equals(1, "bbbc"));
+  CPPUNIT_ASSERT(!hashes.equals(3, "aaa"));
+}
+
+void PieceHashesTest::testConstruct_range()
+{
+  std::string src[] = {"aa", "bb", "cc"};
+  PieceHashes hashes(&src[0], &src[3]);
+  CPPUNIT_ASSERT_EQUAL((size_t)3, hashes.size());
+  CPPUNIT_ASSERT_EQUAL(std::string("bb"), hashes.get(1));
+
+  std::string bad[] = {"aa", "b"};
+  CPPUNIT_ASSERT_EQUAL((size_t)0, PieceHashes(&bad[0], &bad[2]).size());
+}
+
+} // namespace aria2
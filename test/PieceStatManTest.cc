@@ -1,7 +1,11 @@
 #include "PieceStatMan.h"
 
+#include <algorithm>
+
 #include <cppunit/extensions/HelperMacros.h>
 
+#include "PeerBitfield.h"
+
 namespace aria2 {
 
 class PieceStatManTest : public CppUnit::TestFixture {
@@ -11,6 +15,9 @@ class PieceStatManTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testAddPieceStats_bitfield);
   CPPUNIT_TEST(testUpdatePieceStats);
   CPPUNIT_TEST(testSubtractPieceStats);
+  CPPUNIT_TEST(testGetSortedIndexes);
+  CPPUNIT_TEST(testAddPieceStats_seeder);
+  CPPUNIT_TEST(testAddPieceStats_peerBitfield);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -22,6 +29,9 @@ public:
   void testAddPieceStats_bitfield();
   void testUpdatePieceStats();
   void testSubtractPieceStats();
+  void testGetSortedIndexes();
+  void testAddPieceStats_seeder();
+  void testAddPieceStats_peerBitfield();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(PieceStatManTest);
@@ -126,4 +136,114 @@ void PieceStatManTest::testSubtractPieceStats()
   }
 }
 
+void PieceStatManTest::testGetSortedIndexes()
+{
+  PieceStatMan pieceStatMan(10, false);
+  const unsigned char bitfield[] = {0xf0, 0x00};
+  pieceStatMan.addPieceStats(bitfield, sizeof(bitfield));
+  pieceStatMan.addPieceStats(2);
+  pieceStatMan.addPieceStats(2);
+  pieceStatMan.addPieceStats(9);
+  const unsigned char subBitfield[] = {0x40, 0x00};
+  pieceStatMan.subtractPieceStats(subBitfield, sizeof(subBitfield));
+  // idx: 0, 1, 2, 3, 4, 5, 6, 7, 8, 9
+  // cnt: 1, 0, 3, 1, 0, 0, 0, 0, 0, 1
+  CPPUNIT_ASSERT_EQUAL((size_t)0, pieceStatMan.getBucketStart(0));
+  CPPUNIT_ASSERT_EQUAL((size_t)6, pieceStatMan.getBucketStart(1));
+  CPPUNIT_ASSERT_EQUAL((size_t)9, pieceStatMan.getBucketStart(2));
+  CPPUNIT_ASSERT_EQUAL((size_t)9, pieceStatMan.getBucketStart(3));
+  CPPUNIT_ASSERT_EQUAL((size_t)10, pieceStatMan.getBucketStart(4));
+  CPPUNIT_ASSERT_EQUAL((size_t)10, pieceStatMan.getBucketStart(100));
+
+  const auto& sorted = pieceStatMan.getSortedIndexes();
+  const auto& counts = pieceStatMan.getCounts();
+  CPPUNIT_ASSERT_EQUAL((size_t)10, sorted.size());
+  for (size_t i = 1; i < sorted.size(); ++i) {
+    CPPUNIT_ASSERT(counts[sorted[i - 1]] <= counts[sorted[i]]);
+  }
+  std::vector<size_t> indexes(std::begin(sorted), std::end(sorted));
+  std::sort(std::begin(indexes), std::end(indexes));
+  for (size_t i = 0; i < indexes.size(); ++i) {
+    CPPUNIT_ASSERT_EQUAL(i, indexes[i]);
+  }
+  CPPUNIT_ASSERT_EQUAL((size_t)2, sorted[9]);
+}
+
+void PieceStatManTest::testAddPieceStats_seeder()
+{
+  PieceStatMan pieceStatMan(10, false);
+  // Trailing garbage bits are ignored.
+  const unsigned char allBitfield[] = {0xff, 0xff};
+  pieceStatMan.addPieceStats(allBitfield, sizeof(allBitfield));
+  pieceStatMan.addPieceStats(allBitfield, sizeof(allBitfield));
+  CPPUNIT_ASSERT_EQUAL(2, pieceStatMan.getNumSeeders());
+  const unsigned char bitfield[] = {0x80, 0x00};
+  pieceStatMan.subtractPieceStats(bitfield, sizeof(bitfield));
+  {
+    int ans[] = {1, 2, 2, 2, 2, 2, 2, 2, 2, 2};
+    auto counts = pieceStatMan.getCounts();
+    for (size_t i = 0; i < 10; ++i) {
+      CPPUNIT_ASSERT_EQUAL(ans[i], counts[i]);
+    }
+  }
+  CPPUNIT_ASSERT_EQUAL((size_t)0, pieceStatMan.getBucketStart(1));
+  CPPUNIT_ASSERT_EQUAL((size_t)1, pieceStatMan.getBucketStart(2));
+
+  pieceStatMan.subtractPieceStats(allBitfield, sizeof(allBitfield));
+  CPPUNIT_ASSERT_EQUAL(1, pieceStatMan.getNumSeeders());
+  // Piece 0 has count 0, so that this is processed per piece.
+  pieceStatMan.subtractPieceStats(allBitfield, sizeof(allBitfield));
+  CPPUNIT_ASSERT_EQUAL(1, pieceStatMan.getNumSeeders());
+  {
+    auto counts = pieceStatMan.getCounts();
+    for (size_t i = 0; i < 10; ++i) {
+      CPPUNIT_ASSERT_EQUAL(0, counts[i]);
+    }
+  }
+  CPPUNIT_ASSERT_EQUAL((size_t)10, pieceStatMan.getBucketStart(1));
+
+  pieceStatMan.addPieceStats(3);
+  CPPUNIT_ASSERT_EQUAL(1, pieceStatMan.getCount(3));
+  CPPUNIT_ASSERT_EQUAL((size_t)3, pieceStatMan.getSortedIndexes()[9]);
+}
+
+void PieceStatManTest::testAddPieceStats_peerBitfield()
+{
+  PieceStatMan pieceStatMan(128, false);
+  PeerBitfield seeder(128);
+  seeder.setAllBit();
+  PeerBitfield sparse(128);
+  sparse.setBit(5);
+  sparse.setBit(120);
+  PeerBitfield dense(128);
+  for (size_t i = 0; i < 10; ++i) {
+    dense.setBit(i);
+  }
+  CPPUNIT_ASSERT(sparse.isSparse());
+  CPPUNIT_ASSERT(!dense.isSparse());
+
+  pieceStatMan.addPieceStats(seeder);
+  pieceStatMan.addPieceStats(sparse);
+  pieceStatMan.addPieceStats(dense);
+  CPPUNIT_ASSERT_EQUAL(1, pieceStatMan.getNumSeeders());
+  CPPUNIT_ASSERT_EQUAL(3, pieceStatMan.getCount(5));
+  CPPUNIT_ASSERT_EQUAL(2, pieceStatMan.getCount(0));
+  CPPUNIT_ASSERT_EQUAL(2, pieceStatMan.getCount(120));
+  CPPUNIT_ASSERT_EQUAL(1, pieceStatMan.getCount(127));
+  CPPUNIT_ASSERT_EQUAL((size_t)5, pieceStatMan.getSortedIndexes()[127]);
+
+  pieceStatMan.subtractPieceStats(sparse);
+  pieceStatMan.subtractPieceStats(seeder);
+  CPPUNIT_ASSERT_EQUAL(0, pieceStatMan.getNumSeeders());
+  CPPUNIT_ASSERT_EQUAL(1, pieceStatMan.getCount(5));
+  CPPUNIT_ASSERT_EQUAL(0, pieceStatMan.getCount(120));
+
+  // Bitfield of different size is ignored.
+  PeerBitfield other(64);
+  other.setAllBit();
+  pieceStatMan.addPieceStats(other);
+  CPPUNIT_ASSERT_EQUAL(0, pieceStatMan.getNumSeeders());
+  CPPUNIT_ASSERT_EQUAL(0, pieceStatMan.getCount(127));
+}
+
 } // namespace aria2
@@ -8,6 +8,7 @@
 #include "DirectDiskAdaptor.h"
 #include "ByteArrayDiskWriter.h"
 #include "WrDiskCache.h"
+#include "WrDiskCacheEntry.h"
 
 namespace aria2 {
 
@@ -18,6 +19,7 @@ class PieceTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testGetCompletedLength);
   CPPUNIT_TEST(testFlushWrCache);
   CPPUNIT_TEST(testAppendWrCache);
+  CPPUNIT_TEST(testUpdateWrCache_partlyFilled);
 
   CPPUNIT_TEST(testGetDigestWithWrCache);
   CPPUNIT_TEST(testUpdateHash);
@@ -41,6 +43,7 @@ public:
   void testGetCompletedLength();
   void testFlushWrCache();
   void testAppendWrCache();
+  void testUpdateWrCache_partlyFilled();
 
   void testGetDigestWithWrCache();
   void testUpdateHash();
@@ -115,6 +118,38 @@ void PieceTest::testAppendWrCache()
   CPPUNIT_ASSERT_EQUAL(std::string("foobar"), writer_->getString());
 }
 
+void PieceTest::testUpdateWrCache_partlyFilled()
+{
+  Piece p(0, 1_m);
+  WrDiskCache dc(64_k);
+  p.initWrCache(&dc, adaptor_);
+  // Cells which only have a few bytes read into them.
+  for (size_t i = 0; i < 32; ++i) {
+    auto data = new unsigned char[WrDiskCacheEntry::MAX_CELL_SLACK];
+    memset(data, 'a' + i % 26, 100);
+    p.updateWrCache(&dc, data, 0, 100, WrDiskCacheEntry::MAX_CELL_SLACK,
+                    i * 100);
+    CPPUNIT_ASSERT(dc.getSize() <= 64_k);
+    // The cell is taken as it is, without copying its data.
+    auto& cells = p.getWrDiskCacheEntry()->getDataSet();
+    CPPUNIT_ASSERT(data == (*cells.rbegin())->data);
+  }
+  CPPUNIT_ASSERT_EQUAL((size_t)3200, dc.getSize());
+  // The unused space is still available for appending.
+  size_t len;
+  auto buf = p.getWrCacheAppendBuffer(3200, len);
+  CPPUNIT_ASSERT(buf);
+  CPPUNIT_ASSERT_EQUAL(WrDiskCacheEntry::MAX_CELL_SLACK - 100, len);
+  memset(buf, 'z', 10);
+  p.commitWrCacheAppend(&dc, 10);
+  CPPUNIT_ASSERT_EQUAL((size_t)3210, dc.getSize());
+  p.flushWrCache(&dc);
+  CPPUNIT_ASSERT_EQUAL((size_t)0, dc.getSize());
+  CPPUNIT_ASSERT_EQUAL((size_t)3210, writer_->getString().size());
+  CPPUNIT_ASSERT_EQUAL('b', writer_->getString()[100]);
+  CPPUNIT_ASSERT_EQUAL('z', writer_->getString()[3200]);
+}
+
 void PieceTest::testGetDigestWithWrCache()
 {
   unsigned char* data;
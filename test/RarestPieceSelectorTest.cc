@@ -12,6 +12,7 @@ class RarestPieceSelectorTest : public CppUnit::TestFixture {
 
   CPPUNIT_TEST_SUITE(RarestPieceSelectorTest);
   CPPUNIT_TEST(testSelect);
+  CPPUNIT_TEST(testSelect_sparse);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -24,6 +25,7 @@ public:
   void testUpdatePieceStats();
   void testSubtractPieceStats();
   void testSelect();
+  void testSelect_sparse();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(RarestPieceSelectorTest);
@@ -47,4 +49,42 @@ void RarestPieceSelectorTest::testSelect()
   CPPUNIT_ASSERT_EQUAL((size_t)2, index);
 }
 
+void RarestPieceSelectorTest::testSelect_sparse()
+{
+  auto pieceStatMan = std::make_shared<PieceStatMan>(1000, false);
+  RarestPieceSelector selector(pieceStatMan);
+  // Pieces [0, 500) have no peer.  Pieces [500, 1000) have 2 peers,
+  // except that piece 990 has 1 peer.
+  for (size_t i = 500; i < 1000; ++i) {
+    pieceStatMan->addPieceStats(i);
+    if (i != 990) {
+      pieceStatMan->addPieceStats(i);
+    }
+  }
+  BitfieldMan bf(1_k, 1000_k);
+  size_t index;
+  CPPUNIT_ASSERT(!selector.select(index, bf.getBitfield(), bf.countBlock()));
+
+  // None of the rarest pieces is in the bitfield.
+  bf.setBit(600);
+  bf.setBit(760);
+  bf.setBit(990);
+  CPPUNIT_ASSERT(selector.select(index, bf.getBitfield(), bf.countBlock()));
+  CPPUNIT_ASSERT_EQUAL((size_t)990, index);
+
+  // Piece 600 joins the lowest non-empty bucket.
+  BitfieldMan lost(1_k, 1000_k);
+  lost.setBit(600);
+  pieceStatMan->subtractPieceStats(lost.getBitfield(),
+                                   lost.getBitfieldLength());
+  CPPUNIT_ASSERT_EQUAL(1, pieceStatMan->getCount(600));
+  CPPUNIT_ASSERT(selector.select(index, bf.getBitfield(), bf.countBlock()));
+  CPPUNIT_ASSERT(index == 600 || index == 990);
+  // Piece 990 becomes more common.
+  pieceStatMan->addPieceStats(990);
+  pieceStatMan->addPieceStats(990);
+  CPPUNIT_ASSERT(selector.select(index, bf.getBitfield(), bf.countBlock()));
+  CPPUNIT_ASSERT_EQUAL((size_t)600, index);
+}
+
 } // namespace aria2
@@ -110,10 +110,9 @@ void RequestGroupTest::testCreateDownloadResult()
   {
     std::shared_ptr<DownloadResult> result = group.createDownloadResult();
 
-    CPPUNIT_ASSERT_EQUAL(std::string("/tmp/myfile"),
-                         result->fileEntries[0]->getPath());
-    CPPUNIT_ASSERT_EQUAL((int64_t)1_m,
-                         result->fileEntries.back()->getLastOffset());
+    auto fileEntries = result->getFileEntries();
+    CPPUNIT_ASSERT_EQUAL(std::string("/tmp/myfile"), fileEntries[0]->getPath());
+    CPPUNIT_ASSERT_EQUAL((int64_t)1_m, fileEntries.back()->getLastOffset());
     CPPUNIT_ASSERT_EQUAL((uint64_t)0, result->sessionDownloadLength);
     CPPUNIT_ASSERT_EQUAL((int64_t)0, result->sessionTime.count());
     // result is UNKNOWN_ERROR if download has not completed and no specific
@@ -922,13 +922,11 @@ void RpcMethodTest::testGetVersion()
 
 void RpcMethodTest::testGatherStoppedDownload()
 {
-  std::vector<std::shared_ptr<FileEntry>> fileEntries;
   std::vector<a2_gid_t> followedBy;
   followedBy.push_back(3);
   followedBy.push_back(4);
   auto d = std::make_shared<DownloadResult>();
   d->gid = GroupId::create();
-  d->fileEntries = fileEntries;
   d->inMemoryDownload = false;
   d->sessionDownloadLength = UINT64_MAX;
   d->sessionTime = 1_s;
@@ -1026,6 +1024,9 @@ void RpcMethodTest::testGatherProgressCommon()
           ->s());
   CPPUNIT_ASSERT_EQUAL(e_->getOption()->get(PREF_DIR),
                        downcast<String>(entry->get("dir"))->s());
+  CPPUNIT_ASSERT_EQUAL(
+      util::uitos(dctx->getFirstFileEntry()->estimateMemoryUsage()),
+      downcast<String>(entry->get("fileMemory"))->s());
 
   keys.push_back("gid");
   entry = Dict::g();
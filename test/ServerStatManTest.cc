@@ -16,6 +16,7 @@ class ServerStatManTest : public CppUnit::TestFixture {
 
   CPPUNIT_TEST_SUITE(ServerStatManTest);
   CPPUNIT_TEST(testAddAndFind);
+  CPPUNIT_TEST(testFind_uri);
   CPPUNIT_TEST(testSave);
   CPPUNIT_TEST(testLoad);
   CPPUNIT_TEST(testRemoveStaleServerStat);
@@ -27,6 +28,7 @@ public:
   void tearDown() {}
 
   void testAddAndFind();
+  void testFind_uri();
   void testSave();
   void testLoad();
   void testRemoveStaleServerStat();
@@ -59,6 +61,37 @@ void ServerStatManTest::testAddAndFind()
   }
 }
 
+void ServerStatManTest::testFind_uri()
+{
+  ServerStatMan ssm;
+  CPPUNIT_ASSERT(ssm.add(std::make_shared<ServerStat>("localhost", "http")));
+  CPPUNIT_ASSERT(ssm.add(std::make_shared<ServerStat>("localhost", "ftp")));
+  CPPUNIT_ASSERT(ssm.add(std::make_shared<ServerStat>("local", "https")));
+  CPPUNIT_ASSERT(ssm.add(std::make_shared<ServerStat>("::1", "http")));
+
+  uri_split_result us;
+  const char uri1[] = "ftp://localhost/aria2.tar.bz2";
+  CPPUNIT_ASSERT_EQUAL(0, uri_split(&us, uri1));
+  auto r = ssm.find(uri1, us);
+  CPPUNIT_ASSERT(r);
+  CPPUNIT_ASSERT_EQUAL(std::string("localhost"), r->getHostname());
+  CPPUNIT_ASSERT_EQUAL(std::string("ftp"), r->getProtocol());
+
+  const char uri2[] = "https://localhost:8443/";
+  CPPUNIT_ASSERT_EQUAL(0, uri_split(&us, uri2));
+  CPPUNIT_ASSERT(!ssm.find(uri2, us));
+
+  const char uri3[] = "http://[::1]/";
+  CPPUNIT_ASSERT_EQUAL(0, uri_split(&us, uri3));
+  r = ssm.find(uri3, us);
+  CPPUNIT_ASSERT(r);
+  CPPUNIT_ASSERT_EQUAL(std::string("::1"), r->getHostname());
+
+  const char uri4[] = "https://local.example.org/";
+  CPPUNIT_ASSERT_EQUAL(0, uri_split(&us, uri4));
+  CPPUNIT_ASSERT(!ssm.find(uri4, us));
+}
+
 void ServerStatManTest::testSave()
 {
   std::shared_ptr<ServerStat> localhost_http(
@@ -54,21 +54,23 @@ void SessionSerializerTest::testSave()
       createDownloadResult(error_code::TIME_OUT, "http://error"),
       createDownloadResult(error_code::FINISHED, "http://finished"),
       createDownloadResult(error_code::FINISHED, "http://force-save")};
+  auto fileEntries = drs[1]->getFileEntries();
   // This URI will be discarded because same URI exists in remaining
   // URIs.
-  drs[1]->fileEntries[0]->getRemainingUris().push_back("http://error");
-  drs[1]->fileEntries[0]->getRemainingUris().push_back("http://error3");
+  fileEntries[0]->getRemainingUris().push_back("http://error");
+  fileEntries[0]->getRemainingUris().push_back("http://error3");
   // This URI will be discarded because same URI exists in remaining
   // URIs.
-  drs[1]->fileEntries[0]->getRemainingUris().push_back("http://error");
+  fileEntries[0]->getRemainingUris().push_back("http://error");
   //
   // This URI will be discarded because same URI exists in remaining
   // URIs.
-  drs[1]->fileEntries[0]->getSpentUris().push_back("http://error");
-  drs[1]->fileEntries[0]->getSpentUris().push_back("http://error2");
+  fileEntries[0]->getSpentUris().push_back("http://error");
+  fileEntries[0]->getSpentUris().push_back("http://error2");
   // This URI will be discarded because same URI exists in remaining
   // URIs.
-  drs[1]->fileEntries[0]->getSpentUris().push_back("http://error");
+  fileEntries[0]->getSpentUris().push_back("http://error");
+  drs[1]->setFileEntries(fileEntries);
 
   drs[3]->option->put(PREF_FORCE_SAVE, A2_V_TRUE);
   for (size_t i = 0; i < sizeof(drs) / sizeof(drs[0]); ++i) {
@@ -138,8 +140,9 @@ void SessionSerializerTest::testSaveErrorDownload()
 {
   std::shared_ptr<DownloadResult> dr =
       createDownloadResult(error_code::TIME_OUT, "http://error");
-  dr->fileEntries[0]->getSpentUris().swap(
-      dr->fileEntries[0]->getRemainingUris());
+  auto fileEntries = dr->getFileEntries();
+  fileEntries[0]->getSpentUris().swap(fileEntries[0]->getRemainingUris());
+  dr->setFileEntries(fileEntries);
   std::shared_ptr<Option> option(new Option());
   option->put(PREF_MAX_DOWNLOAD_RESULT, "10");
   RequestGroupMan rgman{std::vector<std::shared_ptr<RequestGroup>>(), 1,
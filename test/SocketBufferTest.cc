@@ -0,0 +1,122 @@
+#include "SocketBuffer.h"
+
+#include <cstring>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "SocketCore.h"
+#include "a2functional.h"
+
+namespace aria2 {
+
+class SocketBufferTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(SocketBufferTest);
+  CPPUNIT_TEST(testPushBytes_coalesce);
+  CPPUNIT_TEST(testPushBytes_progressUpdate);
+  CPPUNIT_TEST_SUITE_END();
+
+  std::shared_ptr<SocketCore> writeSock_;
+  std::shared_ptr<SocketCore> readSock_;
+
+public:
+  void setUp()
+  {
+    writeSock_ = std::make_shared<SocketCore>();
+    SocketCore serverSock;
+    serverSock.bind(0);
+    serverSock.beginListen();
+    serverSock.setBlockingMode();
+    auto endpoint = serverSock.getAddrInfo();
+    writeSock_->establishConnection("localhost", endpoint.port);
+    writeSock_->setBlockingMode();
+    readSock_ = serverSock.acceptConnection();
+    readSock_->setBlockingMode();
+  }
+
+  std::string readAll(size_t len)
+  {
+    std::string res;
+    char buf[4096];
+    while (res.size() < len) {
+      size_t n = std::min(sizeof(buf), len - res.size());
+      readSock_->readData(buf, n);
+      res.append(buf, n);
+    }
+    return res;
+  }
+
+  void testPushBytes_coalesce();
+  void testPushBytes_progressUpdate();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SocketBufferTest);
+
+namespace {
+std::vector<unsigned char> toBytes(const std::string& s)
+{
+  return std::vector<unsigned char>(std::begin(s), std::end(s));
+}
+} // namespace
+
+void SocketBufferTest::testPushBytes_coalesce()
+{
+  SocketBuffer sb(writeSock_);
+  sb.pushBytes(toBytes("alpha"));
+  sb.pushBytes(toBytes("bravo"));
+  sb.pushBytes(toBytes("charlie"));
+  CPPUNIT_ASSERT_EQUAL((size_t)1, sb.getBufferEntrySize());
+  // Large data gets its own entry.
+  sb.pushBytes(std::vector<unsigned char>(2_k, 'x'));
+  CPPUNIT_ASSERT_EQUAL((size_t)2, sb.getBufferEntrySize());
+  sb.pushBytes(toBytes("delta"));
+  CPPUNIT_ASSERT_EQUAL((size_t)2, sb.getBufferEntrySize());
+  sb.pushStr("echo");
+  sb.pushBytes(toBytes("foxtrot"));
+  CPPUNIT_ASSERT_EQUAL((size_t)4, sb.getBufferEntrySize());
+
+  CPPUNIT_ASSERT_EQUAL((ssize_t)(17 + 2_k + 16), sb.send());
+  CPPUNIT_ASSERT(sb.sendBufferIsEmpty());
+  CPPUNIT_ASSERT_EQUAL("alphabravocharlie" + std::string(2_k, 'x') +
+                           "deltaechofoxtrot",
+                       readAll(17 + 2_k + 16));
+}
+
+namespace {
+struct CountProgressUpdate : public ProgressUpdate {
+  CountProgressUpdate(size_t& length, int& completed)
+      : length(length), completed(completed)
+  {
+  }
+  virtual void update(size_t len, bool complete) CXX11_OVERRIDE
+  {
+    length += len;
+    if (complete) {
+      ++completed;
+    }
+  }
+  size_t& length;
+  int& completed;
+};
+} // namespace
+
+void SocketBufferTest::testPushBytes_progressUpdate()
+{
+  SocketBuffer sb(writeSock_);
+  size_t length = 0;
+  int completed = 0;
+  sb.pushBytes(toBytes("alpha"));
+  // Data with ProgressUpdate is not coalesced, so that it is notified
+  // for its own bytes only.
+  sb.pushBytes(toBytes("bravo"),
+               make_unique<CountProgressUpdate>(length, completed));
+  sb.pushBytes(toBytes("charlie"));
+  CPPUNIT_ASSERT_EQUAL((size_t)3, sb.getBufferEntrySize());
+
+  CPPUNIT_ASSERT_EQUAL((ssize_t)17, sb.send());
+  CPPUNIT_ASSERT_EQUAL((size_t)5, length);
+  CPPUNIT_ASSERT_EQUAL(1, completed);
+  CPPUNIT_ASSERT_EQUAL(std::string("alphabravocharlie"), readAll(17));
+}
+
+} // namespace aria2
@@ -6,6 +6,10 @@
 
 #include "a2functional.h"
 #include "Exception.h"
+#ifdef ENABLE_SSL
+#include "TLSContext.h"
+#include "TLSSessionCache.h"
+#endif // ENABLE_SSL
 
 namespace aria2 {
 
@@ -14,6 +18,14 @@ class SocketCoreTest : public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(SocketCoreTest);
   CPPUNIT_TEST(testWriteAndReadDatagram);
   CPPUNIT_TEST(testGetSocketError);
+  CPPUNIT_TEST(testAcceptPendingConnection);
+#ifdef ENABLE_SSL
+  CPPUNIT_TEST(testTlsConnect_sessionKey);
+  CPPUNIT_TEST(testSetClientTLSContext);
+#if defined(HAVE_LIBGNUTLS) || defined(HAVE_OPENSSL)
+  CPPUNIT_TEST(testTlsConnect_resumeSession);
+#endif // defined(HAVE_LIBGNUTLS) || defined(HAVE_OPENSSL)
+#endif // ENABLE_SSL
   CPPUNIT_TEST(testInetNtop);
   CPPUNIT_TEST(testInetPton);
   CPPUNIT_TEST(testGetBinAddr);
@@ -27,6 +39,12 @@ public:
 
   void testWriteAndReadDatagram();
   void testGetSocketError();
+  void testAcceptPendingConnection();
+#ifdef ENABLE_SSL
+  void testTlsConnect_sessionKey();
+  void testSetClientTLSContext();
+  void testTlsConnect_resumeSession();
+#endif // ENABLE_SSL
   void testInetNtop();
   void testInetPton();
   void testGetBinAddr();
@@ -86,6 +104,137 @@ void SocketCoreTest::testGetSocketError()
   CPPUNIT_ASSERT_EQUAL(std::string(""), s.getSocketError());
 }
 
+void SocketCoreTest::testAcceptPendingConnection()
+{
+  SocketCore s;
+  s.bind("127.0.0.1", 0, AF_INET);
+  s.beginListen();
+  Endpoint endpoint;
+  CPPUNIT_ASSERT(!s.acceptPendingConnection(endpoint));
+
+  SocketCore c;
+  c.establishConnection("127.0.0.1", s.getAddrInfo().port);
+  std::shared_ptr<SocketCore> peer;
+  for (int i = 0; i < 100 && !peer; ++i) {
+    s.isReadable(10);
+    peer = s.acceptPendingConnection(endpoint);
+  }
+  CPPUNIT_ASSERT(peer);
+  CPPUNIT_ASSERT_EQUAL(std::string("127.0.0.1"), endpoint.addr);
+  CPPUNIT_ASSERT_EQUAL(c.getAddrInfo().port, endpoint.port);
+  CPPUNIT_ASSERT(!s.acceptPendingConnection(endpoint));
+}
+
+#ifdef ENABLE_SSL
+void SocketCoreTest::testTlsConnect_sessionKey()
+{
+  SocketCore::setClientTLSContext(std::shared_ptr<TLSContext>(
+      TLSContext::make(TLS_CLIENT, TLS_PROTO_TLS12)));
+  // s stands for HTTP proxy which tunnels the connection to
+  // example.org:443.
+  SocketCore s;
+  s.bind("127.0.0.1", 0, AF_INET);
+  s.beginListen();
+  SocketCore c;
+  c.establishConnection("127.0.0.1", s.getAddrInfo().port);
+  Endpoint endpoint;
+  std::shared_ptr<SocketCore> peer;
+  for (int i = 0; i < 100 && !peer; ++i) {
+    s.isReadable(10);
+    peer = s.acceptPendingConnection(endpoint);
+  }
+  CPPUNIT_ASSERT(peer);
+  // Handshake does not finish because peer does not respond.
+  CPPUNIT_ASSERT(!c.tlsConnect("example.org", 443));
+  CPPUNIT_ASSERT_EQUAL(std::string("example.org:443"), c.getTLSSessionKey());
+  // Close while peer is still open to avoid SIGPIPE.
+  c.closeConnection();
+  SocketCore::setClientTLSContext(nullptr);
+}
+
+void SocketCoreTest::testSetClientTLSContext()
+{
+  auto& cache = SocketCore::getClientTLSSessionCache();
+  cache.put("example.org:443", "alpha");
+  CPPUNIT_ASSERT_EQUAL((size_t)1, cache.size());
+  SocketCore::setClientTLSContext(std::shared_ptr<TLSContext>(
+      TLSContext::make(TLS_CLIENT, TLS_PROTO_TLS12)));
+  CPPUNIT_ASSERT_EQUAL((size_t)0, cache.size());
+  SocketCore::setClientTLSContext(nullptr);
+}
+
+namespace {
+// Performs TLS handshake between client c, which connects to
+// host:port, and server side socket peer.
+void tlsHandshake(SocketCore& c, SocketCore& peer, const std::string& host,
+                  uint16_t port)
+{
+  c.setNonBlockingMode();
+  peer.setNonBlockingMode();
+  bool clientDone = false, serverDone = false;
+  for (int i = 0; i < 1000 && !(clientDone && serverDone); ++i) {
+    if (!clientDone) {
+      clientDone = c.tlsConnect(host, port);
+    }
+    if (!serverDone) {
+      serverDone = peer.tlsAccept();
+    }
+  }
+  CPPUNIT_ASSERT(clientDone);
+  CPPUNIT_ASSERT(serverDone);
+}
+} // namespace
+
+void SocketCoreTest::testTlsConnect_resumeSession()
+{
+  std::shared_ptr<TLSContext> svTlsContext(
+      TLSContext::make(TLS_SERVER, TLS_PROTO_TLS12));
+  CPPUNIT_ASSERT(svTlsContext->addCredentialFile(
+      A2_TEST_DIR "/tls-server.crt", A2_TEST_DIR "/tls-server.key"));
+  SocketCore::setServerTLSContext(svTlsContext);
+  std::shared_ptr<TLSContext> clTlsContext(
+      TLSContext::make(TLS_CLIENT, TLS_PROTO_TLS12));
+  clTlsContext->setVerifyPeer(false);
+  SocketCore::setClientTLSContext(clTlsContext);
+  auto& cache = SocketCore::getClientTLSSessionCache();
+
+  SocketCore s;
+  s.bind("127.0.0.1", 0, AF_INET);
+  s.beginListen();
+  for (int round = 0; round < 2; ++round) {
+    SocketCore c;
+    c.establishConnection("127.0.0.1", s.getAddrInfo().port);
+    Endpoint endpoint;
+    std::shared_ptr<SocketCore> peer;
+    for (int i = 0; i < 100 && !peer; ++i) {
+      s.isReadable(10);
+      peer = s.acceptPendingConnection(endpoint);
+    }
+    CPPUNIT_ASSERT(peer);
+    tlsHandshake(c, *peer, "localhost", 443);
+    // Only the second connection to localhost:443 picks up the
+    // session stored by the first one.
+    CPPUNIT_ASSERT_EQUAL(round == 1, c.isTLSSessionResumed());
+    CPPUNIT_ASSERT(!cache.get("localhost:443").empty());
+    // Exchange application data so that session tickets sent after
+    // TLSv1.3 handshake reach the client.
+    peer->writeData("x", 1);
+    char buf[1];
+    size_t len = 0;
+    for (int i = 0; i < 100 && len == 0; ++i) {
+      c.isReadable(10);
+      len = sizeof(buf);
+      c.readData(buf, len);
+    }
+    CPPUNIT_ASSERT_EQUAL((size_t)1, len);
+    c.closeConnection();
+    peer->closeConnection();
+  }
+  SocketCore::setClientTLSContext(nullptr);
+  SocketCore::setServerTLSContext(nullptr);
+}
+#endif // ENABLE_SSL
+
 void SocketCoreTest::testInetNtop()
 {
   char dest[NI_MAXHOST];
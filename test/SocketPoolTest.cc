@@ -0,0 +1,172 @@
+#include "SocketPool.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "SocketCore.h"
+#include "A2STR.h"
+#include "wallclock.h"
+
+namespace aria2 {
+
+class SocketPoolTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(SocketPoolTest);
+  CPPUNIT_TEST(testPushPop);
+  CPPUNIT_TEST(testPop_key);
+  CPPUNIT_TEST(testPop_readable);
+  CPPUNIT_TEST(testPush_maxIdle);
+  CPPUNIT_TEST(testEvict);
+  CPPUNIT_TEST(testKeyToString);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp() { global::wallclock().reset(); }
+
+  void testPushPop();
+  void testPop_key();
+  void testPop_readable();
+  void testPush_maxIdle();
+  void testEvict();
+  void testKeyToString();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SocketPoolTest);
+
+namespace {
+// Returns listening socket, which is not readable unless a client
+// connects to it.
+std::shared_ptr<SocketCore> createSocket()
+{
+  auto s = std::make_shared<SocketCore>();
+  s->bind(0);
+  s->beginListen();
+  return s;
+}
+
+SocketPool::Key createKey(const std::string& host)
+{
+  return SocketPool::Key(host, 80, A2STR::NIL, A2STR::NIL, 0);
+}
+} // namespace
+
+void SocketPoolTest::testPushPop()
+{
+  SocketPool pool(8);
+  auto s1 = createSocket();
+  auto s2 = createSocket();
+  pool.push(createKey("192.168.0.1"), s1, "opt1", 15_s);
+  pool.push(createKey("192.168.0.1"), s2, "opt2", 15_s);
+  CPPUNIT_ASSERT_EQUAL((size_t)2, pool.size());
+
+  std::string options;
+  // Most recently pooled socket comes first.
+  CPPUNIT_ASSERT(s2 == pool.pop(options, createKey("192.168.0.1")));
+  CPPUNIT_ASSERT_EQUAL(std::string("opt2"), options);
+  CPPUNIT_ASSERT(s1 == pool.pop(options, createKey("192.168.0.1")));
+  CPPUNIT_ASSERT_EQUAL(std::string("opt1"), options);
+  CPPUNIT_ASSERT(!pool.pop(options, createKey("192.168.0.1")));
+  CPPUNIT_ASSERT(pool.empty());
+  CPPUNIT_ASSERT_EQUAL((uint64_t)2, pool.getNumHits());
+  CPPUNIT_ASSERT_EQUAL((uint64_t)1, pool.getNumMisses());
+  CPPUNIT_ASSERT_EQUAL((uint64_t)0, pool.getNumDropped());
+}
+
+void SocketPoolTest::testPop_key()
+{
+  SocketPool pool(8);
+  auto s = createSocket();
+  pool.push(SocketPool::Key("example.org", 80, "alice", "proxy", 8080), s,
+            A2STR::NIL, 15_s);
+  std::string options;
+  CPPUNIT_ASSERT(!pool.pop(options, SocketPool::Key("example.org", 80, "bob",
+                                                     "proxy", 8080)));
+  CPPUNIT_ASSERT(!pool.pop(options, SocketPool::Key("example.org", 80,
+                                                     "alice", "proxy", 3128)));
+  CPPUNIT_ASSERT(!pool.pop(options, SocketPool::Key("example.org", 443,
+                                                     "alice", "proxy", 8080)));
+  CPPUNIT_ASSERT(!pool.pop(options, SocketPool::Key("example.org", 80,
+                                                     "alice", A2STR::NIL, 0)));
+  CPPUNIT_ASSERT(s == pool.pop(options, SocketPool::Key("example.org", 80,
+                                                         "alice", "proxy",
+                                                         8080)));
+  CPPUNIT_ASSERT_EQUAL((uint64_t)4, pool.getNumMisses());
+}
+
+void SocketPoolTest::testPop_readable()
+{
+  SocketPool pool(8);
+  auto s1 = createSocket();
+  auto s2 = createSocket();
+  pool.push(createKey("localhost"), s1, A2STR::NIL, 15_s);
+  pool.push(createKey("localhost"), s2, A2STR::NIL, 15_s);
+
+  // Pending connection makes s2 readable.
+  auto endpoint = s2->getAddrInfo();
+  SocketCore client;
+  client.establishConnection("localhost", endpoint.port);
+  CPPUNIT_ASSERT(s2->isReadable(1));
+
+  std::string options;
+  CPPUNIT_ASSERT(s1 == pool.pop(options, createKey("localhost")));
+  CPPUNIT_ASSERT(pool.empty());
+  CPPUNIT_ASSERT_EQUAL((uint64_t)1, pool.getNumDropped());
+}
+
+void SocketPoolTest::testPush_maxIdle()
+{
+  SocketPool pool(2);
+  auto s1 = createSocket();
+  auto s2 = createSocket();
+  auto s3 = createSocket();
+  auto s4 = createSocket();
+  pool.push(createKey("192.168.0.1"), s1, A2STR::NIL, 15_s);
+  pool.push(createKey("192.168.0.1"), s2, A2STR::NIL, 15_s);
+  pool.push(createKey("192.168.0.1"), s3, A2STR::NIL, 15_s);
+  pool.push(createKey("192.168.0.2"), s4, A2STR::NIL, 15_s);
+  CPPUNIT_ASSERT_EQUAL((size_t)3, pool.size());
+  CPPUNIT_ASSERT_EQUAL((uint64_t)1, pool.getNumDropped());
+
+  std::string options;
+  CPPUNIT_ASSERT(s3 == pool.pop(options, createKey("192.168.0.1")));
+  CPPUNIT_ASSERT(s2 == pool.pop(options, createKey("192.168.0.1")));
+  CPPUNIT_ASSERT(!pool.pop(options, createKey("192.168.0.1")));
+  CPPUNIT_ASSERT(s4 == pool.pop(options, createKey("192.168.0.2")));
+}
+
+void SocketPoolTest::testEvict()
+{
+  SocketPool pool(8);
+  auto s1 = createSocket();
+  auto s2 = createSocket();
+  auto s3 = createSocket();
+  pool.push(createKey("192.168.0.1"), s1, A2STR::NIL, 10_s);
+  pool.push(createKey("192.168.0.1"), s2, A2STR::NIL, 30_s);
+  pool.push(createKey("192.168.0.2"), s3, A2STR::NIL, 10_s);
+
+  global::wallclock().advance(10_s);
+  pool.evict();
+  CPPUNIT_ASSERT_EQUAL((size_t)1, pool.size());
+  CPPUNIT_ASSERT_EQUAL((uint64_t)2, pool.getNumDropped());
+
+  std::string options;
+  CPPUNIT_ASSERT(!pool.pop(options, createKey("192.168.0.2")));
+  CPPUNIT_ASSERT(s2 == pool.pop(options, createKey("192.168.0.1")));
+
+  // Expired entry is not returned even before evict() is called.
+  pool.push(createKey("192.168.0.1"), s1, A2STR::NIL, 10_s);
+  global::wallclock().advance(10_s);
+  CPPUNIT_ASSERT(!pool.pop(options, createKey("192.168.0.1")));
+  CPPUNIT_ASSERT(pool.empty());
+}
+
+void SocketPoolTest::testKeyToString()
+{
+  CPPUNIT_ASSERT_EQUAL(std::string("192.168.0.1(80)"),
+                       createKey("192.168.0.1").toString());
+  CPPUNIT_ASSERT_EQUAL(
+      std::string("alice%40example@example.org(21)/proxy(8080)"),
+      SocketPool::Key("example.org", 21, "alice@example", "proxy", 8080)
+          .toString());
+}
+
+} // namespace aria2
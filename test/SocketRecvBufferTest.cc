@@ -0,0 +1,84 @@
+#include "SocketRecvBuffer.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "SocketCore.h"
+#include "a2functional.h"
+
+namespace aria2 {
+
+class SocketRecvBufferTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(SocketRecvBufferTest);
+  CPPUNIT_TEST(testRecv);
+  CPPUNIT_TEST(testRecv_direct);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  std::shared_ptr<SocketCore> client_;
+  std::shared_ptr<SocketCore> inbound_;
+
+public:
+  void setUp()
+  {
+    SocketCore server;
+    server.bind(0);
+    server.beginListen();
+    server.setBlockingMode();
+    auto endpoint = server.getAddrInfo();
+
+    client_ = std::make_shared<SocketCore>();
+    client_->establishConnection("localhost", endpoint.port);
+    while (!client_->isWritable(0)) {
+    }
+    client_->setBlockingMode();
+
+    inbound_ = server.acceptConnection();
+    inbound_->setBlockingMode();
+  }
+
+  void testRecv();
+  void testRecv_direct();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SocketRecvBufferTest);
+
+void SocketRecvBufferTest::testRecv()
+{
+  SocketRecvBuffer buf(client_);
+  CPPUNIT_ASSERT_EQUAL(SocketRecvBuffer::MIN_CAPACITY, buf.getCapacity());
+
+  // Filling the whole buffer doubles the capacity.
+  inbound_->writeData(std::string(16_k, 'a'));
+  CPPUNIT_ASSERT_EQUAL((ssize_t)16_k, buf.recv());
+  CPPUNIT_ASSERT_EQUAL((size_t)32_k, buf.getCapacity());
+  CPPUNIT_ASSERT_EQUAL((size_t)16_k, buf.getBufferLength());
+  CPPUNIT_ASSERT_EQUAL('a', static_cast<char>(buf.getBuffer()[0]));
+  buf.drain(16_k);
+
+  // The buffer is resized to the new capacity when it is empty.
+  inbound_->writeData(std::string(32_k, 'b'));
+  CPPUNIT_ASSERT_EQUAL((ssize_t)32_k, buf.recv());
+  CPPUNIT_ASSERT_EQUAL((size_t)64_k, buf.getCapacity());
+  buf.drain(32_k);
+  CPPUNIT_ASSERT(buf.bufferEmpty());
+}
+
+void SocketRecvBufferTest::testRecv_direct()
+{
+  SocketRecvBuffer buf(client_);
+  inbound_->writeData(std::string(16_k, 'a'));
+  unsigned char data[16_k];
+  CPPUNIT_ASSERT_EQUAL((ssize_t)16_k, buf.recv(data, sizeof(data)));
+  CPPUNIT_ASSERT_EQUAL((size_t)32_k, buf.getCapacity());
+  CPPUNIT_ASSERT(buf.bufferEmpty());
+
+  // Consecutive small reads shrink the capacity.
+  inbound_->writeData(std::string(32, 'b'));
+  for (int i = 0; i < 32; ++i) {
+    CPPUNIT_ASSERT_EQUAL((ssize_t)1, buf.recv(data, 1));
+  }
+  CPPUNIT_ASSERT_EQUAL((size_t)16_k, buf.getCapacity());
+}
+
+} // namespace aria2
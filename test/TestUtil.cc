@@ -141,7 +141,7 @@ std::shared_ptr<DownloadResult> createDownloadResult(error_code::Value result,
   entries.push_back(entry);
   std::shared_ptr<DownloadResult> dr(new DownloadResult());
   dr->gid = GroupId::create();
-  dr->fileEntries = entries;
+  dr->setFileEntries(entries);
   dr->result = result;
   dr->belongsTo = 0;
   dr->inMemoryDownload = false;
@@ -0,0 +1,122 @@
+#include "UploadSlotTuner.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace aria2 {
+
+class UploadSlotTunerTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(UploadSlotTunerTest);
+  CPPUNIT_TEST(testUpdate_grow);
+  CPPUNIT_TEST(testUpdate_shrink);
+  CPPUNIT_TEST(testUpdate_saturated);
+  CPPUNIT_TEST(testUpdate_steady);
+  CPPUNIT_TEST(testUpdate_idle);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void testUpdate_grow();
+  void testUpdate_shrink();
+  void testUpdate_saturated();
+  void testUpdate_steady();
+  void testUpdate_idle();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(UploadSlotTunerTest);
+
+void UploadSlotTunerTest::testUpdate_grow()
+{
+  UploadSlotTuner tuner(80);
+  CPPUNIT_ASSERT_EQUAL(3, tuner.getNumSlots());
+  // The first sample only sets the capacity.
+  tuner.update(1000, 100);
+  CPPUNIT_ASSERT_EQUAL(1000, tuner.getCapacity());
+  CPPUNIT_ASSERT_EQUAL(3, tuner.getNumSlots());
+  // Below the target
+  tuner.update(500, 100);
+  CPPUNIT_ASSERT_EQUAL(1000, tuner.getCapacity());
+  CPPUNIT_ASSERT_EQUAL(4, tuner.getNumSlots());
+  tuner.update(500, 100);
+  CPPUNIT_ASSERT_EQUAL(5, tuner.getNumSlots());
+  // No more slots than candidates.
+  tuner.update(500, 5);
+  CPPUNIT_ASSERT_EQUAL(5, tuner.getNumSlots());
+  // Grows by 25% at a time.
+  for (int i = 0; i < 3; ++i) {
+    tuner.update(100, 100);
+  }
+  CPPUNIT_ASSERT_EQUAL(8, tuner.getNumSlots());
+}
+
+void UploadSlotTunerTest::testUpdate_shrink()
+{
+  UploadSlotTuner tuner(80);
+  tuner.update(1000, 100);
+  for (int i = 0; i < 3; ++i) {
+    tuner.update(500, 100);
+  }
+  CPPUNIT_ASSERT_EQUAL(6, tuner.getNumSlots());
+  // Within the target band
+  tuner.update(850, 100);
+  CPPUNIT_ASSERT_EQUAL(6, tuner.getNumSlots());
+  // Fewer peers saturate the link.
+  tuner.update(950, 100);
+  CPPUNIT_ASSERT_EQUAL(5, tuner.getNumSlots());
+  // New peak
+  tuner.update(2000, 100);
+  CPPUNIT_ASSERT_EQUAL(2000, tuner.getCapacity());
+  CPPUNIT_ASSERT_EQUAL(4, tuner.getNumSlots());
+  for (int i = 0; i < 5; ++i) {
+    tuner.update(1900, 100);
+  }
+  CPPUNIT_ASSERT_EQUAL(2000, tuner.getCapacity());
+  CPPUNIT_ASSERT_EQUAL(1, tuner.getNumSlots());
+}
+
+void UploadSlotTunerTest::testUpdate_saturated()
+{
+  // Upload speed never exceeds the capacity, so the shrink threshold
+  // must be below 100% even if the target plus the margin is not.
+  UploadSlotTuner tuner(90);
+  tuner.setMaxUploadSpeed(1000);
+  tuner.update(1000, 100);
+  CPPUNIT_ASSERT_EQUAL(1000, tuner.getCapacity());
+  CPPUNIT_ASSERT_EQUAL(2, tuner.getNumSlots());
+  // Slightly above the limit
+  tuner.update(1010, 100);
+  CPPUNIT_ASSERT_EQUAL(1, tuner.getNumSlots());
+}
+
+void UploadSlotTunerTest::testUpdate_steady()
+{
+  // A steady upload speed below the configured capacity keeps adding
+  // slots, however long it lasts.
+  UploadSlotTuner tuner(80);
+  tuner.setMaxUploadSpeed(1000);
+  for (int i = 0; i < 100; ++i) {
+    tuner.update(500, 10);
+  }
+  CPPUNIT_ASSERT_EQUAL(1000, tuner.getCapacity());
+  CPPUNIT_ASSERT_EQUAL(10, tuner.getNumSlots());
+
+  // Without the limit, the observed peak does not decay toward the
+  // steady upload speed.
+  UploadSlotTuner unlimited(80);
+  unlimited.update(1000, 100);
+  for (int i = 0; i < 100; ++i) {
+    unlimited.update(500, 100);
+    CPPUNIT_ASSERT(unlimited.getNumSlots() >= 3);
+  }
+  CPPUNIT_ASSERT_EQUAL(1000, unlimited.getCapacity());
+  CPPUNIT_ASSERT_EQUAL(100, unlimited.getNumSlots());
+}
+
+void UploadSlotTunerTest::testUpdate_idle()
+{
+  UploadSlotTuner tuner(80);
+  tuner.update(0, 100);
+  CPPUNIT_ASSERT_EQUAL(0, tuner.getCapacity());
+  CPPUNIT_ASSERT_EQUAL(3, tuner.getNumSlots());
+}
+
+} // namespace aria2
@@ -11,6 +11,8 @@
 #include "util.h"
 #include "prefs.h"
 #include "OptionHandler.h"
+#include "BufferedFile.h"
+#include "TestUtil.h"
 
 namespace aria2 {
 
@@ -18,6 +20,7 @@ class UriListParserTest : public CppUnit::TestFixture {
 
   CPPUNIT_TEST_SUITE(UriListParserTest);
   CPPUNIT_TEST(testHasNext);
+  CPPUNIT_TEST(testWriteUnparsed);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -27,6 +30,7 @@ public:
   void setUp() {}
 
   void testHasNext();
+  void testWriteUnparsed();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(UriListParserTest);
@@ -77,4 +81,44 @@ void UriListParserTest::testHasNext()
   CPPUNIT_ASSERT(!flp.hasNext());
 }
 
+void UriListParserTest::testWriteUnparsed()
+{
+  std::string filename = A2_TEST_DIR "/filelist1.txt";
+  std::string outfile =
+      A2_TEST_OUT_DIR "/aria2_UriListParserTest_testWriteUnparsed";
+
+  UriListParser flp(filename);
+
+  std::vector<std::string> uris;
+  Option reqOp;
+  flp.parseNext(uris, reqOp);
+
+  {
+    BufferedFile fp(outfile.c_str(), IOFile::WRITE);
+    CPPUNIT_ASSERT(flp.writeUnparsed(fp));
+  }
+  CPPUNIT_ASSERT_EQUAL(std::string("ftp://localhost/aria2.tar.bz2\n"
+                                   "  dir=/tmp\n"
+                                   "# comment line\n"
+                                   "\t out=chunky_chocolate\n"),
+                       readFile(outfile));
+
+  // The rest of entries are still available.
+  uris.clear();
+  reqOp.clear();
+  CPPUNIT_ASSERT(flp.hasNext());
+  flp.parseNext(uris, reqOp);
+  CPPUNIT_ASSERT_EQUAL(std::string("ftp://localhost/aria2.tar.bz2"),
+                       list2String(uris));
+  CPPUNIT_ASSERT_EQUAL(std::string("/tmp"), reqOp.get(PREF_DIR));
+  CPPUNIT_ASSERT_EQUAL(std::string("chunky_chocolate"), reqOp.get(PREF_OUT));
+  CPPUNIT_ASSERT(!flp.hasNext());
+
+  {
+    BufferedFile fp(outfile.c_str(), IOFile::WRITE);
+    CPPUNIT_ASSERT(flp.writeUnparsed(fp));
+  }
+  CPPUNIT_ASSERT_EQUAL(std::string(""), readFile(outfile));
+}
+
 } // namespace aria2
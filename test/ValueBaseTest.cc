@@ -56,6 +56,14 @@ void ValueBaseTest::testString()
   String data(uc, sizeof(uc));
   CPPUNIT_ASSERT_EQUAL(util::toHex(uc, sizeof(uc)),
                        util::toHex(data.uc(), data.s().size()));
+
+  // popValue() moves the buffer out instead of copying it.
+  String pieces(std::string(1024, 'a'));
+  auto buf = pieces.s().data();
+  auto value = pieces.popValue();
+  CPPUNIT_ASSERT(buf == value.data());
+  CPPUNIT_ASSERT_EQUAL((size_t)1024, value.size());
+  CPPUNIT_ASSERT(pieces.s().empty());
 }
 
 void ValueBaseTest::testDowncast()
@@ -15,6 +15,7 @@ class WrDiskCacheEntryTest : public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(WrDiskCacheEntryTest);
   CPPUNIT_TEST(testWriteToDisk);
   CPPUNIT_TEST(testAppend);
+  CPPUNIT_TEST(testGetAppendBuffer);
   CPPUNIT_TEST(testClear);
   CPPUNIT_TEST_SUITE_END();
 
@@ -32,6 +33,7 @@ public:
 
   void testWriteToDisk();
   void testAppend();
+  void testGetAppendBuffer();
   void testClear();
 };
 
@@ -68,6 +70,34 @@ void WrDiskCacheEntryTest::testAppend()
   CPPUNIT_ASSERT_EQUAL((size_t)0, e.append(7, (const unsigned char*)"FOO", 3));
 }
 
+void WrDiskCacheEntryTest::testGetAppendBuffer()
+{
+  WrDiskCacheEntry e(adaptor_);
+  size_t len;
+  CPPUNIT_ASSERT(!e.getAppendBuffer(0, len));
+
+  auto cell = new WrDiskCacheEntry::DataCell{};
+  cell->goff = 0;
+  cell->data = new unsigned char[6];
+  memcpy(cell->data, "foo", 3);
+  cell->offset = 0;
+  cell->len = 3;
+  cell->capacity = 6;
+  e.cacheData(cell);
+
+  CPPUNIT_ASSERT(!e.getAppendBuffer(4, len));
+  auto buf = e.getAppendBuffer(3, len);
+  CPPUNIT_ASSERT(buf);
+  CPPUNIT_ASSERT_EQUAL((size_t)3, len);
+  memcpy(buf, "ba", 2);
+  e.commitAppend(2);
+  CPPUNIT_ASSERT_EQUAL((size_t)5, cell->len);
+  CPPUNIT_ASSERT_EQUAL((size_t)5, e.getSize());
+
+  e.writeToDisk();
+  CPPUNIT_ASSERT_EQUAL(std::string("fooba"), writer_->getString());
+}
+
 void WrDiskCacheEntryTest::testClear()
 {
   WrDiskCacheEntry e(adaptor_);